@@ -1102,11 +1102,13 @@ cleanup:
     return success;
 }
 
+// If targetSizeBytes is not 0, libavif searches for the quality generating the encoded size closest to targetSizeBytes.
 static avifBool avifEncodeImagesFixedQuality(const avifSettings * settings,
                                              avifInput * input,
                                              const avifInputFile * firstFile,
                                              const avifImage * firstImage,
                                              const avifImage * const * gridCells,
+                                             size_t targetSizeBytes,
                                              avifRWData * encoded,
                                              avifEncodedByteSizes * byteSizes)
 {
@@ -1133,6 +1135,7 @@ static avifBool avifEncodeImagesFixedQuality(const avifSettings * settings,
     encoder->repetitionCount = settings->repetitionCount;
     encoder->headerFormat = settings->headerFormat;
     encoder->extraLayerCount = settings->layers - 1;
+    encoder->targetSizeBytes = targetSizeBytes;
     if (!avifEncodeUpdateEncoderSettings(encoder, &firstFile->settings)) {
         goto cleanup;
     }
@@ -1163,16 +1166,24 @@ static avifBool avifEncodeImagesFixedQuality(const avifSettings * settings,
     }
 #endif
 
-    printf("Encoding with codec '%s' speed [%s], color quality [%d (%s)], alpha quality [%d (%s)]%s, %s, %d worker thread(s), please wait...\n",
-           codecName ? codecName : "none",
-           speedStr,
-           encoder->quality,
-           qualityString(encoder->quality),
-           encoder->qualityAlpha,
-           qualityString(encoder->qualityAlpha),
-           gainMapStr,
-           encoder->autoTiling ? "automatic tiling" : manualTilingStr,
-           settings->jobs);
+    if (targetSizeBytes != 0) {
+        printf("Encoding with codec '%s' speed [%s], %s, %d worker thread(s), please wait...\n",
+               codecName ? codecName : "none",
+               speedStr,
+               encoder->autoTiling ? "automatic tiling" : manualTilingStr,
+               settings->jobs);
+    } else {
+        printf("Encoding with codec '%s' speed [%s], color quality [%d (%s)], alpha quality [%d (%s)]%s, %s, %d worker thread(s), please wait...\n",
+               codecName ? codecName : "none",
+               speedStr,
+               encoder->quality,
+               qualityString(encoder->quality),
+               encoder->qualityAlpha,
+               qualityString(encoder->qualityAlpha),
+               gainMapStr,
+               encoder->autoTiling ? "automatic tiling" : manualTilingStr,
+               settings->jobs);
+    }
     if (settings->progressive) {
         // If the color quality is less than 10, the main() function overrides
         // --progressive and sets settings->autoProgressive to false.
@@ -1238,6 +1249,11 @@ static avifBool avifEncodeImagesFixedQuality(const avifSettings * settings,
         fprintf(stderr, "ERROR: Failed to finish encoding: %s\n", avifResultToString(finishResult));
         goto cleanup;
     }
+    if (targetSizeBytes != 0) {
+        printf("Kept the encoded image of size %" AVIF_FMT_ZU " bytes generated with quality %d.\n",
+               encoded->size,
+               encoder->quality);
+    }
     success = AVIF_TRUE;
     byteSizes->colorSizeBytes = encoder->ioStats.colorOBUSize;
     byteSizes->alphaSizeBytes = encoder->ioStats.alphaOBUSize;
@@ -1264,7 +1280,7 @@ static avifBool avifEncodeImages(avifSettings * settings,
                                  avifEncodedByteSizes * byteSizes)
 {
     if (settings->targetSize == -1) {
-        return avifEncodeImagesFixedQuality(settings, input, firstFile, firstImage, gridCells, encoded, byteSizes);
+        return avifEncodeImagesFixedQuality(settings, input, firstFile, firstImage, gridCells, 0, encoded, byteSizes);
     }
 
     avifBool hasGainMap = AVIF_FALSE;
@@ -1281,6 +1297,22 @@ static avifBool avifEncodeImages(avifSettings * settings,
         return AVIF_FALSE;
     }
 
+    const avifBool isStillImage = (settings->layers == 1) && (settings->gridDimsPresent || !avifInputHasRemainingData(input, 1));
+    if (isStillImage && (settings->targetSize > 0) && !settings->qualityIsConstrained && !settings->qualityAlphaIsConstrained &&
+        (!hasGainMap || !settings->qualityGainMapIsConstrained)) {
+        // Let libavif search for the quality, with trial encodes running in parallel on the available worker threads.
+        printf("Searching for the quality generating the encoded image size closest to %d bytes, please wait...\n",
+               settings->targetSize);
+        return avifEncodeImagesFixedQuality(settings,
+                                            input,
+                                            firstFile,
+                                            firstImage,
+                                            gridCells,
+                                            (size_t)settings->targetSize,
+                                            encoded,
+                                            byteSizes);
+    }
+
     printf("Starting a binary search to find the %s%s generating the encoded image size closest to %d bytes, please wait...\n",
            settings->qualityAlphaIsConstrained ? "color quality"
                                                : (settings->qualityIsConstrained ? "alpha quality" : "color and alpha qualities"),
@@ -1308,7 +1340,7 @@ static avifBool avifEncodeImages(avifSettings * settings,
             settings->qualityGainMap = quality;
         }
 
-        if (!avifEncodeImagesFixedQuality(settings, input, firstFile, firstImage, gridCells, encoded, byteSizes)) {
+        if (!avifEncodeImagesFixedQuality(settings, input, firstFile, firstImage, gridCells, 0, encoded, byteSizes)) {
             avifRWDataFree(&closestEncoded);
             return AVIF_FALSE;
         }
@@ -886,12 +886,42 @@ AVIF_API void avifImageStealPlanes(avifImage * dstImage, avifImage * srcImage, a
 // threads actually simultaneously exist on the machine, but half of them are guaranteed to be
 // sleeping.
 //
+// Conversely, when encoding a still image, the grid cells, the alpha plane and the gain map are
+// encoded concurrently by up to maxThreads threads, each of their AV1 encoders being given an equal
+// share of maxThreads. The color and alpha planes of an image sequence are still encoded serially,
+// because whether a keyframe is forced in the alpha plane depends on the encoded color frame.
+//
 // This design ensures that AV1 implementations are given as many threads as possible to ensure a
 // speedy encode or decode, despite the complexities of occasionally needing two AV1 codec instances
 // (due to alpha payloads being separate from color payloads). If your system has a hard ceiling on
 // the number of threads that can ever be in flight at a given time, please account for this
 // accordingly.
 
+// ---------------------------------------------------------------------------
+// avifThreadPool
+//
+// By default, libavif spawns and joins short-lived threads whenever some of its own work is split
+// according to maxThreads (YUV to RGB conversion, grid cells, color and alpha planes etc.). An
+// avifThreadPool is a set of long-lived worker threads that can be attached to avifDecoder,
+// avifEncoder and avifRGBImage instead, so that this work is queued on the pool's workers. A single
+// pool may be shared by any number of decoders, encoders and conversions, used concurrently from
+// any number of threads. Idle workers steal queued work from each other, and a thread waiting for
+// its work to complete helps executing queued work in the meantime.
+//
+// The work is still split according to the maxThreads setting of each structure, while the number
+// of workers bounds the number of threads that are active at once across all users of the pool.
+// Note that the threads internally created by the AV1 codec libraries are not managed by the pool.
+//
+// The pool must outlive any avifDecoder, avifEncoder or avifRGBImage it is attached to.
+
+typedef struct avifThreadPool avifThreadPool;
+
+// Creates a pool of threadCount worker threads. Returns NULL if threadCount < 1 or on failure.
+AVIF_NODISCARD AVIF_API avifThreadPool * avifThreadPoolCreate(int threadCount);
+// Waits for any queued work to complete, then joins the workers and frees the pool.
+AVIF_API void avifThreadPoolDestroy(avifThreadPool * pool);
+AVIF_API int avifThreadPoolGetThreadCount(const avifThreadPool * pool);
+
 // ---------------------------------------------------------------------------
 // Scaling
 
@@ -983,12 +1013,17 @@ typedef struct avifRGBImage
                           // the alpha bits as if they were all 1.
     avifBool alphaPremultiplied; // indicates if RGB value is pre-multiplied by alpha. Default: false
     avifBool isFloat; // indicates if RGBA values are in half float (f16) format. Valid only when depth == 16. Default: false
-    int maxThreads; // Number of threads to be used for the YUV to RGB conversion. Note that this value is ignored for RGB to YUV
-                    // conversion. Setting this to zero has the same effect as setting it to one. Negative values are invalid.
+    int maxThreads; // Number of threads to be used for the YUV to RGB and RGB to YUV conversions. The rows are split into bands
+                    // of an even number of rows, so the result does not depend on this value, except with
+                    // AVIF_CHROMA_DOWNSAMPLING_SHARP_YUV where the chroma samples next to the borders between bands may slightly
+                    // differ. Setting this to zero has the same effect as setting it to one. Negative values are invalid.
                     // Default: 1.
 
     uint8_t * pixels;
     uint32_t rowBytes;
+
+    avifThreadPool * threadPool; // If not NULL, the conversion work split according to maxThreads runs on this pool instead of
+                                 // on newly spawned threads. Not owned by avifRGBImage. Default: NULL.
 } avifRGBImage;
 
 // Sets rgb->width, rgb->height, and rgb->depth to image->width, image->height, and image->depth.
@@ -1004,6 +1039,35 @@ AVIF_API void avifRGBImageFreePixels(avifRGBImage * rgb);
 // The main conversion functions
 AVIF_API avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb);
 AVIF_API avifResult avifImageYUVToRGB(const avifImage * image, avifRGBImage * rgb);
+// Converts the rowCount rows of image starting at startRow into rgb, which only holds these rows:
+// rgb->width must be image->width and rgb->height must be rowCount. The chroma samples outside of
+// the stripe are read where needed, so the result is identical to the same rows converted by
+// avifImageYUVToRGB(). This allows converting a large image in small stripes, for example to feed
+// an output pipeline without allocating the whole RGB image. rgb->maxThreads is ignored.
+// Returns AVIF_RESULT_INVALID_ARGUMENT if the stripe is empty or outside of image, or if rgb does
+// not have the dimensions above.
+AVIF_API avifResult avifImageYUVToRGBRows(const avifImage * image, avifRGBImage * rgb, uint32_t startRow, uint32_t rowCount);
+
+// avifRGBConverter performs the same conversion as avifImageYUVToRGB() but computes the conversion
+// coefficients and look-up tables only once, when created. It is meant for converting many images
+// with the same properties, such as the frames of an image sequence decoded with avifDecoder.
+//
+// The converter is created from a template avifImage and avifRGBImage, whose pixels are not read.
+// Each converted avifImage must have the same depth, yuvFormat, yuvRange, colorPrimaries and
+// matrixCoefficients as the template avifImage, and each avifRGBImage must have the same depth,
+// format and isFloat as the template avifRGBImage. The other fields, including the dimensions, may
+// change from one call to the next.
+//
+// A converter may be used concurrently from several threads.
+typedef struct avifRGBConverter avifRGBConverter;
+
+// Returns NULL if the combination of image and rgb is not supported by avifImageYUVToRGB() or on
+// memory allocation failure.
+AVIF_NODISCARD AVIF_API avifRGBConverter * avifRGBConverterCreate(const avifImage * image, const avifRGBImage * rgb);
+AVIF_API void avifRGBConverterDestroy(avifRGBConverter * converter);
+// Same as avifImageYUVToRGB(). Returns AVIF_RESULT_INVALID_ARGUMENT if image or rgb does not match
+// the templates given to avifRGBConverterCreate().
+AVIF_API avifResult avifRGBConverterConvert(avifRGBConverter * converter, const avifImage * image, avifRGBImage * rgb);
 
 // Premultiply handling functions.
 // (Un)premultiply is automatically done by the main conversion functions above,
@@ -1066,6 +1130,10 @@ typedef void (*avifIODestroyFunc)(struct avifIO * io);
 // * Otherwise, provide the range and return AVIF_RESULT_OK.
 typedef avifResult (*avifIOReadFunc)(struct avifIO * io, uint32_t readFlags, uint64_t offset, size_t size, avifROData * out);
 
+// This function is used by avifEncoderFinishToIO() to write size bytes of data at offset.
+// writeFlags is currently always 0 and is reserved for future use. Bytes may be written at any
+// offset, in any order, including at offsets that were already written to; the last write wins.
+// Return AVIF_RESULT_OK on success, or AVIF_RESULT_IO_ERROR otherwise.
 typedef avifResult (*avifIOWriteFunc)(struct avifIO * io, uint32_t writeFlags, uint64_t offset, const uint8_t * data, size_t size);
 
 typedef struct avifIO
@@ -1073,7 +1141,7 @@ typedef struct avifIO
     avifIODestroyFunc destroy;
     avifIOReadFunc read;
 
-    // This is reserved for future use - but currently ignored. Set it to a null pointer.
+    // Only used by avifEncoderFinishToIO(). Set it to a null pointer for readers.
     avifIOWriteFunc write;
 
     // If non-zero, this is a hint to internal structures of the max size offered by the content
@@ -1101,6 +1169,32 @@ typedef struct avifIO
 AVIF_API avifIO * avifIOCreateMemoryReader(const uint8_t * data, size_t size);
 // Returns NULL if the file cannot be opened or if the reader cannot be allocated.
 AVIF_API avifIO * avifIOCreateFileReader(const char * filename);
+// Same as avifIOCreateFileReader() but reads from an already open file descriptor, which is not
+// owned by the returned avifIO and must stay open for its lifetime. Reads happen at explicit
+// offsets (pread() or its Windows equivalent) without moving the file position, so several avifIO
+// created from the same file descriptor, for example one per avifDecoder decoding a different
+// part of the same file, may be used concurrently from different threads without locking. Each
+// avifIO has its own read buffer and must only be used by one thread at a time.
+// Returns NULL if fd is invalid, if its size cannot be queried, if the platform does not support
+// reading at explicit offsets or if the reader cannot be allocated.
+AVIF_API avifIO * avifIOCreateFileDescriptorReader(int fd);
+// Same as avifIOCreateFileReader() but maps the whole file in memory instead of reading it, if
+// the platform allows it. The resulting avifIO is persistent, so that the decoder does not copy
+// the samples and metadata read through it. Falls back to avifIOCreateFileReader() if the file
+// cannot be mapped, for example if it is empty or not a regular file. The file must not be
+// modified or truncated for the lifetime of the returned avifIO.
+// Returns NULL if the file cannot be opened or if the reader cannot be allocated.
+AVIF_API avifIO * avifIOCreateMappedFileReader(const char * filename);
+// Returns an avifIO that writes to output, to be used with avifEncoderFinishToIO(). output must be
+// initialized (for example to AVIF_DATA_EMPTY) and stay alive for the lifetime of the returned
+// avifIO. Its contents are replaced or extended by the writes, output->size being the end of the
+// furthest write. Call avifRWDataFree() on output when done with it.
+// Returns NULL if the writer cannot be allocated.
+AVIF_API avifIO * avifIOCreateMemoryWriter(avifRWData * output);
+// Returns an avifIO that writes to the file at filename, which is created or truncated, to be used
+// with avifEncoderFinishToIO(). The file is closed when the avifIO is destroyed.
+// Returns NULL if the file cannot be opened or if the writer cannot be allocated.
+AVIF_API avifIO * avifIOCreateFileWriter(const char * filename);
 AVIF_API void avifIODestroy(avifIO * io);
 
 // ---------------------------------------------------------------------------
@@ -1163,10 +1257,11 @@ typedef enum avifDecoderSource
 
     // Use the chunks inside primary/aux tracks in the moov block.
     // This is where avifs image sequences store their images.
-    AVIF_DECODER_SOURCE_TRACKS
+    AVIF_DECODER_SOURCE_TRACKS,
 
-    // Decode the thumbnail item. Currently unimplemented.
-    // AVIF_DECODER_SOURCE_THUMBNAIL_ITEM
+    // Use the first thumbnail item of the primary item (and its aux (alpha) item) instead of the
+    // primary item. See avifDecoder::thumbnailPresent. Never picked by AVIF_DECODER_SOURCE_AUTO.
+    AVIF_DECODER_SOURCE_THUMBNAIL_ITEM
 } avifDecoderSource;
 
 // Information about the timing of a single image in an image sequence
@@ -1209,7 +1304,10 @@ typedef struct avifDecoder
     // Defaults to AVIF_CODEC_CHOICE_AUTO: Preference determined by order in availableCodecs table (avif.c)
     avifCodecChoice codecChoice;
 
-    // Defaults to 1. -- NOTE: Please see the "Understanding maxThreads" comment block above
+    // Defaults to 1. If greater than 1, the color, alpha and gain map planes are decoded
+    // concurrently, the cells of grid images are decoded in parallel by up to maxThreads threads,
+    // and the remaining threads are handed to the underlying AV1 decoders.
+    // -- NOTE: Please see the "Understanding maxThreads" comment block above
     int maxThreads;
 
     // avifs can have multiple sets of images in them. This specifies which to decode.
@@ -1320,6 +1418,41 @@ typedef struct avifDecoder
 
     // Version 1.1.0 ends here. Add any new members after this line.
 
+    // If not NULL, the decoding work that libavif splits according to maxThreads (grid cells, color/alpha/gain map planes)
+    // runs on this pool instead of on newly spawned threads. Not owned by the decoder. Defaults to NULL.
+    // See the "avifThreadPool" comment block above.
+    avifThreadPool * threadPool;
+
+    // Maximum number of frames of an image sequence (AVIF_DECODER_SOURCE_TRACKS) that the codec may decode concurrently
+    // when avifDecoderNextImage() is called repeatedly, such as for playback. If greater than 1, the samples following the
+    // requested one are read ahead of time and, with codecs supporting frame threading (currently dav1d only), decoded
+    // while earlier frames are output. Frames are still output in order, one per avifDecoderNextImage() call. This trades
+    // memory and latency for throughput; it does not help decoding a single frame. Must be set before
+    // avifDecoderParse(). 0 and 1 mean one frame at a time (default).
+    uint32_t maxFrameDelay;
+
+    // If not 0, copies of the frames of an image sequence (AVIF_DECODER_SOURCE_TRACKS) decoded by avifDecoderNextImage()
+    // and avifDecoderNthImage() are kept, up to this many bytes of pixel data in total. Requesting a cached frame again,
+    // such as when seeking backward or looping, copies it to decoder->image instead of decoding it again from the nearest
+    // keyframe. The least recently used frames are evicted first. The cache is cleared by avifDecoderParse() and
+    // avifDecoderReset(). Defaults to 0.
+    size_t frameCacheBytes;
+
+    // If width and height are not 0, only this region of the image is decoded: avifDecoderNextImage() outputs an image
+    // with the dimensions of the region, and only the cells of a grid image that overlap the region are read and decoded.
+    // The region is in pixels of the reconstructed image, before any clean aperture, rotation or mirror transformation,
+    // which still describe the whole image. x and y must be multiples of 2 where the chroma planes are subsampled.
+    // A decoded gain map is not cropped. Taken into account by avifDecoderParse() and avifDecoderReset(), which return
+    // AVIF_RESULT_INVALID_ARGUMENT if the region is not within the image and set decoder->image->width and height to the
+    // dimensions of the region. To decode another region of the same file, change it and call avifDecoderReset() or
+    // avifDecoderParse() again. Defaults to all zeros.
+    avifCropRect regionOfInterest;
+
+    // This is true when avifDecoderParse() finds a thumbnail item ('thmb' item reference) of the primary item that libavif
+    // can decode. Call avifDecoderSetSource(decoder, AVIF_DECODER_SOURCE_THUMBNAIL_ITEM) to decode it instead of the
+    // primary item, for example for fast previews. decoder->image then has the dimensions and properties of the thumbnail.
+    avifBool thumbnailPresent;
+
 #if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
     // Enable parsing the gain map metadata if present (defaults to AVIF_FALSE).
     // Gain map metadata is read during avifDecoderParse(). Like Exif and XMP, this data
@@ -1367,6 +1500,11 @@ AVIF_API avifResult avifDecoderReadFile(avifDecoder * decoder, avifImage * image
 // to reset the internal decoder back to before the first frame. Calling either
 // avifDecoderSetSource() or avifDecoderParse() will automatically Reset the decoder.
 //
+// The same avifDecoder can decode several files one after the other by calling avifDecoderSetIO*()
+// and avifDecoderParse() again. The underlying AV1 decoder instances (and their threads) are then
+// flushed and reused instead of being recreated, as long as codecChoice, imageSizeLimit, the
+// operating point and allLayers match (only with dav1d and libgav1; other codecs are recreated).
+//
 // avifDecoderSetSource() allows you not only to choose whether to parse tracks or
 // items in a file containing both, but switch between sources without having to
 // Parse again. Normally AVIF_DECODER_SOURCE_AUTO is enough for the common path.
@@ -1383,6 +1521,16 @@ AVIF_API avifResult avifDecoderNextImage(avifDecoder * decoder);
 AVIF_API avifResult avifDecoderNthImage(avifDecoder * decoder, uint32_t frameIndex);
 AVIF_API avifResult avifDecoderReset(avifDecoder * decoder);
 
+// Decodes only the cell at the given 0-based row and column of a grid image into 'image', without
+// decoding the other cells nor allocating decoder->image. Only the item data of that cell (and of the
+// matching alpha cell, if any) is read from the avifIO. The cells of the last row and column are cropped
+// to the grid image dimensions. The image orientation properties (irot, imir, clap) are not applied.
+// Returns AVIF_RESULT_INVALID_ARGUMENT if the primary item is not a grid or if the cell is out of bounds or
+// outside of decoder->regionOfInterest, and AVIF_RESULT_NOT_IMPLEMENTED if the alpha auxiliary image is
+// not a grid of the same layout. decoder->image and decoder->imageIndex are left untouched.
+// This function may be used after a successful call (AVIF_RESULT_OK) to avifDecoderParse().
+AVIF_API avifResult avifDecoderDecodeGridCell(avifDecoder * decoder, uint32_t row, uint32_t column, avifImage * image);
+
 // Keyframe information
 // frameIndex - 0-based, matching avifDecoder->imageIndex, bound by avifDecoder->imageCount
 // "nearest" keyframe means the keyframe prior to this frame index (returns frameIndex if it is a keyframe)
@@ -1520,6 +1668,27 @@ typedef struct avifEncoder
 
     // Version 1.1.0 ends here. Add any new members after this line.
 
+    // If not NULL, the encoding work that libavif splits according to maxThreads runs on this pool instead of on newly
+    // spawned threads. Not owned by the encoder. Defaults to NULL. See the "avifThreadPool" comment block above.
+    avifThreadPool * threadPool;
+
+    // If not 0, avifEncoderAddImage() and avifEncoderAddImageGrid() search for the quality generating the encoded file
+    // size closest to targetSizeBytes. Several trial encodes at different qualities run concurrently, maxThreads being split
+    // between them. quality and qualityAlpha (and qualityGainMap) are ignored and then set to the selected quality.
+    // Only supported for a single still image or grid (AVIF_ADD_IMAGE_FLAG_SINGLE and extraLayerCount set to 0).
+    // Defaults to 0.
+    size_t targetSizeBytes;
+
+    // If not 0, avifEncoderAddImage() and avifEncoderAddImageGrid() also add a thumbnail item ('thmb' item reference) of
+    // the primary item, downscaled so that its largest dimension is thumbnailSize pixels, unless the image is not larger
+    // than that. The thumbnail and its alpha auxiliary item, if any, are encoded once at AVIF_SPEED_FASTEST with quality and
+    // qualityAlpha, and stored at the beginning of the mdat box. See AVIF_DECODER_SOURCE_THUMBNAIL_ITEM.
+    // Only supported for a single still image or grid (AVIF_ADD_IMAGE_FLAG_SINGLE) without premultiplied alpha.
+    // Downscaling requires libavif to be built with libyuv (see avifLibYUVVersion()). Otherwise, adding an image larger
+    // than thumbnailSize fails with AVIF_RESULT_NOT_IMPLEMENTED.
+    // Defaults to 0.
+    uint32_t thumbnailSize;
+
 #if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
     int qualityGainMap; // changeable encoder setting
 #endif
@@ -1566,7 +1735,8 @@ typedef uint32_t avifAddImageFlags;
 // - Still layered grid:
 //   * Set encoder->extraLayerCount correctly
 //   * avifEncoderAddImageGrid() ... [exactly encoder->extraLayerCount+1 times]
-// * avifEncoderFinish()
+// * avifEncoderFinish() or avifEncoderFinishToIO()
+// * Optionally avifEncoderReset(), then back to avifEncoderAddImage() or avifEncoderAddImageGrid()
 // * avifEncoderDestroy()
 //
 // The image passed to avifEncoderAddImage() or avifEncoderAddImageGrid() is encoded during the
@@ -1581,6 +1751,20 @@ AVIF_API avifResult avifEncoderAddImageGrid(avifEncoder * encoder,
                                             const avifImage * const * cellImages,
                                             avifAddImageFlags addImageFlags);
 AVIF_API avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output);
+// Same as avifEncoderFinish() but writes the result to io through io->write instead of assembling
+// it in output. Only the ftyp, meta and moov boxes and the mdat header are assembled in memory; the
+// encoded samples are then written one after the other straight from the encoder's buffers, so the
+// peak memory usage does not include a second copy of the payload. io->read is not used.
+// The encoder and io are not destroyed by this function.
+AVIF_API avifResult avifEncoderFinishToIO(avifEncoder * encoder, avifIO * io);
+// Discards the images added to encoder so that a new file can be encoded with the same settings,
+// as if encoder was just created. It can also be called before avifEncoderFinish() to abandon the
+// current encode. The codec instances that encoded the color and alpha of a still, non-grid image
+// are kept (if the codec supports it) and reused by the next still image with the same dimensions,
+// depth, YUV format and color properties, skipping their initialization. Settings that require a
+// new codec instance (such as maxThreads or speed) may still be changed after this call, at the
+// cost of the reuse. Codec-specific options set for a reused instance keep applying.
+AVIF_API avifResult avifEncoderReset(avifEncoder * encoder);
 
 // Codec-specific, optional "advanced" tuning settings, in the form of string key/value pairs,
 // to be consumed by the codec in the next avifEncoderAddImage() call.
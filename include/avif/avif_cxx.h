@@ -21,12 +21,16 @@ struct UniquePtrDeleter
     void operator()(avifEncoder * encoder) const { avifEncoderDestroy(encoder); }
     void operator()(avifDecoder * decoder) const { avifDecoderDestroy(decoder); }
     void operator()(avifImage * image) const { avifImageDestroy(image); }
+    void operator()(avifThreadPool * pool) const { avifThreadPoolDestroy(pool); }
+    void operator()(avifIO * io) const { avifIODestroy(io); }
 };
 
 // Use these unique_ptr to ensure the structs are automatically destroyed.
 using EncoderPtr = std::unique_ptr<avifEncoder, UniquePtrDeleter>;
 using DecoderPtr = std::unique_ptr<avifDecoder, UniquePtrDeleter>;
 using ImagePtr = std::unique_ptr<avifImage, UniquePtrDeleter>;
+using ThreadPoolPtr = std::unique_ptr<avifThreadPool, UniquePtrDeleter>;
+using IOPtr = std::unique_ptr<avifIO, UniquePtrDeleter>;
 
 } // namespace avif
 
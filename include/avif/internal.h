@@ -315,6 +315,10 @@ typedef struct avifReformatState
 {
     avifRGBColorSpaceInfo rgb;
     avifYUVColorSpaceInfo yuv;
+    // Look-up tables from YUV unorm values to full range RGB FP32, cached by avifRGBConverter. If NULL, the YUV to RGB
+    // conversion functions allocate and fill their own tables.
+    float * unormFloatTableY;
+    float * unormFloatTableUV;
 } avifReformatState;
 
 // Retrieves the pixel value at position (x, y) expressed as floats in [0, 1]. If the image's format doesn't have alpha,
@@ -324,6 +328,31 @@ void avifGetRGBAPixel(const avifRGBImage * src, uint32_t x, uint32_t y, const av
 // support alpha, rgbaPixel[3] is ignored.
 void avifSetRGBAPixel(const avifRGBImage * dst, uint32_t x, uint32_t y, const avifRGBColorSpaceInfo * info, const float rgbaPixel[4]);
 
+// Constants of the AVIF_REFORMAT_MODE_YUV_COEFFICIENTS conversion from YUV to RGB, derived from avifYUVColorSpaceInfo.
+typedef struct avifYUVToRGBRowParams
+{
+    float crToR;          // 2 * (1 - kr)
+    float cbToB;          // 2 * (1 - kb)
+    float crToG;          // kr * (1 - kr)
+    float cbToG;          // kb * (1 - kb)
+    float kg;             // Same as avifYUVColorSpaceInfo::kg.
+    float rgbMaxChannelF; // Same as avifRGBColorSpaceInfo::maxChannelF.
+} avifYUVToRGBRowParams;
+
+// Converts count pixels from Y, Cb and Cr floats, as returned by the look-up tables of the YUV to RGB conversion, to R, G and
+// B unorm values in [0:params->rgbMaxChannelF]. The output is the same as the one of avifImageYUVAnyToRGBAnySlow().
+typedef void (*avifYUVToRGBRowFunc)(const float * y,
+                                    const float * cb,
+                                    const float * cr,
+                                    uint32_t count,
+                                    const avifYUVToRGBRowParams * params,
+                                    uint16_t * r,
+                                    uint16_t * g,
+                                    uint16_t * b);
+// Returns the fastest avifYUVToRGBRowFunc supported by the CPU (AVX2, SSE4.1 or NEON), or the portable C implementation if
+// allowSIMD is false or if no SIMD implementation is supported.
+avifYUVToRGBRowFunc avifGetYUVToRGBRowFunc(avifBool allowSIMD);
+
 // Returns:
 // * AVIF_RESULT_OK              - Converted successfully with libyuv
 // * AVIF_RESULT_NOT_IMPLEMENTED - The fast path for this combination is not implemented with libyuv, use built-in RGB conversion
@@ -338,11 +367,17 @@ avifResult avifImageRGBToYUVLibYUV(avifImage * image, const avifRGBImage * rgb);
 // * alphaReformattedWithLibYUV - Output parameter. If reformatAlpha is set to true and libyuv was able to copy over the alpha
 // channel, then this will be set to AVIF_TRUE. Otherwise, this will be set to AVIF_FALSE. The value in this parameter is valid
 // only if the return value of the function is AVIF_RESULT_OK or AVIF_RESULT_NOT_IMPLEMENTED.
+// * premultiplyAlpha - if set to AVIF_TRUE and libyuv copies over the alpha channel of image, the color channels are also
+// premultiplied by alpha in the same pass, as with avifRGBImagePremultiplyAlpha().
 // Returns:
 // * AVIF_RESULT_OK              - Converted successfully with libyuv
 // * AVIF_RESULT_NOT_IMPLEMENTED - The fast path for this combination is not implemented with libyuv, use built-in YUV conversion
 // * [any other error]           - Return error to caller
-avifResult avifImageYUVToRGBLibYUV(const avifImage * image, avifRGBImage * rgb, avifBool reformatAlpha, avifBool * alphaReformattedWithLibYUV);
+avifResult avifImageYUVToRGBLibYUV(const avifImage * image,
+                                   avifRGBImage * rgb,
+                                   avifBool reformatAlpha,
+                                   avifBool * alphaReformattedWithLibYUV,
+                                   avifBool premultiplyAlpha);
 
 // Returns:
 // * AVIF_RESULT_OK              - Converted successfully with libsharpyuv
@@ -355,6 +390,8 @@ avifResult avifImageRGBToYUVLibSharpYUV(avifImage * image, const avifRGBImage *
 // * AVIF_RESULT_NOT_IMPLEMENTED  - The fast path for this conversion is not implemented with libyuv, use built-in conversion.
 // * AVIF_RESULT_INVALID_ARGUMENT - Return error to caller.
 avifResult avifRGBImageToF16LibYUV(avifRGBImage * rgb);
+// Same as avifRGBImageToF16LibYUV() but for count unorm values of the given depth, converted in place.
+avifResult avifUNormRowToF16LibYUV(uint16_t * row, uint32_t count, uint32_t depth);
 
 // Returns:
 // * AVIF_RESULT_OK              - (Un)Premultiply successfully with libyuv
@@ -552,6 +589,10 @@ typedef avifBool (*avifCodecGetNextImageFunc)(struct avifCodec * codec,
                                               avifBool alpha,
                                               avifBool * isLimitedRangeAlpha,
                                               avifImage * image);
+// Drops the bitstream state and the pictures held by the codec so that it can decode the samples of an unrelated
+// file with the same operatingPoint and allLayers settings, without recreating the underlying decoder. Any image
+// plane pointing to a buffer of the codec is invalidated. Returns AVIF_FALSE if the codec must be destroyed instead.
+typedef avifBool (*avifCodecDecodeResetFunc)(struct avifCodec * codec);
 // EncodeImage and EncodeFinish are not required to always emit a sample, but when all images are
 // encoded and EncodeFinish is called, the number of samples emitted must match the number of submitted frames.
 // avifCodecEncodeImageFunc may return AVIF_RESULT_UNKNOWN_ERROR to automatically emit the appropriate
@@ -582,6 +623,11 @@ typedef avifResult (*avifCodecEncodeImageFunc)(struct avifCodec * codec,
                                                avifAddImageFlags addImageFlags,
                                                avifCodecEncodeOutput * output);
 typedef avifBool (*avifCodecEncodeFinishFunc)(struct avifCodec * codec, avifCodecEncodeOutput * output);
+// Called by avifEncoderReset() on a codec that encoded an AVIF_ADD_IMAGE_FLAG_SINGLE image with keepEncoderAlive set.
+// Returns AVIF_TRUE if the codec is ready to encode another AVIF_ADD_IMAGE_FLAG_SINGLE image of the same dimensions, depth,
+// format and color properties without being recreated, in which case the next encodeImage call receives
+// AVIF_ADD_IMAGE_FLAG_FORCE_KEYFRAME. Returns AVIF_FALSE if the codec must be destroyed instead.
+typedef avifBool (*avifCodecEncodeResetFunc)(struct avifCodec * codec);
 typedef void (*avifCodecDestroyInternalFunc)(struct avifCodec * codec);
 
 typedef struct avifCodec
@@ -593,15 +639,31 @@ typedef struct avifCodec
                                           //
     avifDiagnostics * diag;               // Shallow copy; owned by avifEncoder or avifDecoder
 
+    // Set by the avifEncoder before each encodeImage call, or by the avifDecoder when creating the instance because the
+    // underlying decoders only take it once at initialization. Used to find reusable decoder instances.
+    // It may be a share of avifDecoder::maxThreads or avifEncoder::maxThreads when several codecs run concurrently.
+    int maxThreads;
+
+    // Encoder options (for encodeImage):
+    avifBool keepEncoderAlive; // if true, do not release the underlying encoder after an AVIF_ADD_IMAGE_FLAG_SINGLE image
+
     // Decoder options (for getNextImage):
-    int maxThreads;          // See avifDecoder::maxThreads.
     uint32_t imageSizeLimit; // See avifDecoder::imageSizeLimit.
     uint8_t operatingPoint;  // Operating point, defaults to 0.
     avifBool allLayers;      // if true, the underlying codec must decode all layers, not just the best layer
+    avifCodecChoice choice;  // The choice the avifDecoder created this instance with. Used to find reusable instances.
+    uint32_t maxFrameDelay;  // See avifDecoder::maxFrameDelay. 1 unless the samples are decoded in order from a track.
+    // If maxFrameDelay is greater than 1, the samples following the one given to getNextImage whose data is available.
+    // The codec may send them to the underlying decoder ahead of time to keep several frames in flight, in which case
+    // it must not send them again when they are given to getNextImage. Set by the avifDecoder before each getNextImage call.
+    const avifDecodeSample * lookaheadSamples;
+    uint32_t lookaheadSampleCount;
 
     avifCodecGetNextImageFunc getNextImage;
+    avifCodecDecodeResetFunc decodeReset; // Optional. NULL if the codec cannot be reused for another file.
     avifCodecEncodeImageFunc encodeImage;
     avifCodecEncodeFinishFunc encodeFinish;
+    avifCodecEncodeResetFunc encodeReset; // Optional. NULL if the codec cannot be reused by avifEncoderReset().
     avifCodecDestroyInternalFunc destroyInternal;
 } avifCodec;
 
@@ -633,6 +695,25 @@ void avifDiagnosticsPrintf(avifDiagnostics * diag, const char * format, ...);
 avifResult avifIsCompliant(const uint8_t * data, size_t size);
 #endif
 
+// ---------------------------------------------------------------------------
+// avifThread
+
+typedef void (*avifThreadFunc)(void * arg);
+typedef struct avifThread avifThread;
+
+// Starts a new thread calling func(arg). Returns NULL on failure, in which case the caller may
+// run func(arg) on the current thread instead.
+AVIF_NODISCARD avifThread * avifThreadCreate(avifThreadFunc func, void * arg);
+// Waits for the thread to return and frees it. Returns AVIF_FALSE if the thread could not be joined.
+avifBool avifThreadJoin(avifThread * thread);
+
+// Calls func() on each of the count elements of the args array (each element being argSize bytes
+// long), possibly concurrently, and returns once all calls have returned.
+// If pool is not NULL, the calls are queued on its workers and the current thread helps running
+// them. Otherwise one thread is spawned per call except for the first one, which runs on the
+// current thread. Returns AVIF_FALSE if a thread could not be joined.
+avifBool avifRunInParallel(avifThreadPool * pool, avifThreadFunc func, void * args, size_t argSize, uint32_t count);
+
 // ---------------------------------------------------------------------------
 // avifStream
 //
@@ -712,6 +793,8 @@ typedef struct avifRWStream
 void avifRWStreamStart(avifRWStream * stream, avifRWData * raw);
 size_t avifRWStreamOffset(const avifRWStream * stream);
 void avifRWStreamSetOffset(avifRWStream * stream, size_t offset);
+// Makes sure that size bytes can be written at the current offset without any further allocation.
+avifResult avifRWStreamReserve(avifRWStream * stream, size_t size);
 
 void avifRWStreamFinishWrite(avifRWStream * stream);
 // The following functions require byte alignment.
@@ -621,6 +621,7 @@ void avifRGBImageSetDefaults(avifRGBImage * rgb, const avifImage * image)
                                           // after calling avifRGBImageSetDefaults(),
     rgb->isFloat = AVIF_FALSE;
     rgb->maxThreads = 1;
+    rgb->threadPool = NULL;
 }
 
 avifResult avifRGBImageAllocatePixels(avifRGBImage * rgb)
@@ -68,6 +68,9 @@ struct avifCodecInternal
     // avifEncoderSetCodecSpecificOption(encoder, "tune", value) call.
     avifBool tuningSet;
     uint32_t currentLayer;
+    // Whether an AVIF_ADD_IMAGE_FLAG_SINGLE image was fully encoded and output while keeping the
+    // encoder alive (see avifCodec::keepEncoderAlive). There is nothing left to flush in that case.
+    avifBool singleImageEncoded;
 #endif
 };
 
@@ -746,10 +749,10 @@ static avifResult aomCodecEncodeImage(avifCodec * codec,
         if (disableLaggedOutput) {
             cfg->g_lag_in_frames = 0;
         }
-        if (encoder->maxThreads > 1) {
+        if (codec->maxThreads > 1) {
             // libaom fails if cfg->g_threads is greater than 64 threads. See MAX_NUM_THREADS in
             // aom/aom_util/aom_thread.h.
-            cfg->g_threads = AVIF_MIN(encoder->maxThreads, 64);
+            cfg->g_threads = AVIF_MIN(codec->maxThreads, 64);
         }
 
         codec->internal->monochromeEnabled = AVIF_FALSE;
@@ -1137,6 +1140,7 @@ static avifResult aomCodecEncodeImage(avifCodec * codec,
         return AVIF_RESULT_UNKNOWN_ERROR;
     }
 
+    avifBool gotPacket = AVIF_FALSE;
     aom_codec_iter_t iter = NULL;
     for (;;) {
         const aom_codec_cx_pkt_t * pkt = aom_codec_get_cx_data(&codec->internal->encoder, &iter);
@@ -1144,13 +1148,18 @@ static avifResult aomCodecEncodeImage(avifCodec * codec,
             break;
         }
         if (pkt->kind == AOM_CODEC_CX_FRAME_PKT) {
+            gotPacket = AVIF_TRUE;
             AVIF_CHECKRES(
                 avifCodecEncodeOutputAddSample(output, pkt->data.frame.buf, pkt->data.frame.sz, (pkt->data.frame.flags & AOM_FRAME_IS_KEY)));
         }
     }
 
-    if ((addImageFlags & AVIF_ADD_IMAGE_FLAG_SINGLE) ||
-        ((encoder->extraLayerCount > 0) && (encoder->extraLayerCount == codec->internal->currentLayer))) {
+    if ((addImageFlags & AVIF_ADD_IMAGE_FLAG_SINGLE) && codec->keepEncoderAlive && gotPacket) {
+        // g_lag_in_frames is 0 for a single image so the frame was output right away. Do not flush
+        // the encoder, so that avifEncoderReset() can reuse it for the next single image.
+        codec->internal->singleImageEncoded = AVIF_TRUE;
+    } else if ((addImageFlags & AVIF_ADD_IMAGE_FLAG_SINGLE) ||
+               ((encoder->extraLayerCount > 0) && (encoder->extraLayerCount == codec->internal->currentLayer))) {
         // Flush and clean up encoder resources early to save on overhead when encoding alpha or grid images,
         // as encoding is finished now. For layered image, encoding finishes when the last layer is encoded.
 
@@ -1168,7 +1177,7 @@ static avifResult aomCodecEncodeImage(avifCodec * codec,
 
 static avifBool aomCodecEncodeFinish(avifCodec * codec, avifCodecEncodeOutput * output)
 {
-    if (!codec->internal->encoderInitialized) {
+    if (!codec->internal->encoderInitialized || codec->internal->singleImageEncoded) {
         return AVIF_TRUE;
     }
     for (;;) {
@@ -1208,6 +1217,15 @@ static avifBool aomCodecEncodeFinish(avifCodec * codec, avifCodecEncodeOutput *
     return AVIF_TRUE;
 }
 
+static avifBool aomCodecEncodeReset(avifCodec * codec)
+{
+    if (!codec->internal->encoderInitialized || !codec->internal->singleImageEncoded) {
+        return AVIF_FALSE;
+    }
+    codec->internal->singleImageEncoded = AVIF_FALSE;
+    return AVIF_TRUE;
+}
+
 #endif // defined(AVIF_CODEC_AOM_ENCODE)
 
 const char * avifCodecVersionAOM(void)
@@ -1230,6 +1248,7 @@ avifCodec * avifCodecCreateAOM(void)
 #if defined(AVIF_CODEC_AOM_ENCODE)
     codec->encodeImage = aomCodecEncodeImage;
     codec->encodeFinish = aomCodecEncodeFinish;
+    codec->encodeReset = aomCodecEncodeReset;
 #endif
 
     codec->destroyInternal = aomCodecDestroyInternal;
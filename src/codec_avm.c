@@ -639,10 +639,10 @@ static avifResult avmCodecEncodeImage(avifCodec * codec,
         if (disableLaggedOutput) {
             cfg->g_lag_in_frames = 0;
         }
-        if (encoder->maxThreads > 1) {
+        if (codec->maxThreads > 1) {
             // libavm fails if cfg->g_threads is greater than 64 threads. See MAX_NUM_THREADS in
             // avm/aom_util/aom_thread.h.
-            cfg->g_threads = AVIF_MIN(encoder->maxThreads, 64);
+            cfg->g_threads = AVIF_MIN(codec->maxThreads, 64);
         }
 
         // avm does not handle monochrome as of research-v4.0.0.
@@ -696,7 +696,7 @@ static avifResult avmCodecEncodeImage(avifCodec * codec,
         if (lossless) {
             aom_codec_control(&codec->internal->encoder, AV1E_SET_LOSSLESS, 1);
         }
-        if (encoder->maxThreads > 1) {
+        if (codec->maxThreads > 1) {
             aom_codec_control(&codec->internal->encoder, AV1E_SET_ROW_MT, 1);
         }
         if (tileRowsLog2 != 0) {
@@ -28,6 +28,8 @@ struct avifCodecInternal
     Dav1dPicture dav1dPicture;
     avifBool hasPicture;
     avifRange colorRange;
+    uint32_t samplesSentAhead; // Number of codec->lookaheadSamples already sent to dav1dContext.
+    Dav1dData pendingData;     // Sample data not yet fully consumed by dav1dContext.
 };
 
 static void avifDav1dFreeCallback(const uint8_t * buf, void * cookie)
@@ -42,46 +44,16 @@ static void dav1dCodecDestroyInternal(avifCodec * codec)
     if (codec->internal->hasPicture) {
         dav1d_picture_unref(&codec->internal->dav1dPicture);
     }
+    dav1d_data_unref(&codec->internal->pendingData);
     if (codec->internal->dav1dContext) {
         dav1d_close(&codec->internal->dav1dContext);
     }
     avifFree(codec->internal);
 }
 
-static avifBool dav1dCodecGetNextImage(struct avifCodec * codec,
-                                       const avifDecodeSample * sample,
-                                       avifBool alpha,
-                                       avifBool * isLimitedRangeAlpha,
-                                       avifImage * image)
+// Decodes the frame in sample and discards any other frame output by the decoder.
+static avifBool dav1dCodecDecodeSample(avifCodec * codec, const avifDecodeSample * sample, Dav1dPicture * nextFrame)
 {
-    if (codec->internal->dav1dContext == NULL) {
-        Dav1dSettings dav1dSettings;
-        dav1d_default_settings(&dav1dSettings);
-        // Give all available threads to decode a single frame as fast as possible
-#if DAV1D_API_VERSION_MAJOR >= 6
-        dav1dSettings.max_frame_delay = 1;
-        dav1dSettings.n_threads = AVIF_CLAMP(codec->maxThreads, 1, DAV1D_MAX_THREADS);
-#else
-        dav1dSettings.n_frame_threads = 1;
-        dav1dSettings.n_tile_threads = AVIF_CLAMP(codec->maxThreads, 1, DAV1D_MAX_TILE_THREADS);
-#endif // DAV1D_API_VERSION_MAJOR >= 6
-        // Set a maximum frame size limit to avoid OOM'ing fuzzers. In 32-bit builds, if
-        // frame_size_limit > 8192 * 8192, dav1d reduces frame_size_limit to 8192 * 8192 and logs
-        // a message, so we set frame_size_limit to at most 8192 * 8192 to avoid the dav1d_log
-        // message.
-        dav1dSettings.frame_size_limit = (sizeof(size_t) < 8) ? AVIF_MIN(codec->imageSizeLimit, 8192 * 8192) : codec->imageSizeLimit;
-        dav1dSettings.operating_point = codec->operatingPoint;
-        dav1dSettings.all_layers = codec->allLayers;
-
-        if (dav1d_open(&codec->internal->dav1dContext, &dav1dSettings) != 0) {
-            return AVIF_FALSE;
-        }
-    }
-
-    avifBool gotPicture = AVIF_FALSE;
-    Dav1dPicture nextFrame;
-    memset(&nextFrame, 0, sizeof(Dav1dPicture));
-
     Dav1dData dav1dData;
     if (dav1d_data_wrap(&dav1dData, sample->data.data, sample->data.size, avifDav1dFreeCallback, NULL) != 0) {
         return AVIF_FALSE;
@@ -97,7 +69,7 @@ static avifBool dav1dCodecGetNextImage(struct avifCodec * codec,
             }
         }
 
-        res = dav1d_get_picture(codec->internal->dav1dContext, &nextFrame);
+        res = dav1d_get_picture(codec->internal->dav1dContext, nextFrame);
         if (res == DAV1D_ERR(EAGAIN)) {
             if (dav1dData.data) {
                 // send more data
@@ -112,11 +84,10 @@ static avifBool dav1dCodecGetNextImage(struct avifCodec * codec,
             return AVIF_FALSE;
         } else {
             // Got a picture!
-            if ((sample->spatialID != AVIF_SPATIAL_ID_UNSET) && (sample->spatialID != nextFrame.frame_hdr->spatial_id)) {
+            if ((sample->spatialID != AVIF_SPATIAL_ID_UNSET) && (sample->spatialID != nextFrame->frame_hdr->spatial_id)) {
                 // Layer selection: skip this unwanted layer
-                dav1d_picture_unref(&nextFrame);
+                dav1d_picture_unref(nextFrame);
             } else {
-                gotPicture = AVIF_TRUE;
                 break;
             }
         }
@@ -136,15 +107,127 @@ static avifBool dav1dCodecGetNextImage(struct avifCodec * codec,
         res = dav1d_get_picture(codec->internal->dav1dContext, &bufferedFrame);
         if (res < 0) {
             if (res != DAV1D_ERR(EAGAIN)) {
-                if (gotPicture) {
-                    dav1d_picture_unref(&nextFrame);
-                }
+                dav1d_picture_unref(nextFrame);
                 return AVIF_FALSE;
             }
         } else {
             dav1d_picture_unref(&bufferedFrame);
         }
     } while (res == 0);
+    return AVIF_TRUE;
+}
+
+// Returns AVIF_TRUE if the following samples may be sent to the decoder before sample's frame is output.
+static avifBool dav1dCodecDecodesAhead(const avifCodec * codec, const avifDecodeSample * sample)
+{
+    // Layer selection relies on draining the decoder after each sample.
+    return (codec->maxFrameDelay > 1) && !codec->allLayers && (sample->spatialID == AVIF_SPATIAL_ID_UNSET);
+}
+
+// Same as dav1dCodecDecodeSample() but keeps up to codec->maxFrameDelay frames in flight by sending the samples in
+// codec->lookaheadSamples ahead of time. The frames are output by dav1d in decoding order, one per sample.
+static avifBool dav1dCodecDecodeSampleAhead(avifCodec * codec, const avifDecodeSample * sample, Dav1dPicture * nextFrame)
+{
+    struct avifCodecInternal * internal = codec->internal;
+    avifBool sampleSent = AVIF_FALSE;
+    if (internal->samplesSentAhead > 0) {
+        // sample was already sent by a previous call.
+        --internal->samplesSentAhead;
+        sampleSent = AVIF_TRUE;
+    }
+
+    avifBool drained = AVIF_FALSE;
+    for (;;) {
+        if (!internal->pendingData.sz) {
+            const avifDecodeSample * sampleToSend = NULL;
+            if (!sampleSent) {
+                sampleToSend = sample;
+                sampleSent = AVIF_TRUE;
+            } else if ((internal->samplesSentAhead < codec->lookaheadSampleCount) &&
+                       (internal->samplesSentAhead + 1 < codec->maxFrameDelay)) {
+                sampleToSend = &codec->lookaheadSamples[internal->samplesSentAhead];
+                ++internal->samplesSentAhead;
+            }
+            if (sampleToSend && (dav1d_data_wrap(&internal->pendingData,
+                                                 sampleToSend->data.data,
+                                                 sampleToSend->data.size,
+                                                 avifDav1dFreeCallback,
+                                                 NULL) != 0)) {
+                return AVIF_FALSE;
+            }
+        }
+        if (internal->pendingData.sz) {
+            // pendingData is partially consumed or left untouched if the decoder needs its output to be read first.
+            const int res = dav1d_send_data(internal->dav1dContext, &internal->pendingData);
+            if ((res < 0) && (res != DAV1D_ERR(EAGAIN))) {
+                dav1d_data_unref(&internal->pendingData);
+                return AVIF_FALSE;
+            }
+        }
+
+        const int res = dav1d_get_picture(internal->dav1dContext, nextFrame);
+        if (res == 0) {
+            return AVIF_TRUE;
+        }
+        if (res != DAV1D_ERR(EAGAIN)) {
+            return AVIF_FALSE;
+        }
+        // With frame threading, dav1d only outputs a frame once enough following frames were sent, or when draining.
+        // dav1d_get_picture() drains the frames in flight only if it is called again without any dav1d_send_data() call
+        // in between, so EAGAIN with nothing left to send requires one more call. EAGAIN after that second call means
+        // that the frame of sample cannot be output.
+        if (!internal->pendingData.sz && (internal->samplesSentAhead >= codec->lookaheadSampleCount ||
+                                          internal->samplesSentAhead + 1 >= codec->maxFrameDelay)) {
+            if (drained) {
+                return AVIF_FALSE;
+            }
+            drained = AVIF_TRUE;
+        }
+    }
+}
+
+static avifBool dav1dCodecGetNextImage(struct avifCodec * codec,
+                                       const avifDecodeSample * sample,
+                                       avifBool alpha,
+                                       avifBool * isLimitedRangeAlpha,
+                                       avifImage * image)
+{
+    if (codec->internal->dav1dContext == NULL) {
+        Dav1dSettings dav1dSettings;
+        dav1d_default_settings(&dav1dSettings);
+        // Give all available threads to decode a single frame as fast as possible, unless several frames may be in flight.
+#if DAV1D_API_VERSION_MAJOR >= 6
+        dav1dSettings.max_frame_delay = AVIF_CLAMP(codec->maxFrameDelay, 1, DAV1D_MAX_FRAME_DELAY);
+        dav1dSettings.n_threads = AVIF_CLAMP(codec->maxThreads, 1, DAV1D_MAX_THREADS);
+#else
+        dav1dSettings.n_frame_threads = AVIF_CLAMP(codec->maxFrameDelay, 1, DAV1D_MAX_FRAME_THREADS);
+        dav1dSettings.n_tile_threads = AVIF_CLAMP(codec->maxThreads, 1, DAV1D_MAX_TILE_THREADS);
+#endif // DAV1D_API_VERSION_MAJOR >= 6
+        // Set a maximum frame size limit to avoid OOM'ing fuzzers. In 32-bit builds, if
+        // frame_size_limit > 8192 * 8192, dav1d reduces frame_size_limit to 8192 * 8192 and logs
+        // a message, so we set frame_size_limit to at most 8192 * 8192 to avoid the dav1d_log
+        // message.
+        dav1dSettings.frame_size_limit = (sizeof(size_t) < 8) ? AVIF_MIN(codec->imageSizeLimit, 8192 * 8192) : codec->imageSizeLimit;
+        dav1dSettings.operating_point = codec->operatingPoint;
+        dav1dSettings.all_layers = codec->allLayers;
+
+        if (dav1d_open(&codec->internal->dav1dContext, &dav1dSettings) != 0) {
+            return AVIF_FALSE;
+        }
+    }
+
+    avifBool gotPicture = AVIF_FALSE;
+    Dav1dPicture nextFrame;
+    memset(&nextFrame, 0, sizeof(Dav1dPicture));
+
+    if (dav1dCodecDecodesAhead(codec, sample)) {
+        if (!dav1dCodecDecodeSampleAhead(codec, sample, &nextFrame)) {
+            return AVIF_FALSE;
+        }
+    } else if (!dav1dCodecDecodeSample(codec, sample, &nextFrame)) {
+        return AVIF_FALSE;
+    }
+    gotPicture = AVIF_TRUE;
 
     if (gotPicture) {
         dav1d_picture_unref(&codec->internal->dav1dPicture);
@@ -230,6 +313,21 @@ static avifBool dav1dCodecGetNextImage(struct avifCodec * codec,
     return AVIF_TRUE;
 }
 
+static avifBool dav1dCodecDecodeReset(avifCodec * codec)
+{
+    if (codec->internal->hasPicture) {
+        dav1d_picture_unref(&codec->internal->dav1dPicture);
+        codec->internal->hasPicture = AVIF_FALSE;
+    }
+    dav1d_data_unref(&codec->internal->pendingData);
+    codec->internal->samplesSentAhead = 0;
+    if (codec->internal->dav1dContext) {
+        // Keeps the worker threads of the context alive.
+        dav1d_flush(codec->internal->dav1dContext);
+    }
+    return AVIF_TRUE;
+}
+
 const char * avifCodecVersionDav1d(void)
 {
     return dav1d_version();
@@ -243,6 +341,7 @@ avifCodec * avifCodecCreateDav1d(void)
     }
     memset(codec, 0, sizeof(struct avifCodec));
     codec->getNextImage = dav1dCodecGetNextImage;
+    codec->decodeReset = dav1dCodecDecodeReset;
     codec->destroyInternal = dav1dCodecDestroyInternal;
 
     codec->internal = (struct avifCodecInternal *)avifAlloc(sizeof(struct avifCodecInternal));
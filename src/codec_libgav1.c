@@ -148,6 +148,13 @@ static avifBool gav1CodecGetNextImage(struct avifCodec * codec,
     return AVIF_TRUE;
 }
 
+static avifBool gav1CodecDecodeReset(avifCodec * codec)
+{
+    codec->internal->gav1Image = NULL;
+    // Libgav1DecoderSignalEOS() releases the output frames and resets the decoder for a new stream.
+    return (codec->internal->gav1Decoder == NULL) || (Libgav1DecoderSignalEOS(codec->internal->gav1Decoder) == kLibgav1StatusOk);
+}
+
 const char * avifCodecVersionGav1(void)
 {
     return Libgav1GetVersionString();
@@ -161,6 +168,7 @@ avifCodec * avifCodecCreateGav1(void)
     }
     memset(codec, 0, sizeof(struct avifCodec));
     codec->getNextImage = gav1CodecGetNextImage;
+    codec->decodeReset = gav1CodecDecodeReset;
     codec->destroyInternal = gav1CodecDestroyInternal;
 
     codec->internal = (struct avifCodecInternal *)avifAlloc(sizeof(struct avifCodecInternal));
@@ -139,7 +139,7 @@ static avifResult rav1eCodecEncodeImage(avifCodec * codec,
         if (rav1e_config_parse_int(rav1eConfig, "height", image->height) == -1) {
             goto cleanup;
         }
-        if (rav1e_config_parse_int(rav1eConfig, "threads", encoder->maxThreads) == -1) {
+        if (rav1e_config_parse_int(rav1eConfig, "threads", codec->maxThreads) == -1) {
             goto cleanup;
         }
 
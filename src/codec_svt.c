@@ -132,7 +132,7 @@ static avifResult svtCodecEncodeImage(avifCodec * codec,
 
         svt_config->source_width = image->width;
         svt_config->source_height = image->height;
-        svt_config->logical_processors = encoder->maxThreads;
+        svt_config->logical_processors = codec->maxThreads;
         svt_config->enable_adaptive_quantization = 2;
         // disable 2-pass
 #if SVT_AV1_CHECK_VERSION(0, 9, 0)
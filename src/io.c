@@ -1,12 +1,37 @@
 // Copyright 2020 Joe Drago. All rights reserved.
 // SPDX-License-Identifier: BSD-2-Clause
 
+// Use 64-bit file offsets on 32-bit Linux and Android too, so that fopen(), fstat() and pread() work with files larger
+// than 2 GB. This must be defined before any system header is included.
+#if !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+
 #include "avif/internal.h"
 
 #include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#define AVIF_IO_HAS_MMAP
+#define AVIF_IO_HAS_PREAD
+#define AVIF_FILENO _fileno
+#elif defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#define AVIF_IO_HAS_MMAP
+#define AVIF_IO_HAS_PREAD
+#define AVIF_FILENO fileno
+#endif
+
 void avifIODestroy(avifIO * io)
 {
     if (io && io->destroy) {
@@ -79,9 +104,76 @@ typedef struct avifIOFileReader
 {
     avifIO io; // this must be the first member for easy casting to avifIO*
     avifRWData buffer;
-    FILE * f;
+    FILE * f; // NULL if the reader was created from a file descriptor it does not own.
+#if defined(AVIF_IO_HAS_PREAD)
+    int fd; // Read at explicit offsets, without moving a shared file position.
+#endif
 } avifIOFileReader;
 
+// Reads up to size bytes at offset into data. Sets *bytesRead to less than size only at EOF.
+static avifResult avifIOFileReaderReadAt(avifIOFileReader * reader, uint64_t offset, uint8_t * data, size_t size,
+                                         size_t * bytesRead)
+{
+    *bytesRead = 0;
+#if defined(_WIN32)
+    HANDLE handle = (HANDLE)_get_osfhandle(reader->fd);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return AVIF_RESULT_IO_ERROR;
+    }
+    while (*bytesRead < size) {
+        // ReadFile() reads at the offset given in OVERLAPPED, whatever the current file position is.
+        const uint64_t position = offset + *bytesRead;
+        OVERLAPPED overlapped;
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = (DWORD)(position & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)(position >> 32);
+        const DWORD chunkSize = (DWORD)AVIF_MIN(size - *bytesRead, (size_t)(1u << 30));
+        DWORD chunkBytesRead = 0;
+        if (!ReadFile(handle, data + *bytesRead, chunkSize, &chunkBytesRead, &overlapped)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) {
+                break;
+            }
+            return AVIF_RESULT_IO_ERROR;
+        }
+        if (chunkBytesRead == 0) {
+            break; // EOF
+        }
+        *bytesRead += chunkBytesRead;
+    }
+#elif defined(AVIF_IO_HAS_PREAD)
+    while (*bytesRead < size) {
+        const uint64_t position = offset + *bytesRead;
+        if ((off_t)position < 0 || (uint64_t)(off_t)position != position) {
+            return AVIF_RESULT_IO_ERROR; // Not representable as off_t.
+        }
+        const size_t chunkSize = AVIF_MIN(size - *bytesRead, (size_t)SSIZE_MAX);
+        const ssize_t chunkBytesRead = pread(reader->fd, data + *bytesRead, chunkSize, (off_t)position);
+        if (chunkBytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return AVIF_RESULT_IO_ERROR;
+        }
+        if (chunkBytesRead == 0) {
+            break; // EOF
+        }
+        *bytesRead += (size_t)chunkBytesRead;
+    }
+#else
+    if (offset > LONG_MAX) {
+        return AVIF_RESULT_IO_ERROR;
+    }
+    if (fseek(reader->f, (long)offset, SEEK_SET) != 0) {
+        return AVIF_RESULT_IO_ERROR;
+    }
+    *bytesRead = fread(data, 1, size, reader->f);
+    if (*bytesRead != size && ferror(reader->f)) {
+        return AVIF_RESULT_IO_ERROR;
+    }
+#endif
+    return AVIF_RESULT_OK;
+}
+
 static avifResult avifIOFileReaderRead(struct avifIO * io, uint32_t readFlags, uint64_t offset, size_t size, avifROData * out)
 {
     // printf("avifIOFileReaderRead offset %" PRIu64 " size %zu\n", offset, size);
@@ -104,22 +196,12 @@ static avifResult avifIOFileReaderRead(struct avifIO * io, uint32_t readFlags, u
     }
 
     if (size > 0) {
-        if (offset > LONG_MAX) {
-            return AVIF_RESULT_IO_ERROR;
-        }
         if (reader->buffer.size < size) {
             AVIF_CHECKRES(avifRWDataRealloc(&reader->buffer, size));
         }
-        if (fseek(reader->f, (long)offset, SEEK_SET) != 0) {
-            return AVIF_RESULT_IO_ERROR;
-        }
-        size_t bytesRead = fread(reader->buffer.data, 1, size, reader->f);
-        if (size != bytesRead) {
-            if (ferror(reader->f)) {
-                return AVIF_RESULT_IO_ERROR;
-            }
-            size = bytesRead;
-        }
+        size_t bytesRead;
+        AVIF_CHECKRES(avifIOFileReaderReadAt(reader, offset, reader->buffer.data, size, &bytesRead));
+        size = bytesRead;
     }
 
     out->data = reader->buffer.data;
@@ -130,11 +212,62 @@ static avifResult avifIOFileReaderRead(struct avifIO * io, uint32_t readFlags, u
 static void avifIOFileReaderDestroy(struct avifIO * io)
 {
     avifIOFileReader * reader = (avifIOFileReader *)io;
-    fclose(reader->f);
+    if (reader->f) {
+        fclose(reader->f);
+    }
     avifRWDataFree(&reader->buffer);
     avifFree(io);
 }
 
+// Takes ownership of f, if not NULL.
+static avifIO * avifIOCreateFileReaderInternal(FILE * f, int fd, uint64_t fileSize)
+{
+    avifIOFileReader * reader = (avifIOFileReader *)avifAlloc(sizeof(avifIOFileReader));
+    if (!reader) {
+        if (f) {
+            fclose(f);
+        }
+        return NULL;
+    }
+    memset(reader, 0, sizeof(avifIOFileReader));
+    reader->f = f;
+#if defined(AVIF_IO_HAS_PREAD)
+    reader->fd = fd;
+#else
+    (void)fd;
+#endif
+    reader->io.destroy = avifIOFileReaderDestroy;
+    reader->io.read = avifIOFileReaderRead;
+    reader->io.sizeHint = fileSize;
+    reader->io.persistent = AVIF_FALSE;
+    if (avifRWDataRealloc(&reader->buffer, 1024) != AVIF_RESULT_OK) {
+        avifIOFileReaderDestroy((avifIO *)reader);
+        return NULL;
+    }
+    return (avifIO *)reader;
+}
+
+#if defined(AVIF_IO_HAS_PREAD)
+// Returns AVIF_FALSE if fd is not valid or does not refer to a file whose size is known.
+static avifBool avifGetFileSize(int fd, uint64_t * fileSize)
+{
+#if defined(_WIN32)
+    const __int64 size = _filelengthi64(fd);
+#else
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return AVIF_FALSE;
+    }
+    const off_t size = st.st_size;
+#endif
+    if (size < 0) {
+        return AVIF_FALSE;
+    }
+    *fileSize = (uint64_t)size;
+    return AVIF_TRUE;
+}
+#endif
+
 avifIO * avifIOCreateFileReader(const char * filename)
 {
     FILE * f = fopen(filename, "rb");
@@ -142,6 +275,15 @@ avifIO * avifIOCreateFileReader(const char * filename)
         return NULL;
     }
 
+#if defined(AVIF_IO_HAS_PREAD)
+    const int fd = AVIF_FILENO(f);
+    uint64_t fileSize;
+    if (!avifGetFileSize(fd, &fileSize)) {
+        fclose(f);
+        return NULL;
+    }
+#else
+    const int fd = -1;
     fseek(f, 0, SEEK_END);
     long fileSize = ftell(f);
     if (fileSize < 0) {
@@ -149,22 +291,283 @@ avifIO * avifIOCreateFileReader(const char * filename)
         return NULL;
     }
     fseek(f, 0, SEEK_SET);
+#endif
+    return avifIOCreateFileReaderInternal(f, fd, (uint64_t)fileSize);
+}
 
-    avifIOFileReader * reader = (avifIOFileReader *)avifAlloc(sizeof(avifIOFileReader));
-    if (!reader) {
-        fclose(f);
+avifIO * avifIOCreateFileDescriptorReader(int fd)
+{
+#if defined(AVIF_IO_HAS_PREAD)
+    uint64_t fileSize;
+    if (fd < 0 || !avifGetFileSize(fd, &fileSize)) {
         return NULL;
     }
-    memset(reader, 0, sizeof(avifIOFileReader));
-    reader->f = f;
-    reader->io.destroy = avifIOFileReaderDestroy;
-    reader->io.read = avifIOFileReaderRead;
-    reader->io.sizeHint = (uint64_t)fileSize;
-    reader->io.persistent = AVIF_FALSE;
-    if (avifRWDataRealloc(&reader->buffer, 1024) != AVIF_RESULT_OK) {
-        avifFree(reader);
+    return avifIOCreateFileReaderInternal(NULL, fd, fileSize);
+#else
+    (void)fd;
+    return NULL;
+#endif
+}
+
+// --------------------------------------------------------------------------------------
+// avifIOMappedFileReader
+
+#if defined(AVIF_IO_HAS_MMAP)
+// Maps the whole file in read-only memory. Returns NULL on failure, including for empty files that cannot be mapped.
+static const uint8_t * avifMapFile(const char * filename, size_t * size)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 || (uint64_t)fileSize.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return NULL;
+    }
+    // The view keeps the mapping and the file alive until UnmapViewOfFile().
+    const uint8_t * data = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL) {
+        return NULL;
+    }
+    *size = (size_t)fileSize.QuadPart;
+    return data;
+#else
+    const int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || (uint64_t)st.st_size > SIZE_MAX) {
+        close(fd);
+        return NULL;
+    }
+    // The mapping stays valid after the file descriptor is closed.
+    void * data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    return (const uint8_t *)data;
+#endif
+}
+
+static void avifUnmapFile(const uint8_t * data, size_t size)
+{
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap((void *)data, size);
+#endif
+}
+
+static void avifIOMappedFileReaderDestroy(struct avifIO * io)
+{
+    avifIOMemoryReader * reader = (avifIOMemoryReader *)io;
+    avifUnmapFile(reader->rodata.data, reader->rodata.size);
+    avifFree(io);
+}
+#endif // defined(AVIF_IO_HAS_MMAP)
+
+avifIO * avifIOCreateMappedFileReader(const char * filename)
+{
+#if defined(AVIF_IO_HAS_MMAP)
+    size_t size = 0;
+    const uint8_t * data = avifMapFile(filename, &size);
+    if (data != NULL) {
+        // The mapped file is read like a memory buffer that is owned by the reader.
+        avifIOMemoryReader * reader = (avifIOMemoryReader *)avifAlloc(sizeof(avifIOMemoryReader));
+        if (reader == NULL) {
+            avifUnmapFile(data, size);
+            return NULL;
+        }
+        memset(reader, 0, sizeof(avifIOMemoryReader));
+        reader->io.destroy = avifIOMappedFileReaderDestroy;
+        reader->io.read = avifIOMemoryReaderRead;
+        reader->io.sizeHint = size;
+        reader->io.persistent = AVIF_TRUE;
+        reader->rodata.data = data;
+        reader->rodata.size = size;
+        return (avifIO *)reader;
+    }
+#endif
+    // The file cannot be mapped. Fall back to reading it.
+    return avifIOCreateFileReader(filename);
+}
+
+// --------------------------------------------------------------------------------------
+// avifIOMemoryWriter
+
+typedef struct avifIOMemoryWriter
+{
+    avifIO io; // this must be the first member for easy casting to avifIO*
+    avifRWData * output;
+    size_t capacity; // Allocated size of output->data. output->size is the number of bytes written so far.
+} avifIOMemoryWriter;
+
+static avifResult avifIOMemoryWriterWrite(struct avifIO * io, uint32_t writeFlags, uint64_t offset,
+                                          const uint8_t * data, size_t size)
+{
+    if (writeFlags != 0) {
+        // Unsupported writeFlags
+        return AVIF_RESULT_IO_ERROR;
+    }
+
+    avifIOMemoryWriter * writer = (avifIOMemoryWriter *)io;
+    avifRWData * output = writer->output;
+    if ((offset > SIZE_MAX) || (size > SIZE_MAX - (size_t)offset)) {
+        return AVIF_RESULT_OUT_OF_MEMORY;
+    }
+    const size_t end = (size_t)offset + size;
+    if (end > writer->capacity) {
+        // Grow geometrically so that writing N bytes in small pieces costs O(N) copies in total.
+        size_t newCapacity = AVIF_MAX(writer->capacity, (size_t)1024);
+        while (newCapacity < end) {
+            newCapacity = (newCapacity <= SIZE_MAX / 2) ? newCapacity * 2 : end;
+        }
+        uint8_t * newData = (uint8_t *)avifAlloc(newCapacity);
+        AVIF_CHECKERR(newData != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+        if (output->size) {
+            memcpy(newData, output->data, output->size);
+        }
+        avifFree(output->data);
+        output->data = newData;
+        writer->capacity = newCapacity;
+    }
+    if (offset > output->size) {
+        // Writing past the end leaves a gap that is filled with zeros.
+        memset(output->data + output->size, 0, (size_t)offset - output->size);
+    }
+    if (size) {
+        memcpy(output->data + offset, data, size);
+    }
+    output->size = AVIF_MAX(output->size, end);
+    return AVIF_RESULT_OK;
+}
+
+static void avifIOMemoryWriterDestroy(struct avifIO * io)
+{
+    avifFree(io);
+}
+
+avifIO * avifIOCreateMemoryWriter(avifRWData * output)
+{
+    avifIOMemoryWriter * writer = (avifIOMemoryWriter *)avifAlloc(sizeof(avifIOMemoryWriter));
+    if (writer == NULL) {
+        return NULL;
+    }
+    memset(writer, 0, sizeof(avifIOMemoryWriter));
+    writer->io.destroy = avifIOMemoryWriterDestroy;
+    writer->io.write = avifIOMemoryWriterWrite;
+    writer->output = output;
+    writer->capacity = output->size;
+    return (avifIO *)writer;
+}
+
+// --------------------------------------------------------------------------------------
+// avifIOFileWriter
+
+typedef struct avifIOFileWriter
+{
+    avifIO io; // this must be the first member for easy casting to avifIO*
+    FILE * f;
+} avifIOFileWriter;
+
+static avifResult avifIOFileWriterWrite(struct avifIO * io, uint32_t writeFlags, uint64_t offset,
+                                        const uint8_t * data, size_t size)
+{
+    if (writeFlags != 0) {
+        // Unsupported writeFlags
+        return AVIF_RESULT_IO_ERROR;
+    }
+
+    avifIOFileWriter * writer = (avifIOFileWriter *)io;
+    size_t bytesWritten = 0;
+#if defined(_WIN32)
+    HANDLE handle = (HANDLE)_get_osfhandle(AVIF_FILENO(writer->f));
+    if (handle == INVALID_HANDLE_VALUE) {
+        return AVIF_RESULT_IO_ERROR;
+    }
+    while (bytesWritten < size) {
+        // WriteFile() writes at the offset given in OVERLAPPED, whatever the current file position is.
+        const uint64_t position = offset + bytesWritten;
+        OVERLAPPED overlapped;
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = (DWORD)(position & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)(position >> 32);
+        const DWORD chunkSize = (DWORD)AVIF_MIN(size - bytesWritten, (size_t)(1u << 30));
+        DWORD chunkBytesWritten = 0;
+        if (!WriteFile(handle, data + bytesWritten, chunkSize, &chunkBytesWritten, &overlapped) || chunkBytesWritten == 0) {
+            return AVIF_RESULT_IO_ERROR;
+        }
+        bytesWritten += chunkBytesWritten;
+    }
+#elif defined(AVIF_IO_HAS_PREAD)
+    const int fd = AVIF_FILENO(writer->f);
+    while (bytesWritten < size) {
+        const uint64_t position = offset + bytesWritten;
+        if ((off_t)position < 0 || (uint64_t)(off_t)position != position) {
+            return AVIF_RESULT_IO_ERROR; // Not representable as off_t.
+        }
+        const size_t chunkSize = AVIF_MIN(size - bytesWritten, (size_t)SSIZE_MAX);
+        const ssize_t chunkBytesWritten = pwrite(fd, data + bytesWritten, chunkSize, (off_t)position);
+        if (chunkBytesWritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return AVIF_RESULT_IO_ERROR;
+        }
+        if (chunkBytesWritten == 0) {
+            return AVIF_RESULT_IO_ERROR;
+        }
+        bytesWritten += (size_t)chunkBytesWritten;
+    }
+#else
+    if (offset > LONG_MAX) {
+        return AVIF_RESULT_IO_ERROR;
+    }
+    if (fseek(writer->f, (long)offset, SEEK_SET) != 0) {
+        return AVIF_RESULT_IO_ERROR;
+    }
+    bytesWritten = fwrite(data, 1, size, writer->f);
+    // Report write errors now rather than when the file is closed.
+    if ((bytesWritten != size) || (fflush(writer->f) != 0)) {
+        return AVIF_RESULT_IO_ERROR;
+    }
+#endif
+    return AVIF_RESULT_OK;
+}
+
+static void avifIOFileWriterDestroy(struct avifIO * io)
+{
+    avifIOFileWriter * writer = (avifIOFileWriter *)io;
+    fclose(writer->f);
+    avifFree(io);
+}
+
+avifIO * avifIOCreateFileWriter(const char * filename)
+{
+    FILE * f = fopen(filename, "wb");
+    if (!f) {
+        return NULL;
+    }
+    avifIOFileWriter * writer = (avifIOFileWriter *)avifAlloc(sizeof(avifIOFileWriter));
+    if (!writer) {
         fclose(f);
         return NULL;
     }
-    return (avifIO *)reader;
+    memset(writer, 0, sizeof(avifIOFileWriter));
+    writer->f = f;
+    writer->io.destroy = avifIOFileWriterDestroy;
+    writer->io.write = avifIOFileWriterWrite;
+    return (avifIO *)writer;
 }
@@ -201,6 +201,7 @@ typedef struct avifDecoderItem
     uint32_t auxForID;             // if non-zero, this item is an auxC plane for Item #{auxForID}
     uint32_t descForID;            // if non-zero, this item is a content description for Item #{descForID}
     uint32_t dimgForID;            // if non-zero, this item is an input of derived Item #{dimgForID}
+    uint32_t alphaGridForID;       // if non-zero, this item was created as the alpha grid of the tiles of Item #{alphaGridForID}
     uint32_t dimgIdx; // If dimgForId is non-zero, this is the zero-based index of this item in the list of Item #{dimgForID}'s dimg.
     avifBool hasDimgFrom; // whether there is a 'dimg' box with this item's id as 'fromID'
     uint32_t premByID;    // if non-zero, this item is premultiplied by Item #{premByID}
@@ -840,9 +841,32 @@ typedef struct avifTileInfo
     unsigned int tileCount;
     unsigned int decodedTileCount;
     unsigned int firstTileIndex; // Within avifDecoderData.tiles.
+    // Number of worker threads decoding the tiles of this grid concurrently. Set by avifDecoderCreateCodecs().
+    // The tile at index i is always decoded by the worker at index (i % parallelJobCount), so that tiles sharing
+    // a codec instance are never decoded at the same time. 0 or 1 means the tiles are decoded serially.
+    unsigned int parallelJobCount;
     avifImageGrid grid;
+    // The tiles are the cells of grid in rows [firstGridRow, firstGridRow + gridRowCount) and columns
+    // [firstGridColumn, firstGridColumn + gridColumnCount), in raster order. These are all the cells of grid unless
+    // avifDecoder::regionOfInterest is set. Unused if there is no grid.
+    uint32_t firstGridRow;
+    uint32_t firstGridColumn;
+    uint32_t gridRowCount;
+    uint32_t gridColumnCount;
 } avifTileInfo;
 
+AVIF_ARRAY_DECLARE(avifCodecArray, avifCodec *, codec);
+
+// A copy of a decoded frame of an image sequence. See avifDecoder::frameCacheBytes.
+typedef struct avifCachedFrame
+{
+    uint32_t frameIndex;
+    avifImage * image;
+    size_t size;      // Number of bytes of the planes of image
+    uint64_t lastUse; // Value of avifDecoderData::frameCacheClock when the frame was last stored or restored
+} avifCachedFrame;
+AVIF_ARRAY_DECLARE(avifCachedFrameArray, avifCachedFrame, frame);
+
 typedef struct avifDecoderData
 {
     avifMeta * meta; // The root-level meta box
@@ -864,6 +888,22 @@ typedef struct avifDecoderData
     //   decoder instance (same as above).
     avifCodec * codec;
     avifCodec * codecAlpha;
+    // When decoding the tiles of a grid in parallel (decoder->maxThreads > 1), a small pool of decoder instances is shared
+    // by the tiles of each item category instead of |codec|. See avifTileInfo::parallelJobCount.
+    avifCodecArray gridCodecs;
+    // Flushed decoder instances that are not used by any tile. They are kept when another file is parsed with the same
+    // avifDecoder so that the next avifDecoderCreateCodecs() call does not have to create new ones.
+    avifCodecArray idleCodecs;
+    // Frames decoded by avifDecoderNextImage(), restored instead of being decoded again when avifDecoder::frameCacheBytes
+    // is not 0. The least recently used frames are evicted first when the total size would exceed frameCacheBytes.
+    avifCachedFrameArray frameCache;
+    size_t frameCacheSize;    // Sum of the sizes of the frames in frameCache
+    uint64_t frameCacheClock; // Incremented each time a cached frame is used
+    // Copy of avifDecoder::regionOfInterest made by avifDecoderReset(). See avifDecoderDataUsesRegionOfInterest().
+    avifCropRect regionOfInterest;
+    // Index of the frame last decoded by the codec instances, that is the frame preceding the one they can decode next.
+    // It differs from avifDecoder::imageIndex after frames were restored from frameCache instead of being decoded.
+    int codecImageIndex;
     uint8_t majorBrand[4];                     // From the file's ftyp, used by AVIF_DECODER_SOURCE_AUTO
     avifBrandArray compatibleBrands;           // From the file's ftyp
     avifDiagnostics * diag;                    // Shallow copy; owned by avifDecoder
@@ -885,6 +925,20 @@ typedef struct avifDecoderData
 
 static void avifDecoderDataDestroy(avifDecoderData * data);
 
+// Returns AVIF_TRUE if only the part of the image of itemCategory within data->regionOfInterest is decoded.
+static avifBool avifDecoderDataUsesRegionOfInterest(const avifDecoderData * data, avifItemCategory itemCategory)
+{
+#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
+    if (itemCategory == AVIF_ITEM_GAIN_MAP) {
+        // The gain map may have other dimensions than the color and alpha planes.
+        return AVIF_FALSE;
+    }
+#else
+    (void)itemCategory;
+#endif
+    return (data->regionOfInterest.width > 0) && (data->regionOfInterest.height > 0);
+}
+
 static avifDecoderData * avifDecoderDataCreate(void)
 {
     avifDecoderData * data = (avifDecoderData *)avifAlloc(sizeof(avifDecoderData));
@@ -894,41 +948,114 @@ static avifDecoderData * avifDecoderDataCreate(void)
     memset(data, 0, sizeof(avifDecoderData));
     data->meta = avifMetaCreate();
     if (data->meta == NULL || !avifArrayCreate(&data->tracks, sizeof(avifTrack), 2) ||
-        !avifArrayCreate(&data->tiles, sizeof(avifTile), 8)) {
+        !avifArrayCreate(&data->tiles, sizeof(avifTile), 8) || !avifArrayCreate(&data->gridCodecs, sizeof(avifCodec *), 4) ||
+        !avifArrayCreate(&data->idleCodecs, sizeof(avifCodec *), 2) ||
+        !avifArrayCreate(&data->frameCache, sizeof(avifCachedFrame), 8)) {
         avifDecoderDataDestroy(data);
         return NULL;
     }
     return data;
 }
 
-static void avifDecoderDataResetCodec(avifDecoderData * data)
+// Returns AVIF_TRUE if codec is owned by data and possibly shared by several tiles, AVIF_FALSE if it is owned by a single tile.
+static avifBool avifDecoderDataOwnsCodec(const avifDecoderData * data, const avifCodec * codec)
+{
+    if (codec == data->codec || codec == data->codecAlpha) {
+        return AVIF_TRUE;
+    }
+    for (uint32_t i = 0; i < data->gridCodecs.count; ++i) {
+        if (codec == data->gridCodecs.codec[i]) {
+            return AVIF_TRUE;
+        }
+    }
+    return AVIF_FALSE;
+}
+
+// Flushes codec and keeps it in data->idleCodecs for a later avifCodecCreateInternal() call, or destroys it if it
+// cannot be reused.
+static void avifDecoderDataRecycleCodec(avifDecoderData * data, avifCodec * codec)
+{
+    if (codec->decodeReset && codec->decodeReset(codec)) {
+        avifCodec ** idleCodec = (avifCodec **)avifArrayPush(&data->idleCodecs);
+        if (idleCodec != NULL) {
+            *idleCodec = codec;
+            return;
+        }
+    }
+    avifCodecDestroy(codec);
+}
+
+// Detaches all decoder instances from the tiles. They must not be referenced by any image plane anymore.
+static void avifDecoderDataReleaseCodecs(avifDecoderData * data)
 {
     for (unsigned int i = 0; i < data->tiles.count; ++i) {
         avifTile * tile = &data->tiles.tile[i];
-        if (tile->image) {
-            avifImageFreePlanes(tile->image, AVIF_PLANES_ALL); // forget any pointers into codec image buffers
-        }
         if (tile->codec) {
-            // Check if tile->codec was created separately and destroy it in that case.
-            if (tile->codec != data->codec && tile->codec != data->codecAlpha) {
-                avifCodecDestroy(tile->codec);
+            // Check if tile->codec was created separately and release it in that case.
+            if (!avifDecoderDataOwnsCodec(data, tile->codec)) {
+                avifDecoderDataRecycleCodec(data, tile->codec);
             }
             tile->codec = NULL;
         }
     }
-    for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
-        data->tileInfos[c].decodedTileCount = 0;
+    for (uint32_t i = 0; i < data->gridCodecs.count; ++i) {
+        avifDecoderDataRecycleCodec(data, data->gridCodecs.codec[i]);
     }
+    data->gridCodecs.count = 0;
     if (data->codec) {
-        avifCodecDestroy(data->codec);
+        avifDecoderDataRecycleCodec(data, data->codec);
         data->codec = NULL;
     }
     if (data->codecAlpha) {
-        avifCodecDestroy(data->codecAlpha);
+        avifDecoderDataRecycleCodec(data, data->codecAlpha);
         data->codecAlpha = NULL;
     }
 }
 
+static void avifDecoderDataDestroyIdleCodecs(avifDecoderData * data)
+{
+    for (uint32_t i = 0; i < data->idleCodecs.count; ++i) {
+        avifCodecDestroy(data->idleCodecs.codec[i]);
+    }
+    data->idleCodecs.count = 0;
+}
+
+// Returns a decoder instance of data->idleCodecs created for the same choice and settings, or NULL.
+static avifCodec * avifDecoderDataTakeIdleCodec(avifDecoderData * data,
+                                                avifCodecChoice choice,
+                                                const avifTile * tile,
+                                                uint32_t imageSizeLimit,
+                                                int maxThreads,
+                                                uint32_t maxFrameDelay)
+{
+    for (uint32_t i = 0; i < data->idleCodecs.count; ++i) {
+        avifCodec * codec = data->idleCodecs.codec[i];
+        if ((codec->choice == choice) && (codec->operatingPoint == tile->operatingPoint) &&
+            (codec->allLayers == tile->input->allLayers) && (codec->imageSizeLimit == imageSizeLimit) &&
+            (codec->maxThreads == maxThreads) && (codec->maxFrameDelay == maxFrameDelay)) {
+            data->idleCodecs.codec[i] = data->idleCodecs.codec[data->idleCodecs.count - 1];
+            --data->idleCodecs.count;
+            return codec;
+        }
+    }
+    return NULL;
+}
+
+static void avifDecoderDataResetCodec(avifDecoderData * data)
+{
+    for (unsigned int i = 0; i < data->tiles.count; ++i) {
+        avifTile * tile = &data->tiles.tile[i];
+        if (tile->image) {
+            avifImageFreePlanes(tile->image, AVIF_PLANES_ALL); // forget any pointers into codec image buffers
+        }
+    }
+    for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
+        data->tileInfos[c].decodedTileCount = 0;
+        data->tileInfos[c].parallelJobCount = 0;
+    }
+    avifDecoderDataReleaseCodecs(data);
+}
+
 static avifTile * avifDecoderDataCreateTile(avifDecoderData * data, avifCodecType codecType, uint32_t width, uint32_t height, uint8_t operatingPoint)
 {
     avifTile * tile = (avifTile *)avifArrayPush(&data->tiles);
@@ -976,19 +1103,13 @@ static avifTrack * avifDecoderDataCreateTrack(avifDecoderData * data)
 
 static void avifDecoderDataClearTiles(avifDecoderData * data)
 {
+    avifDecoderDataReleaseCodecs(data);
     for (unsigned int i = 0; i < data->tiles.count; ++i) {
         avifTile * tile = &data->tiles.tile[i];
         if (tile->input) {
             avifCodecDecodeInputDestroy(tile->input);
             tile->input = NULL;
         }
-        if (tile->codec) {
-            // Check if tile->codec was created separately and destroy it in that case.
-            if (tile->codec != data->codec && tile->codec != data->codecAlpha) {
-                avifCodecDestroy(tile->codec);
-            }
-            tile->codec = NULL;
-        }
         if (tile->image) {
             avifImageDestroy(tile->image);
             tile->image = NULL;
@@ -998,15 +1119,17 @@ static void avifDecoderDataClearTiles(avifDecoderData * data)
     for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
         data->tileInfos[c].tileCount = 0;
         data->tileInfos[c].decodedTileCount = 0;
+        data->tileInfos[c].parallelJobCount = 0;
     }
-    if (data->codec) {
-        avifCodecDestroy(data->codec);
-        data->codec = NULL;
-    }
-    if (data->codecAlpha) {
-        avifCodecDestroy(data->codecAlpha);
-        data->codecAlpha = NULL;
+}
+
+static void avifDecoderDataClearFrameCache(avifDecoderData * data)
+{
+    for (uint32_t i = 0; i < data->frameCache.count; ++i) {
+        avifImageDestroy(data->frameCache.frame[i].image);
     }
+    data->frameCache.count = 0;
+    data->frameCacheSize = 0;
 }
 
 static void avifDecoderDataDestroy(avifDecoderData * data)
@@ -1025,7 +1148,12 @@ static void avifDecoderDataDestroy(avifDecoderData * data)
     }
     avifArrayDestroy(&data->tracks);
     avifDecoderDataClearTiles(data);
+    avifDecoderDataDestroyIdleCodecs(data);
     avifArrayDestroy(&data->tiles);
+    avifArrayDestroy(&data->gridCodecs);
+    avifArrayDestroy(&data->idleCodecs);
+    avifDecoderDataClearFrameCache(data);
+    avifArrayDestroy(&data->frameCache);
     avifArrayDestroy(&data->compatibleBrands);
     avifFree(data);
 }
@@ -1447,15 +1575,23 @@ static avifResult avifFillDimgIdxToItemIdxArray(uint32_t * dimgIdxToItemIdx, uin
 }
 
 // Creates the tiles and associate them to the items in the order of the 'dimg' association.
+// Only the cells of the grid selected by info are associated to tiles.
 static avifResult avifDecoderGenerateImageGridTiles(avifDecoder * decoder,
                                                     avifDecoderItem * gridItem,
                                                     avifItemCategory itemCategory,
                                                     const uint32_t * dimgIdxToItemIdx,
-                                                    uint32_t numTiles)
+                                                    uint32_t numTiles,
+                                                    const avifTileInfo * info)
 {
     avifDecoderItem * firstTileItem = NULL;
     avifBool progressive = AVIF_TRUE;
     for (uint32_t dimgIdx = 0; dimgIdx < numTiles; ++dimgIdx) {
+        const uint32_t row = dimgIdx / info->grid.columns;
+        const uint32_t column = dimgIdx % info->grid.columns;
+        if ((row < info->firstGridRow) || (row >= info->firstGridRow + info->gridRowCount) || (column < info->firstGridColumn) ||
+            (column >= info->firstGridColumn + info->gridColumnCount)) {
+            continue;
+        }
         const uint32_t itemIdx = dimgIdxToItemIdx[dimgIdx];
         AVIF_ASSERT_OR_RETURN(itemIdx < gridItem->meta->items.count);
         avifDecoderItem * item = gridItem->meta->items.item[itemIdx];
@@ -1581,6 +1717,10 @@ static avifResult avifDecoderDataAllocateImagePlanes(avifDecoderData * data, con
         dstWidth = tile->width;
         dstHeight = tile->height;
     }
+    if (avifDecoderDataUsesRegionOfInterest(data, tile->input->itemCategory)) {
+        dstWidth = data->regionOfInterest.width;
+        dstHeight = data->regionOfInterest.height;
+    }
 
     const avifBool alpha = avifIsAlpha(tile->input->itemCategory);
     if (alpha) {
@@ -1631,11 +1771,13 @@ static avifResult avifDecoderDataAllocateImagePlanes(avifDecoderData * data, con
 
 // Copies over the pixels from the tile into dstImage.
 // Verifies that the relevant properties of the tile match those of the first tile in case of a grid.
+// May be called concurrently for different tiles of the same grid, hence the separate diag.
 static avifResult avifDecoderDataCopyTileToImage(avifDecoderData * data,
                                                  const avifTileInfo * info,
                                                  avifImage * dstImage,
                                                  const avifTile * tile,
-                                                 unsigned int tileIndex)
+                                                 unsigned int tileIndex,
+                                                 avifDiagnostics * diag)
 {
     const avifTile * firstTile = &data->tiles.tile[info->firstTileIndex];
     if (tile != firstTile) {
@@ -1645,7 +1787,7 @@ static avifResult avifDecoderDataCopyTileToImage(avifDecoderData * data,
             (tile->image->yuvRange != firstTile->image->yuvRange) || (tile->image->colorPrimaries != firstTile->image->colorPrimaries) ||
             (tile->image->transferCharacteristics != firstTile->image->transferCharacteristics) ||
             (tile->image->matrixCoefficients != firstTile->image->matrixCoefficients)) {
-            avifDiagnosticsPrintf(data->diag, "Grid image contains mismatched tiles");
+            avifDiagnosticsPrintf(diag, "Grid image contains mismatched tiles");
             return AVIF_RESULT_INVALID_IMAGE_GRID;
         }
     }
@@ -1656,8 +1798,8 @@ static avifResult avifDecoderDataCopyTileToImage(avifDecoderData * data,
     avifImageSetDefaults(&dstView);
     avifCropRect dstViewRect = { 0, 0, firstTile->image->width, firstTile->image->height };
     if (info->grid.rows > 0 && info->grid.columns > 0) {
-        unsigned int rowIndex = tileIndex / info->grid.columns;
-        unsigned int colIndex = tileIndex % info->grid.columns;
+        unsigned int rowIndex = info->firstGridRow + tileIndex / info->gridColumnCount;
+        unsigned int colIndex = info->firstGridColumn + tileIndex % info->gridColumnCount;
         dstViewRect.x = firstTile->image->width * colIndex;
         dstViewRect.y = firstTile->image->height * rowIndex;
         if (dstViewRect.x + dstViewRect.width > info->grid.outputWidth) {
@@ -1667,7 +1809,24 @@ static avifResult avifDecoderDataCopyTileToImage(avifDecoderData * data,
             dstViewRect.height = info->grid.outputHeight - dstViewRect.y;
         }
     }
-    const avifCropRect srcViewRect = { 0, 0, dstViewRect.width, dstViewRect.height };
+    avifCropRect srcViewRect = { 0, 0, dstViewRect.width, dstViewRect.height };
+    if (avifDecoderDataUsesRegionOfInterest(data, tile->input->itemCategory)) {
+        // Only copy the part of the tile within the region of interest, which is the origin of dstImage.
+        const avifCropRect * roi = &data->regionOfInterest;
+        const uint32_t left = AVIF_MAX(dstViewRect.x, roi->x);
+        const uint32_t top = AVIF_MAX(dstViewRect.y, roi->y);
+        const uint32_t right = AVIF_MIN(dstViewRect.x + dstViewRect.width, roi->x + roi->width);
+        const uint32_t bottom = AVIF_MIN(dstViewRect.y + dstViewRect.height, roi->y + roi->height);
+        AVIF_ASSERT_OR_RETURN(left < right && top < bottom);
+        srcViewRect.x = left - dstViewRect.x;
+        srcViewRect.y = top - dstViewRect.y;
+        srcViewRect.width = right - left;
+        srcViewRect.height = bottom - top;
+        dstViewRect.x = left - roi->x;
+        dstViewRect.y = top - roi->y;
+        dstViewRect.width = srcViewRect.width;
+        dstViewRect.height = srcViewRect.height;
+    }
     AVIF_ASSERT_OR_RETURN(avifImageSetViewRect(&dstView, dstImage, &dstViewRect) == AVIF_RESULT_OK &&
                           avifImageSetViewRect(&srcView, tile->image, &srcViewRect) == AVIF_RESULT_OK);
     avifImageCopySamples(&dstView, &srcView, avifIsAlpha(tile->input->itemCategory) ? AVIF_PLANES_A : AVIF_PLANES_YUV);
@@ -4578,6 +4737,55 @@ static avifBool avifDecoderItemShouldBeSkipped(const avifDecoderItem * item)
            (avifGetCodecType(item->type) == AVIF_CODEC_TYPE_UNKNOWN && memcmp(item->type, "grid", 4)) || item->thumbnailForID != 0;
 }
 
+// Returns the first supported thumbnail item of the primary item, or NULL.
+static avifDecoderItem * avifMetaFindThumbnailItem(avifMeta * meta)
+{
+    for (uint32_t itemIndex = 0; itemIndex < meta->items.count; ++itemIndex) {
+        avifDecoderItem * item = meta->items.item[itemIndex];
+        if ((meta->primaryItemID == 0) || (item->thumbnailForID != meta->primaryItemID) || !item->size ||
+            item->hasUnsupportedEssentialProperty ||
+            (avifGetCodecType(item->type) == AVIF_CODEC_TYPE_UNKNOWN && memcmp(item->type, "grid", 4))) {
+            continue;
+        }
+        return item;
+    }
+    return NULL;
+}
+
+// Sets the width and height of item from its ispe property.
+static avifResult avifDecoderItemHarvestIspe(avifDecoder * decoder, avifDecoderItem * item)
+{
+    avifDiagnostics * diag = decoder->data->diag;
+    const avifProperty * ispeProp = avifPropertyArrayFind(&item->properties, "ispe");
+    if (ispeProp) {
+        item->width = ispeProp->u.ispe.width;
+        item->height = ispeProp->u.ispe.height;
+
+        if ((item->width == 0) || (item->height == 0)) {
+            avifDiagnosticsPrintf(diag, "Item ID [%u] has an invalid size [%ux%u]", item->id, item->width, item->height);
+            return AVIF_RESULT_BMFF_PARSE_FAILED;
+        }
+        if (avifDimensionsTooLarge(item->width, item->height, decoder->imageSizeLimit, decoder->imageDimensionLimit)) {
+            avifDiagnosticsPrintf(diag, "Item ID [%u] dimensions are too large [%ux%u]", item->id, item->width, item->height);
+            return AVIF_RESULT_BMFF_PARSE_FAILED;
+        }
+    } else {
+        const avifProperty * auxCProp = avifPropertyArrayFind(&item->properties, "auxC");
+        if (auxCProp && isAlphaURN(auxCProp->u.auxC.auxType)) {
+            if (decoder->strictFlags & AVIF_STRICT_ALPHA_ISPE_REQUIRED) {
+                avifDiagnosticsPrintf(diag,
+                                      "[Strict] Alpha auxiliary image item ID [%u] is missing a mandatory ispe property",
+                                      item->id);
+                return AVIF_RESULT_BMFF_PARSE_FAILED;
+            }
+        } else {
+            avifDiagnosticsPrintf(diag, "Item ID [%u] is missing a mandatory ispe property", item->id);
+            return AVIF_RESULT_BMFF_PARSE_FAILED;
+        }
+    }
+    return AVIF_RESULT_OK;
+}
+
 avifResult avifDecoderParse(avifDecoder * decoder)
 {
     avifDiagnosticsClearError(&decoder->diag);
@@ -4597,16 +4805,29 @@ avifResult avifDecoderParse(avifDecoder * decoder)
     }
 #endif
 
-    // Cleanup anything lingering in the decoder
+    // Cleanup anything lingering in the decoder, except for the decoder instances which can be reused by this file.
+    avifDecoderData * previousData = decoder->data;
+    decoder->data = NULL;
     avifDecoderCleanup(decoder);
 
     // -----------------------------------------------------------------------
     // Parse BMFF boxes
 
     decoder->data = avifDecoderDataCreate();
+    if (previousData) {
+        if (decoder->data) {
+            // decoder->image was destroyed above so no plane points to a buffer of these codecs anymore.
+            avifDecoderDataReleaseCodecs(previousData);
+            const avifCodecArray idleCodecs = decoder->data->idleCodecs;
+            decoder->data->idleCodecs = previousData->idleCodecs;
+            previousData->idleCodecs = idleCodecs;
+        }
+        avifDecoderDataDestroy(previousData);
+    }
     AVIF_CHECKERR(decoder->data != NULL, AVIF_RESULT_OUT_OF_MEMORY);
     decoder->data->diag = &decoder->diag;
 
+    decoder->thumbnailPresent = AVIF_FALSE;
     AVIF_CHECKRES(avifParse(decoder));
 
     // Walk the decoded items (if any) and harvest ispe
@@ -4616,40 +4837,18 @@ avifResult avifDecoderParse(avifDecoder * decoder)
         if (avifDecoderItemShouldBeSkipped(item)) {
             continue;
         }
-
-        const avifProperty * ispeProp = avifPropertyArrayFind(&item->properties, "ispe");
-        if (ispeProp) {
-            item->width = ispeProp->u.ispe.width;
-            item->height = ispeProp->u.ispe.height;
-
-            if ((item->width == 0) || (item->height == 0)) {
-                avifDiagnosticsPrintf(data->diag, "Item ID [%u] has an invalid size [%ux%u]", item->id, item->width, item->height);
-                return AVIF_RESULT_BMFF_PARSE_FAILED;
-            }
-            if (avifDimensionsTooLarge(item->width, item->height, decoder->imageSizeLimit, decoder->imageDimensionLimit)) {
-                avifDiagnosticsPrintf(data->diag, "Item ID [%u] dimensions are too large [%ux%u]", item->id, item->width, item->height);
-                return AVIF_RESULT_BMFF_PARSE_FAILED;
-            }
-        } else {
-            const avifProperty * auxCProp = avifPropertyArrayFind(&item->properties, "auxC");
-            if (auxCProp && isAlphaURN(auxCProp->u.auxC.auxType)) {
-                if (decoder->strictFlags & AVIF_STRICT_ALPHA_ISPE_REQUIRED) {
-                    avifDiagnosticsPrintf(data->diag,
-                                          "[Strict] Alpha auxiliary image item ID [%u] is missing a mandatory ispe property",
-                                          item->id);
-                    return AVIF_RESULT_BMFF_PARSE_FAILED;
-                }
-            } else {
-                avifDiagnosticsPrintf(data->diag, "Item ID [%u] is missing a mandatory ispe property", item->id);
-                return AVIF_RESULT_BMFF_PARSE_FAILED;
-            }
-        }
+        AVIF_CHECKRES(avifDecoderItemHarvestIspe(decoder, item));
     }
+    decoder->thumbnailPresent = (avifMetaFindThumbnailItem(data->meta) != NULL);
     return avifDecoderReset(decoder);
 }
 
-static avifResult avifCodecCreateInternal(avifCodecChoice choice, const avifTile * tile, avifDiagnostics * diag, avifCodec ** codec)
+// maxThreads is the number of threads the decoder instance is opened with. It is the share of avifDecoder::maxThreads
+// for that instance when several instances decode concurrently, and cannot change afterwards.
+static avifResult avifCodecCreateInternal(avifDecoder * decoder, const avifTile * tile, int maxThreads, avifCodec ** codec)
 {
+    avifCodecChoice choice = decoder->codecChoice;
+    avifDiagnostics * diag = &decoder->diag;
 #if defined(AVIF_CODEC_AVM)
     // AVIF_CODEC_CHOICE_AUTO leads to AVIF_CODEC_TYPE_AV1 by default. Reroute correctly.
     if (choice == AVIF_CODEC_CHOICE_AUTO && tile->codecType == AVIF_CODEC_TYPE_AV2) {
@@ -4671,11 +4870,28 @@ static avifResult avifCodecCreateInternal(avifCodecChoice choice, const avifTile
         return AVIF_RESULT_DECODE_COLOR_FAILED;
     }
 
+    // Only the samples of a track are decoded in order, one after the other.
+    uint32_t maxFrameDelay = 1;
+    if ((decoder->data->source == AVIF_DECODER_SOURCE_TRACKS) && !tile->input->allLayers) {
+        maxFrameDelay = AVIF_MAX(decoder->maxFrameDelay, 1);
+    }
+
+    // Reuse a decoder instance from a previous file or a previous avifDecoderReset() call if possible.
+    *codec = avifDecoderDataTakeIdleCodec(decoder->data, choice, tile, decoder->imageSizeLimit, maxThreads, maxFrameDelay);
+    if (*codec) {
+        (*codec)->diag = diag;
+        return AVIF_RESULT_OK;
+    }
+
     AVIF_CHECKRES(avifCodecCreate(choice, AVIF_CODEC_FLAG_CAN_DECODE, codec));
     AVIF_CHECKERR(*codec, AVIF_RESULT_OUT_OF_MEMORY);
     (*codec)->diag = diag;
+    (*codec)->imageSizeLimit = decoder->imageSizeLimit;
     (*codec)->operatingPoint = tile->operatingPoint;
     (*codec)->allLayers = tile->input->allLayers;
+    (*codec)->choice = choice;
+    (*codec)->maxThreads = maxThreads;
+    (*codec)->maxFrameDelay = maxFrameDelay;
     return AVIF_RESULT_OK;
 }
 
@@ -4716,6 +4932,22 @@ static avifBool avifTilesCanBeDecodedWithSameCodecInstance(avifDecoderData * dat
     return AVIF_TRUE;
 }
 
+// Returns the number of threads of each decoder instance decoding the tiles of info, so that the instances running
+// concurrently do not use more than avifDecoder::maxThreads threads in total. The next tiles of all categories are
+// decoded concurrently by avifDecoderDecodeCategoriesInParallel(), and the remaining tiles of each grid by
+// avifDecoderDecodeTilesInParallel().
+static int avifDecoderCodecMaxThreads(const avifDecoder * decoder, const avifTileInfo * info)
+{
+    unsigned int categoryCount = 0;
+    for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
+        if (decoder->data->tileInfos[c].tileCount > 0) {
+            ++categoryCount;
+        }
+    }
+    const unsigned int concurrentJobCount = AVIF_MAX(AVIF_MAX(categoryCount, info->parallelJobCount), 1);
+    return AVIF_MAX(decoder->maxThreads / (int)concurrentJobCount, 1);
+}
+
 static avifResult avifDecoderCreateCodecs(avifDecoder * decoder)
 {
     avifDecoderData * data = decoder->data;
@@ -4724,10 +4956,11 @@ static avifResult avifDecoderCreateCodecs(avifDecoder * decoder)
     if (data->source == AVIF_DECODER_SOURCE_TRACKS) {
         // In this case, we will use at most two codec instances (one for the color planes and one for the alpha plane).
         // Gain maps are not supported.
-        AVIF_CHECKRES(avifCodecCreateInternal(decoder->codecChoice, &decoder->data->tiles.tile[0], &decoder->diag, &data->codec));
+        const int maxThreads = avifDecoderCodecMaxThreads(decoder, &data->tileInfos[AVIF_ITEM_COLOR]);
+        AVIF_CHECKRES(avifCodecCreateInternal(decoder, &decoder->data->tiles.tile[0], maxThreads, &data->codec));
         data->tiles.tile[0].codec = data->codec;
         if (data->tiles.count > 1) {
-            AVIF_CHECKRES(avifCodecCreateInternal(decoder->codecChoice, &decoder->data->tiles.tile[1], &decoder->diag, &data->codecAlpha));
+            AVIF_CHECKRES(avifCodecCreateInternal(decoder, &decoder->data->tiles.tile[1], maxThreads, &data->codecAlpha));
             data->tiles.tile[1].codec = data->codecAlpha;
         }
     } else {
@@ -4742,17 +4975,55 @@ static avifResult avifDecoderCreateCodecs(avifDecoder * decoder)
         //     from the decoder, so we cannot use the same decoder for both the color and the alpha planes).
         //   - All tiles have the same type (AV1 or AV2).
         // Otherwise, we will use |tiles.count| decoder instances (one instance for each tile).
+        // When decoding with multiple threads, the tiles of each grid are spread over min(maxThreads, tileCount) worker threads
+        // and thus need at least as many decoder instances.
         avifBool canUseSingleCodecInstance = (data->tiles.count == 1) ||
                                              (decoder->imageCount == 1 && avifTilesCanBeDecodedWithSameCodecInstance(data));
-        if (canUseSingleCodecInstance) {
-            AVIF_CHECKRES(avifCodecCreateInternal(decoder->codecChoice, &decoder->data->tiles.tile[0], &decoder->diag, &data->codec));
+        if (canUseSingleCodecInstance && (data->tiles.count == 1 || decoder->maxThreads < 2)) {
+            AVIF_CHECKRES(avifCodecCreateInternal(decoder, &decoder->data->tiles.tile[0], decoder->maxThreads, &data->codec));
             for (unsigned int i = 0; i < decoder->data->tiles.count; ++i) {
                 decoder->data->tiles.tile[i].codec = data->codec;
             }
+        } else if (canUseSingleCodecInstance) {
+            // Share parallelJobCount decoder instances among the tiles of each grid.
+            for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
+                avifTileInfo * info = &data->tileInfos[c];
+                if (info->tileCount == 0) {
+                    continue;
+                }
+                info->parallelJobCount = AVIF_MIN(info->tileCount, (unsigned int)decoder->maxThreads);
+                const int maxThreads = avifDecoderCodecMaxThreads(decoder, info);
+                const uint32_t firstCodecIndex = data->gridCodecs.count;
+                for (unsigned int j = 0; j < info->parallelJobCount; ++j) {
+                    avifCodec ** codec = (avifCodec **)avifArrayPush(&data->gridCodecs);
+                    AVIF_CHECKERR(codec != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+                    const avifTile * firstTile = &data->tiles.tile[info->firstTileIndex];
+                    const avifResult result = avifCodecCreateInternal(decoder, firstTile, maxThreads, codec);
+                    if (result != AVIF_RESULT_OK) {
+                        avifArrayPop(&data->gridCodecs);
+                        return result;
+                    }
+                }
+                for (unsigned int i = 0; i < info->tileCount; ++i) {
+                    avifTile * tile = &data->tiles.tile[info->firstTileIndex + i];
+                    tile->codec = data->gridCodecs.codec[firstCodecIndex + i % info->parallelJobCount];
+                }
+            }
         } else {
-            for (unsigned int i = 0; i < decoder->data->tiles.count; ++i) {
-                avifTile * tile = &decoder->data->tiles.tile[i];
-                AVIF_CHECKRES(avifCodecCreateInternal(decoder->codecChoice, tile, &decoder->diag, &tile->codec));
+            for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
+                avifTileInfo * info = &data->tileInfos[c];
+                if (info->tileCount == 0) {
+                    continue;
+                }
+                if (decoder->maxThreads > 1) {
+                    // Each tile has its own decoder instance so any tile can be decoded by any worker thread.
+                    info->parallelJobCount = AVIF_MIN(info->tileCount, (unsigned int)decoder->maxThreads);
+                }
+                const int maxThreads = avifDecoderCodecMaxThreads(decoder, info);
+                for (unsigned int i = 0; i < info->tileCount; ++i) {
+                    avifTile * tile = &decoder->data->tiles.tile[info->firstTileIndex + i];
+                    AVIF_CHECKRES(avifCodecCreateInternal(decoder, tile, maxThreads, &tile->codec));
+                }
             }
         }
     }
@@ -4820,6 +5091,17 @@ static avifResult avifMetaFindAlphaItem(avifMeta * meta,
         *isAlphaItemInInput = AVIF_FALSE;
         return AVIF_RESULT_OK;
     }
+    // Reuse the alpha grid item created by a previous call, for example before avifDecoderSetSource() was called. The alpha
+    // tile items are already registered as its tiles.
+    for (uint32_t itemIndex = 0; itemIndex < meta->items.count; ++itemIndex) {
+        avifDecoderItem * item = meta->items.item[itemIndex];
+        if (item->alphaGridForID == colorItem->id) {
+            *alphaItem = item;
+            *isAlphaItemInInput = AVIF_FALSE;
+            alphaInfo->grid = colorInfo->grid;
+            return AVIF_RESULT_OK;
+        }
+    }
     // Keep the same 'dimg' order as it defines where each tile is located in the reconstructed image.
     uint32_t * dimgIdxToAlphaItemIdx = (uint32_t *)avifAlloc(tileCount * sizeof(uint32_t));
     AVIF_CHECKERR(dimgIdxToAlphaItemIdx != NULL, AVIF_RESULT_OUT_OF_MEMORY);
@@ -4888,6 +5170,7 @@ static avifResult avifMetaFindAlphaItem(avifMeta * meta,
         return result;
     }
     memcpy((*alphaItem)->type, "grid", 4); // Make it a grid and register alpha items as its tiles.
+    (*alphaItem)->alphaGridForID = colorItem->id;
     (*alphaItem)->width = colorItem->width;
     (*alphaItem)->height = colorItem->height;
     for (uint32_t dimgIdx = 0; dimgIdx < tileCount; ++dimgIdx) {
@@ -5186,6 +5469,41 @@ static avifResult avifDecoderDataFindSampleTransformImageItem(avifDecoderData *
 }
 #endif // AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM
 
+// Sets the cells of the grid of info that are decoded: all of them, or only those overlapping the region of interest.
+static avifResult avifDecoderSelectGridCells(avifDecoder * decoder,
+                                             avifTileInfo * info,
+                                             const avifDecoderItem * gridItem,
+                                             avifItemCategory itemCategory,
+                                             const uint32_t * dimgIdxToItemIdx)
+{
+    info->firstGridRow = 0;
+    info->firstGridColumn = 0;
+    info->gridRowCount = info->grid.rows;
+    info->gridColumnCount = info->grid.columns;
+    if (!avifDecoderDataUsesRegionOfInterest(decoder->data, itemCategory)) {
+        return AVIF_RESULT_OK;
+    }
+
+    // All cells have the same dimensions, checked once they are decoded. Use the ones of the first cell to locate them.
+    AVIF_ASSERT_OR_RETURN(dimgIdxToItemIdx[0] < gridItem->meta->items.count);
+    const avifDecoderItem * firstCellItem = gridItem->meta->items.item[dimgIdxToItemIdx[0]];
+    if ((firstCellItem->width == 0) || (firstCellItem->height == 0)) {
+        avifDiagnosticsPrintf(&decoder->diag, "Grid image's first tile is missing an ispe property");
+        return AVIF_RESULT_INVALID_IMAGE_GRID;
+    }
+    // The region of interest is only checked to be within the image at the end of avifDecoderReset(), so clamp here.
+    const avifCropRect * roi = &decoder->data->regionOfInterest;
+    const uint32_t lastRow =
+        (uint32_t)AVIF_MIN(((uint64_t)roi->y + roi->height - 1) / firstCellItem->height, info->grid.rows - 1);
+    const uint32_t lastColumn =
+        (uint32_t)AVIF_MIN(((uint64_t)roi->x + roi->width - 1) / firstCellItem->width, info->grid.columns - 1);
+    info->firstGridRow = AVIF_MIN(roi->y / firstCellItem->height, lastRow);
+    info->firstGridColumn = AVIF_MIN(roi->x / firstCellItem->width, lastColumn);
+    info->gridRowCount = lastRow - info->firstGridRow + 1;
+    info->gridColumnCount = lastColumn - info->firstGridColumn + 1;
+    return AVIF_RESULT_OK;
+}
+
 static avifResult avifDecoderGenerateImageTiles(avifDecoder * decoder, avifTileInfo * info, avifDecoderItem * item, avifItemCategory itemCategory)
 {
     const uint32_t previousTileCount = decoder->data->tiles.count;
@@ -5196,7 +5514,10 @@ static avifResult avifDecoderGenerateImageTiles(avifDecoder * decoder, avifTileI
         AVIF_CHECKERR(dimgIdxToItemIdx != NULL, AVIF_RESULT_OUT_OF_MEMORY);
         avifResult result = avifFillDimgIdxToItemIdxArray(dimgIdxToItemIdx, numTiles, item);
         if (result == AVIF_RESULT_OK) {
-            result = avifDecoderGenerateImageGridTiles(decoder, item, itemCategory, dimgIdxToItemIdx, numTiles);
+            result = avifDecoderSelectGridCells(decoder, info, item, itemCategory, dimgIdxToItemIdx);
+        }
+        if (result == AVIF_RESULT_OK) {
+            result = avifDecoderGenerateImageGridTiles(decoder, item, itemCategory, dimgIdxToItemIdx, numTiles, info);
         }
         avifFree(dimgIdxToItemIdx);
         AVIF_CHECKRES(result);
@@ -5259,6 +5580,9 @@ avifResult avifDecoderReset(avifDecoder * decoder)
         memset(&data->tileInfos[c].grid, 0, sizeof(data->tileInfos[c].grid));
     }
     avifDecoderDataClearTiles(data);
+    avifDecoderDataClearFrameCache(data);
+    data->codecImageIndex = -1;
+    data->regionOfInterest = decoder->regionOfInterest;
 
     // Prepare / cleanup decoded image state
     if (decoder->image) {
@@ -5432,11 +5756,21 @@ avifResult avifDecoderReset(avifDecoder * decoder)
             codecType[c] = AVIF_CODEC_TYPE_UNKNOWN;
         }
 
-        // Mandatory primary color item
-        mainItems[AVIF_ITEM_COLOR] = avifMetaFindColorItem(data->meta);
-        if (!mainItems[AVIF_ITEM_COLOR]) {
-            avifDiagnosticsPrintf(&decoder->diag, "Primary item not found");
-            return AVIF_RESULT_MISSING_IMAGE_ITEM;
+        if (data->source == AVIF_DECODER_SOURCE_THUMBNAIL_ITEM) {
+            // The thumbnail item takes the place of the primary color item. Its ispe was not harvested by avifDecoderParse().
+            mainItems[AVIF_ITEM_COLOR] = avifMetaFindThumbnailItem(data->meta);
+            if (!mainItems[AVIF_ITEM_COLOR]) {
+                avifDiagnosticsPrintf(&decoder->diag, "Thumbnail item not found");
+                return AVIF_RESULT_MISSING_IMAGE_ITEM;
+            }
+            AVIF_CHECKRES(avifDecoderItemHarvestIspe(decoder, mainItems[AVIF_ITEM_COLOR]));
+        } else {
+            // Mandatory primary color item
+            mainItems[AVIF_ITEM_COLOR] = avifMetaFindColorItem(data->meta);
+            if (!mainItems[AVIF_ITEM_COLOR]) {
+                avifDiagnosticsPrintf(&decoder->diag, "Primary item not found");
+                return AVIF_RESULT_MISSING_IMAGE_ITEM;
+            }
         }
         AVIF_CHECKRES(avifDecoderItemReadAndParse(decoder,
                                                   mainItems[AVIF_ITEM_COLOR],
@@ -5505,7 +5839,9 @@ avifResult avifDecoderReset(avifDecoder * decoder)
 #if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
         // AVIF_ITEM_SAMPLE_TRANSFORM (not used through mainItems because not a coded item (well grids are not coded items either but it's different)).
         avifDecoderItem * sampleTransformItem = NULL;
-        AVIF_CHECKRES(avifDecoderDataFindSampleTransformImageItem(data, &sampleTransformItem));
+        if (data->source != AVIF_DECODER_SOURCE_THUMBNAIL_ITEM) {
+            AVIF_CHECKRES(avifDecoderDataFindSampleTransformImageItem(data, &sampleTransformItem));
+        }
         if (sampleTransformItem != NULL) {
             AVIF_ASSERT_OR_RETURN(data->sampleTransformNumInputImageItems == 0);
             uint32_t numExtraInputImageItems = 0;
@@ -5591,7 +5927,8 @@ avifResult avifDecoderReset(avifDecoder * decoder)
 #endif // AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM
 
         // Find Exif and/or XMP metadata, if any
-        AVIF_CHECKRES(avifDecoderFindMetadata(decoder, data->meta, decoder->image, mainItems[AVIF_ITEM_COLOR]->id));
+        // The Exif and XMP of the primary item also describe its thumbnail.
+        AVIF_CHECKRES(avifDecoderFindMetadata(decoder, data->meta, decoder->image, data->meta->primaryItemID));
 
         // Set all counts and timing to safe-but-uninteresting values
         decoder->imageIndex = -1;
@@ -5767,6 +6104,23 @@ avifResult avifDecoderReset(avifDecoder * decoder)
 
     AVIF_CHECKRES(avifReadCodecConfigProperty(decoder->image, colorProperties, colorCodecType));
 
+    if (avifDecoderDataUsesRegionOfInterest(data, AVIF_ITEM_COLOR)) {
+        const avifCropRect * roi = &data->regionOfInterest;
+        avifPixelFormatInfo formatInfo;
+        avifGetPixelFormatInfo(decoder->image->yuvFormat, &formatInfo);
+        if ((roi->width > decoder->image->width) || (roi->height > decoder->image->height) ||
+            (roi->x > decoder->image->width - roi->width) || (roi->y > decoder->image->height - roi->height)) {
+            avifDiagnosticsPrintf(&decoder->diag, "The region of interest is not within the image");
+            return AVIF_RESULT_INVALID_ARGUMENT;
+        }
+        if (!formatInfo.monochrome && ((roi->x & formatInfo.chromaShiftX) || (roi->y & formatInfo.chromaShiftY))) {
+            avifDiagnosticsPrintf(&decoder->diag, "The region of interest is not aligned with the chroma subsampling");
+            return AVIF_RESULT_INVALID_ARGUMENT;
+        }
+        // This is the size of the image output by avifDecoderNextImage().
+        decoder->image->width = roi->width;
+        decoder->image->height = roi->height;
+    }
     return AVIF_RESULT_OK;
 }
 
@@ -5784,6 +6138,22 @@ static avifResult avifDecoderPrepareTiles(avifDecoder * decoder, uint32_t nextIm
         if (prepareResult != AVIF_RESULT_OK) {
             return prepareResult;
         }
+
+        if (tile->codec && (tile->codec->maxFrameDelay > 1)) {
+            // Read the following samples ahead of time so that the codec can keep several frames in flight.
+            // Missing data is not an error here; it only limits how many frames can be in flight.
+            uint32_t lookaheadSampleCount = 0;
+            while ((lookaheadSampleCount + 1 < tile->codec->maxFrameDelay) &&
+                   (nextImageIndex + 1 + lookaheadSampleCount < tile->input->samples.count)) {
+                avifDecodeSample * lookaheadSample = &tile->input->samples.sample[nextImageIndex + 1 + lookaheadSampleCount];
+                if ((avifDecoderPrepareSample(decoder, lookaheadSample, 0) != AVIF_RESULT_OK) || lookaheadSample->partialData) {
+                    break;
+                }
+                ++lookaheadSampleCount;
+            }
+            tile->codec->lookaheadSamples = (lookaheadSampleCount > 0) ? &tile->input->samples.sample[nextImageIndex + 1] : NULL;
+            tile->codec->lookaheadSampleCount = lookaheadSampleCount;
+        }
     }
     return AVIF_RESULT_OK;
 }
@@ -5845,74 +6215,277 @@ static avifResult avifGetErrorForItemCategory(avifItemCategory itemCategory)
     return avifIsAlpha(itemCategory) ? AVIF_RESULT_DECODE_ALPHA_FAILED : AVIF_RESULT_DECODE_COLOR_FAILED;
 }
 
-static avifResult avifDecoderDecodeTiles(avifDecoder * decoder, uint32_t nextImageIndex, avifTileInfo * info)
+// Decodes the sample of the tile and converts the output to the tile's dimensions and to full range alpha if needed.
+// diag is passed separately because this may be called concurrently for different tiles of a grid.
+static avifResult avifDecoderDecodeTile(avifDecoder * decoder,
+                                        avifTile * tile,
+                                        const avifDecodeSample * sample,
+                                        avifDiagnostics * diag)
 {
-    const unsigned int oldDecodedTileCount = info->decodedTileCount;
-    for (unsigned int tileIndex = oldDecodedTileCount; tileIndex < info->tileCount; ++tileIndex) {
+    avifBool isLimitedRangeAlpha = AVIF_FALSE;
+    tile->codec->diag = diag;
+    tile->codec->imageSizeLimit = decoder->imageSizeLimit;
+    const avifBool alpha = avifIsAlpha(tile->input->itemCategory);
+    if (!tile->codec->getNextImage(tile->codec, sample, alpha, &isLimitedRangeAlpha, tile->image)) {
+        avifDiagnosticsPrintf(diag, "tile->codec->getNextImage() failed");
+        return avifGetErrorForItemCategory(tile->input->itemCategory);
+    }
+
+    // Section 2.3.4 of AV1 Codec ISO Media File Format Binding v1.2.0 says:
+    //   the full_range_flag in the colr box shall match the color_range
+    //   flag in the Sequence Header OBU.
+    // See https://aomediacodec.github.io/av1-isobmff/v1.2.0.html#av1codecconfigurationbox-semantics.
+    // If a 'colr' box of colour_type 'nclx' was parsed, a mismatch between
+    // the 'colr' decoder->image->yuvRange and the AV1 OBU
+    // tile->image->yuvRange should be treated as an error.
+    // However codec_svt.c was not encoding the color_range field for
+    // multiple years, so there probably are files in the wild that will
+    // fail decoding if this is enforced. Thus this pattern is allowed.
+    // Section 12.1.5.1 of ISO 14496-12 (ISOBMFF) says:
+    //   If colour information is supplied in both this [colr] box, and also
+    //   in the video bitstream, this box takes precedence, and over-rides
+    //   the information in the bitstream.
+    // So decoder->image->yuvRange is kept because it was either the 'colr'
+    // value set when the 'colr' box was parsed, or it was the AV1 OBU value
+    // extracted from the sequence header OBU of the first tile of the first
+    // frame (if no 'colr' box of colour_type 'nclx' was found).
+
+    // Alpha plane with limited range is not allowed by the latest revision
+    // of the specification. However, it was allowed in version 1.0.0 of the
+    // specification. To allow such files, simply convert the alpha plane to
+    // full range.
+    if (alpha && isLimitedRangeAlpha) {
+        avifResult result = avifImageLimitedToFullAlpha(tile->image);
+        if (result != AVIF_RESULT_OK) {
+            avifDiagnosticsPrintf(diag, "avifImageLimitedToFullAlpha failed");
+            return result;
+        }
+    }
+
+    // Scale the decoded image so that it corresponds to this tile's output dimensions
+    if ((tile->width != tile->image->width) || (tile->height != tile->image->height)) {
+        if (avifImageScaleWithLimit(tile->image,
+                                    tile->width,
+                                    tile->height,
+                                    decoder->imageSizeLimit,
+                                    decoder->imageDimensionLimit,
+                                    diag) != AVIF_RESULT_OK) {
+            return avifGetErrorForItemCategory(tile->input->itemCategory);
+        }
+    }
+    return AVIF_RESULT_OK;
+}
+
+// Returns the image the tiles of the given item category are copied or moved to, or NULL if there is none.
+static avifImage * avifDecoderGetCategoryImage(avifDecoder * decoder, avifItemCategory itemCategory)
+{
+#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
+    if (itemCategory == AVIF_ITEM_GAIN_MAP) {
+        return decoder->image->gainMap ? decoder->image->gainMap->image : NULL;
+    }
+#else
+    (void)itemCategory;
+#endif
+    return decoder->image;
+}
+
+typedef struct avifTileDecodeJob
+{
+    avifDecoder * decoder;
+    const avifTileInfo * info;
+    uint32_t imageIndex;
+    unsigned int firstTileIndex; // Relative to info->firstTileIndex.
+    unsigned int endTileIndex;   // Exclusive.
+    unsigned int tileIndexStep;
+    avifBool copyToImage; // If false, the decoded tiles are left in avifTile::image.
+    avifDiagnostics diag;
+    avifResult result;
+} avifTileDecodeJob;
+
+static void avifDecoderDecodeTilesWorker(void * arg)
+{
+    avifTileDecodeJob * job = (avifTileDecodeJob *)arg;
+    avifDecoder * decoder = job->decoder;
+    const avifTileInfo * info = job->info;
+    for (unsigned int tileIndex = job->firstTileIndex; tileIndex < job->endTileIndex; tileIndex += job->tileIndexStep) {
         avifTile * tile = &decoder->data->tiles.tile[info->firstTileIndex + tileIndex];
+        const avifDecodeSample * sample = &tile->input->samples.sample[job->imageIndex];
+        job->result = avifDecoderDecodeTile(decoder, tile, sample, &job->diag);
+        if (job->result != AVIF_RESULT_OK) {
+            return;
+        }
+        if (!job->copyToImage) {
+            continue;
+        }
+#if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
+        if (tile->input->itemCategory >= AVIF_SAMPLE_TRANSFORM_MIN_CATEGORY &&
+            tile->input->itemCategory <= AVIF_SAMPLE_TRANSFORM_MAX_CATEGORY) {
+            // Keep Sample Transform input image item samples in tiles. See avifDecoderDecodeTiles().
+            continue;
+        }
+#endif
+        avifImage * dstImage = avifDecoderGetCategoryImage(decoder, tile->input->itemCategory);
+        if (dstImage == NULL) {
+            job->result = AVIF_RESULT_UNKNOWN_ERROR;
+            return;
+        }
+        // Each tile is copied to a distinct area of dstImage so there is no need to synchronize the workers.
+        job->result = avifDecoderDataCopyTileToImage(decoder->data, info, dstImage, tile, tileIndex, &job->diag);
+        if (job->result != AVIF_RESULT_OK) {
+            return;
+        }
+    }
+}
+
+// Runs the jobs concurrently, on decoder->threadPool if any, or on short-lived threads otherwise.
+static avifResult avifDecoderRunTileDecodeJobs(avifDecoder * decoder, avifTileDecodeJob * jobs, unsigned int jobCount)
+{
+    avifResult result = AVIF_RESULT_OK;
+    if (!avifRunInParallel(decoder->threadPool, avifDecoderDecodeTilesWorker, jobs, sizeof(avifTileDecodeJob), jobCount)) {
+        result = AVIF_RESULT_UNKNOWN_ERROR;
+    }
+    for (unsigned int i = 0; i < jobCount; ++i) {
+        avifTileDecodeJob * job = &jobs[i];
+        if (result == AVIF_RESULT_OK && job->result != AVIF_RESULT_OK) {
+            result = job->result;
+            if (*job->diag.error) {
+                avifDiagnosticsPrintf(&decoder->diag, "%s", job->diag.error);
+            }
+        }
+        // The job diagnostics are about to be freed.
+        for (unsigned int tileIndex = job->firstTileIndex; tileIndex < job->endTileIndex; tileIndex += job->tileIndexStep) {
+            decoder->data->tiles.tile[job->info->firstTileIndex + tileIndex].codec->diag = &decoder->diag;
+        }
+    }
+    return result;
+}
 
+// Decodes the remaining grid tiles whose data is available, using info->parallelJobCount threads.
+// The first tile must have been decoded and dstImage allocated already.
+static avifResult avifDecoderDecodeTilesInParallel(avifDecoder * decoder, uint32_t nextImageIndex, avifTileInfo * info)
+{
+    AVIF_ASSERT_OR_RETURN(info->decodedTileCount > 0 && info->parallelJobCount > 1);
+    // Stop at the first tile with missing data so that the decoded tiles remain contiguous.
+    unsigned int endTileIndex = info->decodedTileCount;
+    for (; endTileIndex < info->tileCount; ++endTileIndex) {
+        const avifTile * tile = &decoder->data->tiles.tile[info->firstTileIndex + endTileIndex];
         const avifDecodeSample * sample = &tile->input->samples.sample[nextImageIndex];
         if (sample->data.size < sample->size) {
             AVIF_ASSERT_OR_RETURN(decoder->allowIncremental);
-            // Data is missing but there is no error yet. Output available pixel rows.
-            return AVIF_RESULT_OK;
+            break;
         }
+    }
+    if (endTileIndex == info->decodedTileCount) {
+        // Data is missing but there is no error yet. Output available pixel rows.
+        return AVIF_RESULT_OK;
+    }
 
-        avifBool isLimitedRangeAlpha = AVIF_FALSE;
-        tile->codec->maxThreads = decoder->maxThreads;
-        tile->codec->imageSizeLimit = decoder->imageSizeLimit;
-        if (!tile->codec->getNextImage(tile->codec, sample, avifIsAlpha(tile->input->itemCategory), &isLimitedRangeAlpha, tile->image)) {
-            avifDiagnosticsPrintf(&decoder->diag, "tile->codec->getNextImage() failed");
-            return avifGetErrorForItemCategory(tile->input->itemCategory);
+    const unsigned int jobCount = info->parallelJobCount;
+    avifTileDecodeJob * jobs = (avifTileDecodeJob *)avifAlloc(sizeof(avifTileDecodeJob) * jobCount);
+    AVIF_CHECKERR(jobs != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+    memset(jobs, 0, sizeof(avifTileDecodeJob) * jobCount);
+    for (unsigned int i = 0; i < jobCount; ++i) {
+        avifTileDecodeJob * job = &jobs[i];
+        job->decoder = decoder;
+        job->info = info;
+        job->imageIndex = nextImageIndex;
+        // The tile at index t must be decoded by the job at index (t % jobCount). See avifTileInfo::parallelJobCount.
+        job->firstTileIndex = info->decodedTileCount + (i + jobCount - info->decodedTileCount % jobCount) % jobCount;
+        job->endTileIndex = endTileIndex;
+        job->tileIndexStep = jobCount;
+        job->copyToImage = AVIF_TRUE;
+        job->result = AVIF_RESULT_OK;
+    }
+    const avifResult result = avifDecoderRunTileDecodeJobs(decoder, jobs, jobCount);
+    avifFree(jobs);
+    AVIF_CHECKRES(result);
+    info->decodedTileCount = endTileIndex;
+    return AVIF_RESULT_OK;
+}
+
+// Decodes the next tile of each item category (color, alpha, gain map etc.) concurrently, if the categories use
+// distinct codec instances. Only the decoding itself is done concurrently: the decoded tiles are left in avifTile::image
+// and tileDecoded[c] is set to AVIF_TRUE, for avifDecoderDecodeTiles() to copy or move them to decoder->image later.
+static avifResult avifDecoderDecodeCategoriesInParallel(avifDecoder * decoder,
+                                                        uint32_t nextImageIndex,
+                                                        avifBool tileDecoded[AVIF_ITEM_CATEGORY_COUNT])
+{
+    for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
+        tileDecoded[c] = AVIF_FALSE;
+    }
+    avifDecoderData * data = decoder->data;
+    if (decoder->maxThreads < 2 || (data->source != AVIF_DECODER_SOURCE_TRACKS && data->codec != NULL)) {
+        // Single thread, or a single codec instance shared by all categories.
+        return AVIF_RESULT_OK;
+    }
+
+    avifTileDecodeJob jobs[AVIF_ITEM_CATEGORY_COUNT];
+    avifItemCategory jobCategories[AVIF_ITEM_CATEGORY_COUNT];
+    unsigned int jobCount = 0;
+    for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
+        const avifTileInfo * info = &data->tileInfos[c];
+        if (info->decodedTileCount == info->tileCount || (info->decodedTileCount > 0 && info->parallelJobCount > 1)) {
+            // Nothing to decode, or the remaining grid tiles are decoded by avifDecoderDecodeTilesInParallel().
+            continue;
+        }
+        const avifTile * tile = &data->tiles.tile[info->firstTileIndex + info->decodedTileCount];
+        const avifDecodeSample * sample = &tile->input->samples.sample[nextImageIndex];
+        if (sample->data.size < sample->size) {
+            continue;
         }
+        avifTileDecodeJob * job = &jobs[jobCount];
+        memset(job, 0, sizeof(*job));
+        job->decoder = decoder;
+        job->info = info;
+        job->imageIndex = nextImageIndex;
+        job->firstTileIndex = info->decodedTileCount;
+        job->endTileIndex = info->decodedTileCount + 1;
+        job->tileIndexStep = 1;
+        job->copyToImage = AVIF_FALSE;
+        job->result = AVIF_RESULT_OK;
+        jobCategories[jobCount] = (avifItemCategory)c;
+        ++jobCount;
+    }
+    if (jobCount < 2) {
+        return AVIF_RESULT_OK;
+    }
+    AVIF_CHECKRES(avifDecoderRunTileDecodeJobs(decoder, jobs, jobCount));
+    for (unsigned int i = 0; i < jobCount; ++i) {
+        tileDecoded[jobCategories[i]] = AVIF_TRUE;
+    }
+    return AVIF_RESULT_OK;
+}
 
-        // Section 2.3.4 of AV1 Codec ISO Media File Format Binding v1.2.0 says:
-        //   the full_range_flag in the colr box shall match the color_range
-        //   flag in the Sequence Header OBU.
-        // See https://aomediacodec.github.io/av1-isobmff/v1.2.0.html#av1codecconfigurationbox-semantics.
-        // If a 'colr' box of colour_type 'nclx' was parsed, a mismatch between
-        // the 'colr' decoder->image->yuvRange and the AV1 OBU
-        // tile->image->yuvRange should be treated as an error.
-        // However codec_svt.c was not encoding the color_range field for
-        // multiple years, so there probably are files in the wild that will
-        // fail decoding if this is enforced. Thus this pattern is allowed.
-        // Section 12.1.5.1 of ISO 14496-12 (ISOBMFF) says:
-        //   If colour information is supplied in both this [colr] box, and also
-        //   in the video bitstream, this box takes precedence, and over-rides
-        //   the information in the bitstream.
-        // So decoder->image->yuvRange is kept because it was either the 'colr'
-        // value set when the 'colr' box was parsed, or it was the AV1 OBU value
-        // extracted from the sequence header OBU of the first tile of the first
-        // frame (if no 'colr' box of colour_type 'nclx' was found).
-
-        // Alpha plane with limited range is not allowed by the latest revision
-        // of the specification. However, it was allowed in version 1.0.0 of the
-        // specification. To allow such files, simply convert the alpha plane to
-        // full range.
-        if (avifIsAlpha(tile->input->itemCategory) && isLimitedRangeAlpha) {
-            avifResult result = avifImageLimitedToFullAlpha(tile->image);
-            if (result != AVIF_RESULT_OK) {
-                avifDiagnosticsPrintf(&decoder->diag, "avifImageLimitedToFullAlpha failed");
-                return result;
-            }
+// If nextTileDecoded is true, the tile at index info->decodedTileCount was already decoded by
+// avifDecoderDecodeCategoriesInParallel() and only needs to be copied or moved to decoder->image.
+static avifResult avifDecoderDecodeTiles(avifDecoder * decoder,
+                                         uint32_t nextImageIndex,
+                                         avifTileInfo * info,
+                                         avifBool nextTileDecoded)
+{
+    const unsigned int oldDecodedTileCount = info->decodedTileCount;
+    for (unsigned int tileIndex = oldDecodedTileCount; tileIndex < info->tileCount; ++tileIndex) {
+        if (tileIndex > 0 && info->parallelJobCount > 1) {
+            // The first tile was decoded and the grid image was allocated, so the remaining tiles are independent.
+            AVIF_ASSERT_OR_RETURN(!nextTileDecoded || tileIndex != oldDecodedTileCount);
+            return avifDecoderDecodeTilesInParallel(decoder, nextImageIndex, info);
         }
+        avifTile * tile = &decoder->data->tiles.tile[info->firstTileIndex + tileIndex];
 
-        // Scale the decoded image so that it corresponds to this tile's output dimensions
-        if ((tile->width != tile->image->width) || (tile->height != tile->image->height)) {
-            if (avifImageScaleWithLimit(tile->image,
-                                        tile->width,
-                                        tile->height,
-                                        decoder->imageSizeLimit,
-                                        decoder->imageDimensionLimit,
-                                        &decoder->diag) != AVIF_RESULT_OK) {
-                return avifGetErrorForItemCategory(tile->input->itemCategory);
+        if (!nextTileDecoded || tileIndex != oldDecodedTileCount) {
+            const avifDecodeSample * sample = &tile->input->samples.sample[nextImageIndex];
+            if (sample->data.size < sample->size) {
+                AVIF_ASSERT_OR_RETURN(decoder->allowIncremental);
+                // Data is missing but there is no error yet. Output available pixel rows.
+                return AVIF_RESULT_OK;
             }
+
+            AVIF_CHECKRES(avifDecoderDecodeTile(decoder, tile, sample, &decoder->diag));
         }
 
         ++info->decodedTileCount;
-
         const avifBool isGrid = (info->grid.rows > 0) && (info->grid.columns > 0);
-        avifBool stealPlanes = !isGrid;
+        avifBool stealPlanes = !isGrid && !avifDecoderDataUsesRegionOfInterest(decoder->data, tile->input->itemCategory);
 #if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
         if (decoder->data->meta->sampleTransformExpression.count > 0) {
             // Keep everything as a copy for now.
@@ -5927,17 +6500,12 @@ static avifResult avifDecoderDecodeTiles(avifDecoder * decoder, uint32_t nextIma
 #endif
 
         if (!stealPlanes) {
-            avifImage * dstImage = decoder->image;
-#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
-            if (tile->input->itemCategory == AVIF_ITEM_GAIN_MAP) {
-                AVIF_ASSERT_OR_RETURN(dstImage->gainMap && dstImage->gainMap->image);
-                dstImage = dstImage->gainMap->image;
-            }
-#endif
+            avifImage * dstImage = avifDecoderGetCategoryImage(decoder, tile->input->itemCategory);
+            AVIF_ASSERT_OR_RETURN(dstImage != NULL);
             if (tileIndex == 0) {
                 AVIF_CHECKRES(avifDecoderDataAllocateImagePlanes(decoder->data, info, dstImage));
             }
-            AVIF_CHECKRES(avifDecoderDataCopyTileToImage(decoder->data, info, dstImage, tile, tileIndex));
+            AVIF_CHECKRES(avifDecoderDataCopyTileToImage(decoder->data, info, dstImage, tile, tileIndex, &decoder->diag));
         } else {
             AVIF_ASSERT_OR_RETURN(info->tileCount == 1);
             AVIF_ASSERT_OR_RETURN(tileIndex == 0);
@@ -6052,7 +6620,176 @@ static avifResult avifDecoderApplySampleTransform(const avifDecoder * decoder, a
 }
 #endif // AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM
 
+static avifBool avifDecoderFrameCacheEnabled(const avifDecoder * decoder)
+{
+    return (decoder->frameCacheBytes > 0) && (decoder->data->source == AVIF_DECODER_SOURCE_TRACKS);
+}
+
+// Returns AVIF_TRUE if no frame is partially decoded.
+static avifBool avifDecoderDataAtFrameBoundary(const avifDecoderData * data)
+{
+    if (avifDecoderDataFrameFullyDecoded(data)) {
+        return AVIF_TRUE;
+    }
+    for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
+        if (data->tileInfos[c].decodedTileCount != 0) {
+            return AVIF_FALSE;
+        }
+    }
+    return AVIF_TRUE;
+}
+
+static size_t avifImagePlanesSize(const avifImage * image)
+{
+    size_t size = 0;
+    for (int c = AVIF_CHAN_Y; c <= AVIF_CHAN_A; ++c) {
+        size += (size_t)avifImagePlaneRowBytes(image, c) * avifImagePlaneHeight(image, c);
+    }
+    return size;
+}
+
+// Stores a copy of decoder->image as the frame at decoder->imageIndex in decoder->data->frameCache, evicting the least
+// recently used frames if needed.
+static avifResult avifDecoderCacheFrame(avifDecoder * decoder)
+{
+    avifDecoderData * data = decoder->data;
+    for (uint32_t i = 0; i < data->frameCache.count; ++i) {
+        if (data->frameCache.frame[i].frameIndex == (uint32_t)decoder->imageIndex) {
+            // Decoded again while seeking.
+            data->frameCache.frame[i].lastUse = ++data->frameCacheClock;
+            return AVIF_RESULT_OK;
+        }
+    }
+
+    const size_t size = avifImagePlanesSize(decoder->image);
+    if (size > decoder->frameCacheBytes) {
+        return AVIF_RESULT_OK;
+    }
+    while (data->frameCacheSize + size > decoder->frameCacheBytes) {
+        uint32_t lruIndex = 0;
+        for (uint32_t i = 1; i < data->frameCache.count; ++i) {
+            if (data->frameCache.frame[i].lastUse < data->frameCache.frame[lruIndex].lastUse) {
+                lruIndex = i;
+            }
+        }
+        AVIF_ASSERT_OR_RETURN(lruIndex < data->frameCache.count);
+        avifCachedFrame * lruFrame = &data->frameCache.frame[lruIndex];
+        avifImageDestroy(lruFrame->image);
+        data->frameCacheSize -= lruFrame->size;
+        *lruFrame = data->frameCache.frame[data->frameCache.count - 1];
+        --data->frameCache.count;
+    }
+
+    avifImage * image = avifImageCreateEmpty();
+    AVIF_CHECKERR(image != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+    const avifResult copyResult = avifImageCopy(image, decoder->image, AVIF_PLANES_ALL);
+    if (copyResult != AVIF_RESULT_OK) {
+        avifImageDestroy(image);
+        return copyResult;
+    }
+    avifCachedFrame * frame = (avifCachedFrame *)avifArrayPush(&data->frameCache);
+    if (frame == NULL) {
+        avifImageDestroy(image);
+        return AVIF_RESULT_OUT_OF_MEMORY;
+    }
+    frame->frameIndex = (uint32_t)decoder->imageIndex;
+    frame->image = image;
+    frame->size = size;
+    frame->lastUse = ++data->frameCacheClock;
+    data->frameCacheSize += size;
+    return AVIF_RESULT_OK;
+}
+
+// Copies the frame at frameIndex from decoder->data->frameCache to decoder->image, if present. The codec instances are
+// left untouched, so decoder->data->codecImageIndex no longer matches decoder->imageIndex.
+static avifResult avifDecoderRestoreCachedFrame(avifDecoder * decoder, uint32_t frameIndex, avifBool * restored)
+{
+    *restored = AVIF_FALSE;
+    avifDecoderData * data = decoder->data;
+    for (uint32_t i = 0; i < data->frameCache.count; ++i) {
+        avifCachedFrame * frame = &data->frameCache.frame[i];
+        if (frame->frameIndex != frameIndex) {
+            continue;
+        }
+        AVIF_CHECKRES(avifImageCopy(decoder->image, frame->image, AVIF_PLANES_ALL));
+        frame->lastUse = ++data->frameCacheClock;
+        // For avifDecoderDecodedRowCount() and the next avifDecoderNextImage() call.
+        for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
+            data->tileInfos[c].decodedTileCount = data->tileInfos[c].tileCount;
+        }
+        decoder->imageIndex = (int)frameIndex;
+        AVIF_CHECKRES(avifDecoderNthImageTiming(decoder, frameIndex, &decoder->imageTiming));
+        *restored = AVIF_TRUE;
+        return AVIF_RESULT_OK;
+    }
+    return AVIF_RESULT_OK;
+}
+
+static avifResult avifDecoderDecodeNextImage(avifDecoder * decoder);
+
+// Decodes the frames needed for the codec instances to decode frameIndex next, when frames restored from
+// decoder->data->frameCache left them behind or ahead of decoder->imageIndex. decoder->imageIndex is moved along with
+// the decoded frames.
+static avifResult avifDecoderSeekCodecs(avifDecoder * decoder, uint32_t frameIndex)
+{
+    avifDecoderData * data = decoder->data;
+    const int nearestKeyFrame = (int)avifDecoderNearestKeyframe(decoder, frameIndex);
+    if ((nearestKeyFrame > (data->codecImageIndex + 1)) || (data->codecImageIndex >= (int)frameIndex)) {
+        avifDecoderDataResetCodec(data);
+        decoder->imageIndex = nearestKeyFrame - 1;
+        data->codecImageIndex = decoder->imageIndex;
+    } else {
+        decoder->imageIndex = data->codecImageIndex;
+    }
+    while ((decoder->imageIndex + 1) < (int)frameIndex) {
+        AVIF_CHECKRES(avifDecoderDecodeNextImage(decoder));
+    }
+    return AVIF_RESULT_OK;
+}
+
+// Decodes frameIndex with the codec instances, starting from wherever they are. The frames in between are decoded once
+// and are not restored from decoder->data->frameCache, because the codec instances need them anyway.
+// decoder->imageIndex and decoder->imageTiming are only changed once frameIndex is decoded, so that the call can be
+// retried after AVIF_RESULT_WAITING_ON_IO or any other failure. decoder->data->codecImageIndex keeps track of the
+// progress made in between.
+static avifResult avifDecoderDecodeFrameFromCodecs(avifDecoder * decoder, uint32_t frameIndex)
+{
+    const int imageIndex = decoder->imageIndex;
+    const avifImageTiming imageTiming = decoder->imageTiming;
+    avifResult result = avifDecoderSeekCodecs(decoder, frameIndex);
+    if (result == AVIF_RESULT_OK) {
+        result = avifDecoderDecodeNextImage(decoder);
+    }
+    if (result != AVIF_RESULT_OK) {
+        decoder->imageIndex = imageIndex;
+        decoder->imageTiming = imageTiming;
+    }
+    return result;
+}
+
 avifResult avifDecoderNextImage(avifDecoder * decoder)
+{
+    avifDecoderData * data = decoder->data;
+    if (data && (data->tiles.count > 0) && avifDecoderFrameCacheEnabled(decoder) &&
+        ((decoder->imageIndex + 1) < decoder->imageCount)) {
+        avifDiagnosticsClearError(&decoder->diag);
+        const uint32_t nextImageIndex = (uint32_t)(decoder->imageIndex + 1);
+        if (avifDecoderDataAtFrameBoundary(data)) {
+            avifBool restored;
+            AVIF_CHECKRES(avifDecoderRestoreCachedFrame(decoder, nextImageIndex, &restored));
+            if (restored) {
+                return AVIF_RESULT_OK;
+            }
+        }
+        if (data->codecImageIndex != decoder->imageIndex) {
+            // A partially decoded frame, if any, is the one following data->codecImageIndex.
+            return avifDecoderDecodeFrameFromCodecs(decoder, nextImageIndex);
+        }
+    }
+    return avifDecoderDecodeNextImage(decoder);
+}
+
+static avifResult avifDecoderDecodeNextImage(avifDecoder * decoder)
 {
     avifDiagnosticsClearError(&decoder->diag);
 
@@ -6097,8 +6834,11 @@ avifResult avifDecoderNextImage(avifDecoder * decoder)
     // encoder's choice, and decoding as many as possible of each category in parallel is beneficial
     // for incremental decoding, as pixel rows need all channels to be decoded before being
     // accessible to the user.
+    // If multithreading is enabled, the next tile of each category is decoded concurrently first.
+    avifBool nextTileDecoded[AVIF_ITEM_CATEGORY_COUNT];
+    AVIF_CHECKRES(avifDecoderDecodeCategoriesInParallel(decoder, nextImageIndex, nextTileDecoded));
     for (int c = 0; c < AVIF_ITEM_CATEGORY_COUNT; ++c) {
-        AVIF_CHECKRES(avifDecoderDecodeTiles(decoder, nextImageIndex, &decoder->data->tileInfos[c]));
+        AVIF_CHECKRES(avifDecoderDecodeTiles(decoder, nextImageIndex, &decoder->data->tileInfos[c], nextTileDecoded[c]));
     }
 
     if (!avifDecoderDataFrameFullyDecoded(decoder->data)) {
@@ -6131,6 +6871,7 @@ avifResult avifDecoderNextImage(avifDecoder * decoder)
     // avifDecoderNthImage(decoder, decoder->imageIndex + 1) is equivalent to avifDecoderNextImage(decoder)
     // if the previous call to avifDecoderNextImage() returned AVIF_RESULT_WAITING_ON_IO.
     decoder->imageIndex = (int)nextImageIndex;
+    decoder->data->codecImageIndex = decoder->imageIndex;
     // The decoded tile counts will be reset to 0 the next time avifDecoderNextImage() is called,
     // for avifDecoderDecodedRowCount() to work until then.
     if (decoder->data->sourceSampleTable) {
@@ -6141,6 +6882,9 @@ avifResult avifDecoderNextImage(avifDecoder * decoder)
             return timingResult;
         }
     }
+    if (avifDecoderFrameCacheEnabled(decoder)) {
+        AVIF_CHECKRES(avifDecoderCacheFrame(decoder));
+    }
     return AVIF_RESULT_OK;
 }
 
@@ -6211,6 +6955,17 @@ avifResult avifDecoderNthImage(avifDecoder * decoder, uint32_t frameIndex)
         // the nearest key frame.
     }
 
+    if (avifDecoderFrameCacheEnabled(decoder)) {
+        if (avifDecoderDataAtFrameBoundary(decoder->data)) {
+            avifBool restored;
+            AVIF_CHECKRES(avifDecoderRestoreCachedFrame(decoder, frameIndex, &restored));
+            if (restored) {
+                return AVIF_RESULT_OK;
+            }
+        }
+        return avifDecoderDecodeFrameFromCodecs(decoder, frameIndex);
+    }
+
     int nearestKeyFrame = (int)avifDecoderNearestKeyframe(decoder, frameIndex);
     if ((nearestKeyFrame > (decoder->imageIndex + 1)) || (requestedIndex <= decoder->imageIndex)) {
         // If we get here, we need to start decoding from the nearest key frame.
@@ -6219,6 +6974,7 @@ avifResult avifDecoderNthImage(avifDecoder * decoder, uint32_t frameIndex)
         // avifDecoderNextImage().
         decoder->imageIndex = nearestKeyFrame - 1; // prepare to read nearest keyframe
         avifDecoderDataResetCodec(decoder->data);
+        decoder->data->codecImageIndex = decoder->imageIndex;
     }
     for (;;) {
         avifResult result = avifDecoderNextImage(decoder);
@@ -6233,6 +6989,106 @@ avifResult avifDecoderNthImage(avifDecoder * decoder, uint32_t frameIndex)
     return AVIF_RESULT_OK;
 }
 
+// Decodes the cell at row and column of the grid described by info and copies its visible part to image, in the YUV
+// planes or in the alpha plane depending on the item category. Only the extents of that cell's item are read and the
+// decoder instance is taken from and given back to decoder->data->idleCodecs.
+static avifResult avifDecoderDecodeGridCellTo(avifDecoder * decoder,
+                                              const avifTileInfo * info,
+                                              uint32_t row,
+                                              uint32_t column,
+                                              avifImage * image)
+{
+    AVIF_ASSERT_OR_RETURN((row >= info->firstGridRow) && (row < info->firstGridRow + info->gridRowCount) &&
+                          (column >= info->firstGridColumn) && (column < info->firstGridColumn + info->gridColumnCount));
+    const unsigned int tileIndex = (row - info->firstGridRow) * info->gridColumnCount + (column - info->firstGridColumn);
+    const avifTile * tile = &decoder->data->tiles.tile[info->firstTileIndex + tileIndex];
+    AVIF_ASSERT_OR_RETURN(tile->input->samples.count > 0);
+    avifDecodeSample * sample = &tile->input->samples.sample[0];
+    AVIF_CHECKRES(avifDecoderPrepareSample(decoder, sample, 0));
+
+    // Decode into a copy of the tile so that the state of avifDecoderNextImage() is left untouched.
+    avifTile cellTile = *tile;
+    cellTile.codec = NULL;
+    cellTile.image = avifImageCreateEmpty();
+    AVIF_CHECKERR(cellTile.image != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+    avifResult result = avifCodecCreateInternal(decoder, tile, decoder->maxThreads, &cellTile.codec);
+    if (result == AVIF_RESULT_OK) {
+        result = avifDecoderDecodeTile(decoder, &cellTile, sample, &decoder->diag);
+    }
+    if (result == AVIF_RESULT_OK) {
+        // The cells of the last row and column may extend past the grid image. Only keep what is visible.
+        avifImage * cellImage = cellTile.image;
+        cellImage->width = AVIF_MIN(cellImage->width, info->grid.outputWidth - column * tile->width);
+        cellImage->height = AVIF_MIN(cellImage->height, info->grid.outputHeight - row * tile->height);
+        if (avifIsAlpha(tile->input->itemCategory)) {
+            if ((cellImage->width != image->width) || (cellImage->height != image->height) ||
+                (cellImage->depth != image->depth)) {
+                avifDiagnosticsPrintf(&decoder->diag,
+                                      "The color grid cell does not match the alpha grid cell in width, height, or bit depth");
+                result = AVIF_RESULT_DECODE_ALPHA_FAILED;
+            } else {
+                result = avifImageAllocatePlanes(image, AVIF_PLANES_A);
+                if (result == AVIF_RESULT_OK) {
+                    avifImageCopySamples(image, cellImage, AVIF_PLANES_A);
+                }
+            }
+        } else {
+            result = avifImageCopy(image, cellImage, AVIF_PLANES_YUV);
+        }
+    }
+    // The planes of cellTile.image may point to buffers owned by the codec, so destroy it first.
+    avifImageDestroy(cellTile.image);
+    if (cellTile.codec) {
+        avifDecoderDataRecycleCodec(decoder->data, cellTile.codec);
+    }
+    return result;
+}
+
+avifResult avifDecoderDecodeGridCell(avifDecoder * decoder, uint32_t row, uint32_t column, avifImage * image)
+{
+    avifDiagnosticsClearError(&decoder->diag);
+
+    if (!decoder->data) {
+        // Nothing has been parsed yet
+        return AVIF_RESULT_NO_CONTENT;
+    }
+
+    const avifTileInfo * colorInfo = &decoder->data->tileInfos[AVIF_ITEM_COLOR];
+    if ((colorInfo->grid.rows == 0) || (colorInfo->grid.columns == 0)) {
+        avifDiagnosticsPrintf(&decoder->diag, "The color image is not a grid");
+        return AVIF_RESULT_INVALID_ARGUMENT;
+    }
+    if ((row < colorInfo->firstGridRow) || (row >= colorInfo->firstGridRow + colorInfo->gridRowCount) ||
+        (column < colorInfo->firstGridColumn) || (column >= colorInfo->firstGridColumn + colorInfo->gridColumnCount)) {
+        avifDiagnosticsPrintf(&decoder->diag,
+                              "Grid cell [%u,%u] is out of bounds or outside of the region of interest",
+                              row,
+                              column);
+        return AVIF_RESULT_INVALID_ARGUMENT;
+    }
+
+    const avifTileInfo * alphaInfo = &decoder->data->tileInfos[AVIF_ITEM_ALPHA];
+    if (decoder->alphaPresent &&
+        ((alphaInfo->grid.rows != colorInfo->grid.rows) || (alphaInfo->grid.columns != colorInfo->grid.columns) ||
+         (alphaInfo->grid.outputWidth != colorInfo->grid.outputWidth) ||
+         (alphaInfo->grid.outputHeight != colorInfo->grid.outputHeight))) {
+        avifDiagnosticsPrintf(&decoder->diag, "The alpha image is not a grid with the same layout as the color image");
+        return AVIF_RESULT_NOT_IMPLEMENTED;
+    }
+
+    AVIF_CHECKRES(avifDecoderDecodeGridCellTo(decoder, colorInfo, row, column, image));
+    image->colorPrimaries = decoder->image->colorPrimaries;
+    image->transferCharacteristics = decoder->image->transferCharacteristics;
+    image->matrixCoefficients = decoder->image->matrixCoefficients;
+    image->yuvRange = decoder->image->yuvRange;
+    AVIF_CHECKRES(avifImageSetProfileICC(image, decoder->image->icc.data, decoder->image->icc.size));
+    if (decoder->alphaPresent) {
+        AVIF_CHECKRES(avifDecoderDecodeGridCellTo(decoder, alphaInfo, row, column, image));
+        image->alphaPremultiplied = decoder->image->alphaPremultiplied;
+    }
+    return AVIF_RESULT_OK;
+}
+
 avifBool avifDecoderIsKeyframe(const avifDecoder * decoder, uint32_t frameIndex)
 {
     if (!decoder->data || (decoder->data->tiles.count == 0)) {
@@ -6288,7 +7144,12 @@ static uint32_t avifGetDecodedRowCount(const avifDecoder * decoder, const avifTi
     if ((info->grid.rows > 0) && (info->grid.columns > 0)) {
         // Grid of AVIF tiles (not to be confused with AV1 tiles).
         const uint32_t tileHeight = decoder->data->tiles.tile[info->firstTileIndex].height;
-        return AVIF_MIN((info->decodedTileCount / info->grid.columns) * tileHeight, image->height);
+        uint32_t rowCount = (info->firstGridRow + info->decodedTileCount / info->gridColumnCount) * tileHeight;
+        const avifItemCategory itemCategory = decoder->data->tiles.tile[info->firstTileIndex].input->itemCategory;
+        if (avifDecoderDataUsesRegionOfInterest(decoder->data, itemCategory)) {
+            rowCount = (rowCount > decoder->data->regionOfInterest.y) ? (rowCount - decoder->data->regionOfInterest.y) : 0;
+        }
+        return AVIF_MIN(rowCount, image->height);
     } else {
         // Non-grid image.
         return image->height;
@@ -4,14 +4,26 @@
 #include "avif/internal.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <stdint.h>
 #include <string.h>
 
-#if defined(_WIN32)
-#include <process.h>
-#include <windows.h>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AVIF_YUV_TO_RGB_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AVIF_YUV_TO_RGB_NEON
+#include <arm_neon.h>
+#endif
+
+// Allows using intrinsics of instruction sets that are not enabled for the whole file, after checking for support at runtime.
+#if defined(__GNUC__) || defined(__clang__)
+#define AVIF_TARGET_ATTRIBUTE(features) __attribute__((target(features)))
 #else
-#include <pthread.h>
+#define AVIF_TARGET_ATTRIBUTE(features)
 #endif
 
 struct YUVBlock
@@ -159,6 +171,8 @@ static avifBool avifPrepareReformatState(const avifImage * image, const avifRGBI
 
     AVIF_CHECK(avifGetRGBColorSpaceInfo(rgb, &state->rgb));
     AVIF_CHECK(avifGetYUVColorSpaceInfo(image, &state->yuv));
+    state->unormFloatTableY = NULL;
+    state->unormFloatTableUV = NULL;
 
     state->yuv.mode = AVIF_REFORMAT_MODE_YUV_COEFFICIENTS;
 
@@ -212,41 +226,17 @@ static int avifYUVColorSpaceInfoUVToUNorm(avifYUVColorSpaceInfo * info, float v)
     return AVIF_CLAMP(unorm, 0, info->maxChannel);
 }
 
-avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
+// Converts rgb to the already allocated planes of image. Both may be views of a band of rows of larger images.
+static avifResult avifImageRGBToYUVImpl(avifImage * image,
+                                        const avifRGBImage * rgb,
+                                        avifReformatState * state,
+                                        avifAlphaMultiplyMode alphaMode)
 {
-    if (!rgb->pixels || rgb->format == AVIF_RGB_FORMAT_RGB_565) {
-        return AVIF_RESULT_REFORMAT_FAILED;
-    }
-
-    avifReformatState state;
-    if (!avifPrepareReformatState(image, rgb, &state)) {
-        return AVIF_RESULT_REFORMAT_FAILED;
-    }
-
-    if (rgb->isFloat) {
-        return AVIF_RESULT_NOT_IMPLEMENTED;
-    }
-
-    const avifBool hasAlpha = avifRGBFormatHasAlpha(rgb->format) && !rgb->ignoreAlpha;
-    avifResult allocationResult = avifImageAllocatePlanes(image, hasAlpha ? AVIF_PLANES_ALL : AVIF_PLANES_YUV);
-    if (allocationResult != AVIF_RESULT_OK) {
-        return allocationResult;
-    }
-
-    avifAlphaMultiplyMode alphaMode = AVIF_ALPHA_MULTIPLY_MODE_NO_OP;
-    if (hasAlpha) {
-        if (!rgb->alphaPremultiplied && image->alphaPremultiplied) {
-            alphaMode = AVIF_ALPHA_MULTIPLY_MODE_MULTIPLY;
-        } else if (rgb->alphaPremultiplied && !image->alphaPremultiplied) {
-            alphaMode = AVIF_ALPHA_MULTIPLY_MODE_UNMULTIPLY;
-        }
-    }
-
     avifBool converted = AVIF_FALSE;
 
     // Try converting with libsharpyuv.
     if ((rgb->chromaDownsampling == AVIF_CHROMA_DOWNSAMPLING_SHARP_YUV) && (image->yuvFormat == AVIF_PIXEL_FORMAT_YUV420)) {
-        const avifResult libSharpYUVResult = avifImageRGBToYUVLibSharpYUV(image, rgb, &state);
+        const avifResult libSharpYUVResult = avifImageRGBToYUVLibSharpYUV(image, rgb, state);
         if (libSharpYUVResult != AVIF_RESULT_OK) {
             // Return the error if sharpyuv was requested but failed for any reason, including libsharpyuv not being available.
             return libSharpYUVResult;
@@ -264,19 +254,19 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
     }
 
     if (!converted) {
-        const float kr = state.yuv.kr;
-        const float kg = state.yuv.kg;
-        const float kb = state.yuv.kb;
+        const float kr = state->yuv.kr;
+        const float kg = state->yuv.kg;
+        const float kb = state->yuv.kb;
 
         struct YUVBlock yuvBlock[2][2];
         float rgbPixel[3];
-        const uint32_t rgbPixelBytes = state.rgb.pixelBytes;
-        const uint32_t offsetBytesR = state.rgb.offsetBytesR;
-        const uint32_t offsetBytesG = state.rgb.offsetBytesG;
-        const uint32_t offsetBytesB = state.rgb.offsetBytesB;
-        const uint32_t offsetBytesA = state.rgb.offsetBytesA;
+        const uint32_t rgbPixelBytes = state->rgb.pixelBytes;
+        const uint32_t offsetBytesR = state->rgb.offsetBytesR;
+        const uint32_t offsetBytesG = state->rgb.offsetBytesG;
+        const uint32_t offsetBytesB = state->rgb.offsetBytesB;
+        const uint32_t offsetBytesA = state->rgb.offsetBytesA;
         const uint32_t rgbRowBytes = rgb->rowBytes;
-        const float rgbMaxChannelF = state.rgb.maxChannelF;
+        const float rgbMaxChannelF = state->rgb.maxChannelF;
         uint8_t * yPlane = image->yuvPlanes[AVIF_CHAN_Y];
         uint8_t * uPlane = image->yuvPlanes[AVIF_CHAN_U];
         uint8_t * vPlane = image->yuvPlanes[AVIF_CHAN_V];
@@ -300,7 +290,7 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
                         int j = outerJ + bJ;
 
                         // Unpack RGB into normalized float
-                        if (state.rgb.channelBytes > 1) {
+                        if (state->rgb.channelBytes > 1) {
                             rgbPixel[0] = *((uint16_t *)(&rgb->pixels[offsetBytesR + (i * rgbPixelBytes) + (j * rgbRowBytes)])) /
                                           rgbMaxChannelF;
                             rgbPixel[1] = *((uint16_t *)(&rgb->pixels[offsetBytesG + (i * rgbPixelBytes) + (j * rgbRowBytes)])) /
@@ -315,7 +305,7 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
 
                         if (alphaMode != AVIF_ALPHA_MULTIPLY_MODE_NO_OP) {
                             float a;
-                            if (state.rgb.channelBytes > 1) {
+                            if (state->rgb.channelBytes > 1) {
                                 a = *((uint16_t *)(&rgb->pixels[offsetBytesA + (i * rgbPixelBytes) + (j * rgbRowBytes)])) / rgbMaxChannelF;
                             } else {
                                 a = rgb->pixels[offsetBytesA + (i * rgbPixelBytes) + (j * rgbRowBytes)] / rgbMaxChannelF;
@@ -349,18 +339,19 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
                         }
 
                         // RGB -> YUV conversion
-                        if (state.yuv.mode == AVIF_REFORMAT_MODE_IDENTITY) {
+                        if (state->yuv.mode == AVIF_REFORMAT_MODE_IDENTITY) {
                             // Formulas 41,42,43 from https://www.itu.int/rec/T-REC-H.273-201612-S
                             yuvBlock[bI][bJ].y = rgbPixel[1]; // G
                             yuvBlock[bI][bJ].u = rgbPixel[2]; // B
                             yuvBlock[bI][bJ].v = rgbPixel[0]; // R
-                        } else if (state.yuv.mode == AVIF_REFORMAT_MODE_YCGCO) {
+                        } else if (state->yuv.mode == AVIF_REFORMAT_MODE_YCGCO) {
                             // Formulas 44,45,46 from https://www.itu.int/rec/T-REC-H.273-201612-S
                             yuvBlock[bI][bJ].y = 0.5f * rgbPixel[1] + 0.25f * (rgbPixel[0] + rgbPixel[2]);
                             yuvBlock[bI][bJ].u = 0.5f * rgbPixel[1] - 0.25f * (rgbPixel[0] + rgbPixel[2]);
                             yuvBlock[bI][bJ].v = 0.5f * (rgbPixel[0] - rgbPixel[2]);
 #if defined(AVIF_ENABLE_EXPERIMENTAL_YCGCO_R)
-                        } else if (state.yuv.mode == AVIF_REFORMAT_MODE_YCGCO_RE || state.yuv.mode == AVIF_REFORMAT_MODE_YCGCO_RO) {
+                        } else if (state->yuv.mode == AVIF_REFORMAT_MODE_YCGCO_RE ||
+                                   state->yuv.mode == AVIF_REFORMAT_MODE_YCGCO_RO) {
                             // Formulas 58,59,60,61 from https://www.itu.int/rec/T-REC-H.273-202407-P
                             const int R = (int)avifRoundf(AVIF_CLAMP(rgbPixel[0] * rgbMaxChannelF, 0.0f, rgbMaxChannelF));
                             const int G = (int)avifRoundf(AVIF_CLAMP(rgbPixel[1] * rgbMaxChannelF, 0.0f, rgbMaxChannelF));
@@ -368,9 +359,9 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
                             const int Co = R - B;
                             const int t = B + (Co >> 1);
                             const int Cg = G - t;
-                            yuvBlock[bI][bJ].y = (t + (Cg >> 1)) / state.yuv.rangeY;
-                            yuvBlock[bI][bJ].u = Cg / state.yuv.rangeUV;
-                            yuvBlock[bI][bJ].v = Co / state.yuv.rangeUV;
+                            yuvBlock[bI][bJ].y = (t + (Cg >> 1)) / state->yuv.rangeY;
+                            yuvBlock[bI][bJ].u = Cg / state->yuv.rangeUV;
+                            yuvBlock[bI][bJ].v = Co / state->yuv.rangeUV;
 #endif
                         } else {
                             float Y = (kr * rgbPixel[0]) + (kg * rgbPixel[1]) + (kb * rgbPixel[2]);
@@ -379,22 +370,24 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
                             yuvBlock[bI][bJ].v = (rgbPixel[0] - Y) / (2 * (1 - kr));
                         }
 
-                        if (state.yuv.channelBytes > 1) {
+                        if (state->yuv.channelBytes > 1) {
                             uint16_t * pY = (uint16_t *)&yPlane[(i * 2) + (j * yRowBytes)];
-                            *pY = (uint16_t)avifYUVColorSpaceInfoYToUNorm(&state.yuv, yuvBlock[bI][bJ].y);
+                            *pY = (uint16_t)avifYUVColorSpaceInfoYToUNorm(&state->yuv, yuvBlock[bI][bJ].y);
                             if (image->yuvFormat == AVIF_PIXEL_FORMAT_YUV444) {
                                 // YUV444, full chroma
                                 uint16_t * pU = (uint16_t *)&uPlane[(i * 2) + (j * uRowBytes)];
-                                *pU = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, yuvBlock[bI][bJ].u);
+                                *pU = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, yuvBlock[bI][bJ].u);
                                 uint16_t * pV = (uint16_t *)&vPlane[(i * 2) + (j * vRowBytes)];
-                                *pV = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, yuvBlock[bI][bJ].v);
+                                *pV = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, yuvBlock[bI][bJ].v);
                             }
                         } else {
-                            yPlane[i + (j * yRowBytes)] = (uint8_t)avifYUVColorSpaceInfoYToUNorm(&state.yuv, yuvBlock[bI][bJ].y);
+                            yPlane[i + (j * yRowBytes)] = (uint8_t)avifYUVColorSpaceInfoYToUNorm(&state->yuv, yuvBlock[bI][bJ].y);
                             if (image->yuvFormat == AVIF_PIXEL_FORMAT_YUV444) {
                                 // YUV444, full chroma
-                                uPlane[i + (j * uRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, yuvBlock[bI][bJ].u);
-                                vPlane[i + (j * vRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, yuvBlock[bI][bJ].v);
+                                uPlane[i + (j * uRowBytes)] =
+                                    (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, yuvBlock[bI][bJ].u);
+                                vPlane[i + (j * vRowBytes)] =
+                                    (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, yuvBlock[bI][bJ].v);
                             }
                         }
                     }
@@ -422,14 +415,14 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
                     const int chromaShiftY = 1;
                     int uvI = outerI >> chromaShiftX;
                     int uvJ = outerJ >> chromaShiftY;
-                    if (state.yuv.channelBytes > 1) {
+                    if (state->yuv.channelBytes > 1) {
                         uint16_t * pU = (uint16_t *)&uPlane[(uvI * 2) + (uvJ * uRowBytes)];
-                        *pU = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, avgU);
+                        *pU = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, avgU);
                         uint16_t * pV = (uint16_t *)&vPlane[(uvI * 2) + (uvJ * vRowBytes)];
-                        *pV = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, avgV);
+                        *pV = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, avgV);
                     } else {
-                        uPlane[uvI + (uvJ * uRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, avgU);
-                        vPlane[uvI + (uvJ * vRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, avgV);
+                        uPlane[uvI + (uvJ * uRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, avgU);
+                        vPlane[uvI + (uvJ * vRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, avgV);
                     }
                 } else if (image->yuvFormat == AVIF_PIXEL_FORMAT_YUV422) {
                     // YUV422, average 2 samples (1x2), twice
@@ -448,14 +441,14 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
                         const int chromaShiftX = 1;
                         int uvI = outerI >> chromaShiftX;
                         int uvJ = outerJ + bJ;
-                        if (state.yuv.channelBytes > 1) {
+                        if (state->yuv.channelBytes > 1) {
                             uint16_t * pU = (uint16_t *)&uPlane[(uvI * 2) + (uvJ * uRowBytes)];
-                            *pU = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, avgU);
+                            *pU = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, avgU);
                             uint16_t * pV = (uint16_t *)&vPlane[(uvI * 2) + (uvJ * vRowBytes)];
-                            *pV = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, avgV);
+                            *pV = (uint16_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, avgV);
                         } else {
-                            uPlane[uvI + (uvJ * uRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, avgU);
-                            vPlane[uvI + (uvJ * vRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state.yuv, avgV);
+                            uPlane[uvI + (uvJ * uRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, avgU);
+                            vPlane[uvI + (uvJ * vRowBytes)] = (uint8_t)avifYUVColorSpaceInfoUVToUNorm(&state->yuv, avgV);
                         }
                     }
                 }
@@ -472,14 +465,14 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
         params.dstPlane = image->alphaPlane;
         params.dstRowBytes = image->alphaRowBytes;
         params.dstOffsetBytes = 0;
-        params.dstPixelBytes = state.yuv.channelBytes;
+        params.dstPixelBytes = state->yuv.channelBytes;
 
         if (avifRGBFormatHasAlpha(rgb->format) && !rgb->ignoreAlpha) {
             params.srcDepth = rgb->depth;
             params.srcPlane = rgb->pixels;
             params.srcRowBytes = rgb->rowBytes;
-            params.srcOffsetBytes = state.rgb.offsetBytesA;
-            params.srcPixelBytes = state.rgb.pixelBytes;
+            params.srcOffsetBytes = state->rgb.offsetBytesA;
+            params.srcPixelBytes = state->rgb.pixelBytes;
 
             avifReformatAlpha(&params);
         } else {
@@ -491,13 +484,115 @@ avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
     return AVIF_RESULT_OK;
 }
 
-// Allocates and fills look-up tables for going from YUV limited/full unorm -> full range RGB FP32.
+typedef struct
+{
+    avifImage image;
+    avifRGBImage rgb;
+    avifReformatState * state;
+    avifAlphaMultiplyMode alphaMode;
+    avifResult result;
+} RGBToYUVThreadData;
+
+static void avifImageRGBToYUVThreadWorker(void * arg)
+{
+    RGBToYUVThreadData * data = (RGBToYUVThreadData *)arg;
+    data->result = avifImageRGBToYUVImpl(&data->image, &data->rgb, data->state, data->alphaMode);
+}
+
+avifResult avifImageRGBToYUV(avifImage * image, const avifRGBImage * rgb)
+{
+    if (!rgb->pixels || rgb->format == AVIF_RGB_FORMAT_RGB_565) {
+        return AVIF_RESULT_REFORMAT_FAILED;
+    }
+
+    avifReformatState state;
+    if (!avifPrepareReformatState(image, rgb, &state)) {
+        return AVIF_RESULT_REFORMAT_FAILED;
+    }
+
+    if (rgb->isFloat) {
+        return AVIF_RESULT_NOT_IMPLEMENTED;
+    }
+
+    const avifBool hasAlpha = avifRGBFormatHasAlpha(rgb->format) && !rgb->ignoreAlpha;
+    avifResult allocationResult = avifImageAllocatePlanes(image, hasAlpha ? AVIF_PLANES_ALL : AVIF_PLANES_YUV);
+    if (allocationResult != AVIF_RESULT_OK) {
+        return allocationResult;
+    }
+
+    avifAlphaMultiplyMode alphaMode = AVIF_ALPHA_MULTIPLY_MODE_NO_OP;
+    if (hasAlpha) {
+        if (!rgb->alphaPremultiplied && image->alphaPremultiplied) {
+            alphaMode = AVIF_ALPHA_MULTIPLY_MODE_MULTIPLY;
+        } else if (rgb->alphaPremultiplied && !image->alphaPremultiplied) {
+            alphaMode = AVIF_ALPHA_MULTIPLY_MODE_UNMULTIPLY;
+        }
+    }
+
+    // In practice, we rarely need more than 8 threads for RGB to YUV conversion.
+    uint32_t jobs = AVIF_CLAMP(rgb->maxThreads, 1, 8);
+    // Each thread worker needs at least 2 rows so that the 2x2 blocks of 4:2:0 subsampling are never split between jobs.
+    if (jobs == 1 || (image->height / 2) < jobs) {
+        return avifImageRGBToYUVImpl(image, rgb, &state, alphaMode);
+    }
+
+    const size_t byteCount = sizeof(RGBToYUVThreadData) * jobs;
+    RGBToYUVThreadData * threadData = (RGBToYUVThreadData *)avifAlloc(byteCount);
+    if (!threadData) {
+        return AVIF_RESULT_OUT_OF_MEMORY;
+    }
+    memset(threadData, 0, byteCount);
+    uint32_t rowsPerJob = image->height / jobs;
+    if (rowsPerJob % 2) {
+        ++rowsPerJob;
+        jobs = (image->height + rowsPerJob - 1) / rowsPerJob; // ceil
+    }
+    const uint32_t rowsForLastJob = image->height - rowsPerJob * (jobs - 1);
+    uint32_t startRow = 0;
+    for (uint32_t i = 0; i < jobs; ++i, startRow += rowsPerJob) {
+        RGBToYUVThreadData * tdata = &threadData[i];
+        const avifCropRect rect = { .x = 0, .y = startRow, .width = image->width, .height = (i == jobs - 1) ? rowsForLastJob : rowsPerJob };
+        // The view shares the planes allocated above, so the jobs write directly into image.
+        if (avifImageSetViewRect(&tdata->image, image, &rect) != AVIF_RESULT_OK) {
+            avifFree(threadData);
+            return AVIF_RESULT_REFORMAT_FAILED;
+        }
+
+        tdata->rgb = *rgb;
+        tdata->rgb.pixels += startRow * (size_t)rgb->rowBytes;
+        tdata->rgb.height = tdata->image.height;
+
+        tdata->state = &state;
+        tdata->alphaMode = alphaMode;
+    }
+    avifResult result = AVIF_RESULT_OK;
+    if (!avifRunInParallel(rgb->threadPool, avifImageRGBToYUVThreadWorker, threadData, sizeof(RGBToYUVThreadData), jobs)) {
+        result = AVIF_RESULT_REFORMAT_FAILED;
+    }
+    for (uint32_t i = 0; i < jobs; ++i) {
+        if (threadData[i].result != AVIF_RESULT_OK) {
+            result = threadData[i].result;
+        }
+    }
+    avifFree(threadData);
+    return result;
+}
+
+// Allocates and fills look-up tables for going from YUV limited/full unorm -> full range RGB FP32, or points to the ones
+// cached in state, if any.
 // Review this when implementing YCgCo limited range support.
 static avifBool avifCreateYUVToRGBLookUpTables(float ** unormFloatTableY, float ** unormFloatTableUV, uint32_t depth, const avifReformatState * state)
 {
     const size_t cpCount = (size_t)1 << depth;
 
     assert(unormFloatTableY);
+    if (state->unormFloatTableY) {
+        *unormFloatTableY = state->unormFloatTableY;
+        if (unormFloatTableUV) {
+            *unormFloatTableUV = state->unormFloatTableUV;
+        }
+        return AVIF_TRUE;
+    }
     *unormFloatTableY = (float *)avifAlloc(cpCount * sizeof(float));
     AVIF_CHECK(*unormFloatTableY);
     for (uint32_t cp = 0; cp < cpCount; ++cp) {
@@ -523,9 +618,16 @@ static avifBool avifCreateYUVToRGBLookUpTables(float ** unormFloatTableY, float
     return AVIF_TRUE;
 }
 
-// Frees look-up tables allocated with avifCreateYUVToRGBLookUpTables().
-static void avifFreeYUVToRGBLookUpTables(float ** unormFloatTableY, float ** unormFloatTableUV)
+// Frees look-up tables allocated with avifCreateYUVToRGBLookUpTables(). The tables cached in state are left untouched.
+static void avifFreeYUVToRGBLookUpTables(float ** unormFloatTableY, float ** unormFloatTableUV, const avifReformatState * state)
 {
+    if (state->unormFloatTableY && (*unormFloatTableY == state->unormFloatTableY)) {
+        *unormFloatTableY = NULL;
+        if (unormFloatTableUV) {
+            *unormFloatTableUV = NULL;
+        }
+        return;
+    }
     if (unormFloatTableUV) {
         if (*unormFloatTableUV != *unormFloatTableY) {
             avifFree(*unormFloatTableUV);
@@ -567,6 +669,558 @@ static void avifGetRGB565(const uint8_t * ptrR, uint8_t * R, uint8_t * G, uint8_
     *B = (uint8_t)((b5 << 3) | (b5 >> 2));
 }
 
+// This constant comes from libyuv. For details, see here:
+// https://chromium.googlesource.com/libyuv/libyuv/+/2f87e9a7/source/row_common.cc#3537
+#define F16_MULTIPLIER 1.9259299444e-34f
+
+typedef union avifF16
+{
+    float f;
+    uint32_t u32;
+} avifF16;
+
+// Converts count unorm values of the given depth to half floats (F16) in place, without libyuv.
+static void avifUNormRowToF16(uint16_t * row, uint32_t count, uint32_t depth)
+{
+    const float scale = 1.0f / ((1 << depth) - 1);
+    const float multiplier = F16_MULTIPLIER * scale;
+    for (uint32_t i = 0; i < count; ++i) {
+        avifF16 f16;
+        f16.f = row[i] * multiplier;
+        row[i] = (uint16_t)(f16.u32 >> 13);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// YUV to RGB row kernels
+
+static void avifYUVToRGBRowC(const float * y,
+                             const float * cb,
+                             const float * cr,
+                             uint32_t count,
+                             const avifYUVToRGBRowParams * params,
+                             uint16_t * r,
+                             uint16_t * g,
+                             uint16_t * b)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        const float R = y[i] + params->crToR * cr[i];
+        const float B = y[i] + params->cbToB * cb[i];
+        const float G = y[i] - ((2 * ((params->crToG * cr[i]) + (params->cbToG * cb[i]))) / params->kg);
+        const float Rc = AVIF_CLAMP(R, 0.0f, 1.0f);
+        const float Gc = AVIF_CLAMP(G, 0.0f, 1.0f);
+        const float Bc = AVIF_CLAMP(B, 0.0f, 1.0f);
+        r[i] = (uint16_t)(0.5f + (Rc * params->rgbMaxChannelF));
+        g[i] = (uint16_t)(0.5f + (Gc * params->rgbMaxChannelF));
+        b[i] = (uint16_t)(0.5f + (Bc * params->rgbMaxChannelF));
+    }
+}
+
+// Same as avifYUVToRGBRowC() but also multiplies or divides the clamped R, G and B values by the alpha values a, in [0:1],
+// before rounding, as avifImageYUVAnyToRGBAnySlow() does.
+static void avifYUVToRGBRowAlphaMultiplyC(const float * y,
+                                          const float * cb,
+                                          const float * cr,
+                                          const float * a,
+                                          avifAlphaMultiplyMode alphaMultiplyMode,
+                                          uint32_t count,
+                                          const avifYUVToRGBRowParams * params,
+                                          uint16_t * r,
+                                          uint16_t * g,
+                                          uint16_t * b)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        const float R = y[i] + params->crToR * cr[i];
+        const float B = y[i] + params->cbToB * cb[i];
+        const float G = y[i] - ((2 * ((params->crToG * cr[i]) + (params->cbToG * cb[i]))) / params->kg);
+        float Rc = AVIF_CLAMP(R, 0.0f, 1.0f);
+        float Gc = AVIF_CLAMP(G, 0.0f, 1.0f);
+        float Bc = AVIF_CLAMP(B, 0.0f, 1.0f);
+        const float Ac = a[i];
+        if (Ac == 0.0f) {
+            Rc = 0.0f;
+            Gc = 0.0f;
+            Bc = 0.0f;
+        } else if (Ac < 1.0f) {
+            if (alphaMultiplyMode == AVIF_ALPHA_MULTIPLY_MODE_MULTIPLY) {
+                Rc *= Ac;
+                Gc *= Ac;
+                Bc *= Ac;
+            } else {
+                Rc /= Ac;
+                Gc /= Ac;
+                Bc /= Ac;
+                Rc = AVIF_MIN(Rc, 1.0f);
+                Gc = AVIF_MIN(Gc, 1.0f);
+                Bc = AVIF_MIN(Bc, 1.0f);
+            }
+        }
+        r[i] = (uint16_t)(0.5f + (Rc * params->rgbMaxChannelF));
+        g[i] = (uint16_t)(0.5f + (Gc * params->rgbMaxChannelF));
+        b[i] = (uint16_t)(0.5f + (Bc * params->rgbMaxChannelF));
+    }
+}
+
+// Multiplies or divides the already rounded R, G and B values by the RGB alpha values of count pixels starting at ptrA, as
+// avifRGBImagePremultiplyAlpha() and avifRGBImageUnpremultiplyAlpha() do without libyuv. avifRoundf(v) is replaced by a
+// truncation of v + 0.5f, which is the same for the non-negative values seen here.
+static void avifRGBRowAlphaMultiply(const uint8_t * ptrA,
+                                    uint32_t rgbDepth,
+                                    uint32_t rgbPixelBytes,
+                                    avifAlphaMultiplyMode alphaMultiplyMode,
+                                    uint32_t count,
+                                    uint16_t * r,
+                                    uint16_t * g,
+                                    uint16_t * b)
+{
+    const uint32_t max = (1 << rgbDepth) - 1;
+    const float maxF = (float)max;
+    for (uint32_t i = 0; i < count; ++i, ptrA += rgbPixelBytes) {
+        const uint16_t a = (rgbDepth == 8) ? *ptrA : *((const uint16_t *)ptrA);
+        if (a >= max) {
+            // opaque is no-op
+        } else if (a == 0) {
+            r[i] = 0;
+            g[i] = 0;
+            b[i] = 0;
+        } else if (alphaMultiplyMode == AVIF_ALPHA_MULTIPLY_MODE_MULTIPLY) {
+            // a < maxF is always true now, so we don't need clamp here
+            r[i] = (uint16_t)((float)r[i] * (float)a / maxF + 0.5f);
+            g[i] = (uint16_t)((float)g[i] * (float)a / maxF + 0.5f);
+            b[i] = (uint16_t)((float)b[i] * (float)a / maxF + 0.5f);
+        } else {
+            const float c1 = (float)r[i] * maxF / (float)a + 0.5f;
+            const float c2 = (float)g[i] * maxF / (float)a + 0.5f;
+            const float c3 = (float)b[i] * maxF / (float)a + 0.5f;
+            r[i] = (uint16_t)AVIF_MIN(c1, maxF);
+            g[i] = (uint16_t)AVIF_MIN(c2, maxF);
+            b[i] = (uint16_t)AVIF_MIN(c3, maxF);
+        }
+    }
+}
+
+// The SIMD kernels below perform the same float operations in the same order as avifYUVToRGBRowC(), without fused
+// multiply-add, so that their output is identical. This file is built with -ffp-contract=off (see CMakeLists.txt) so
+// that the compiler does not fuse the multiplies and adds of either path into FMA instructions either.
+
+#if defined(AVIF_YUV_TO_RGB_X86)
+
+static AVIF_TARGET_ATTRIBUTE("sse4.1") void avifYUVToRGBRowSSE41(const float * y,
+                                                                 const float * cb,
+                                                                 const float * cr,
+                                                                 uint32_t count,
+                                                                 const avifYUVToRGBRowParams * params,
+                                                                 uint16_t * r,
+                                                                 uint16_t * g,
+                                                                 uint16_t * b)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 crToR = _mm_set1_ps(params->crToR);
+    const __m128 cbToB = _mm_set1_ps(params->cbToB);
+    const __m128 crToG = _mm_set1_ps(params->crToG);
+    const __m128 cbToG = _mm_set1_ps(params->cbToG);
+    const __m128 kg = _mm_set1_ps(params->kg);
+    const __m128 rgbMaxChannelF = _mm_set1_ps(params->rgbMaxChannelF);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 Y = _mm_loadu_ps(&y[i]);
+        const __m128 Cb = _mm_loadu_ps(&cb[i]);
+        const __m128 Cr = _mm_loadu_ps(&cr[i]);
+        const __m128 R = _mm_add_ps(Y, _mm_mul_ps(crToR, Cr));
+        const __m128 B = _mm_add_ps(Y, _mm_mul_ps(cbToB, Cb));
+        const __m128 CrCbToG = _mm_add_ps(_mm_mul_ps(crToG, Cr), _mm_mul_ps(cbToG, Cb));
+        const __m128 G = _mm_sub_ps(Y, _mm_div_ps(_mm_mul_ps(two, CrCbToG), kg));
+        const __m128 Rc = _mm_min_ps(_mm_max_ps(R, zero), one);
+        const __m128 Gc = _mm_min_ps(_mm_max_ps(G, zero), one);
+        const __m128 Bc = _mm_min_ps(_mm_max_ps(B, zero), one);
+        const __m128i R32 = _mm_cvttps_epi32(_mm_add_ps(half, _mm_mul_ps(Rc, rgbMaxChannelF)));
+        const __m128i G32 = _mm_cvttps_epi32(_mm_add_ps(half, _mm_mul_ps(Gc, rgbMaxChannelF)));
+        const __m128i B32 = _mm_cvttps_epi32(_mm_add_ps(half, _mm_mul_ps(Bc, rgbMaxChannelF)));
+        _mm_storel_epi64((__m128i *)&r[i], _mm_packus_epi32(R32, R32));
+        _mm_storel_epi64((__m128i *)&g[i], _mm_packus_epi32(G32, G32));
+        _mm_storel_epi64((__m128i *)&b[i], _mm_packus_epi32(B32, B32));
+    }
+    avifYUVToRGBRowC(&y[i], &cb[i], &cr[i], count - i, params, &r[i], &g[i], &b[i]);
+}
+
+static AVIF_TARGET_ATTRIBUTE("avx2") __m128i avifPackUS32To16AVX2(__m256i v)
+{
+    return _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+static AVIF_TARGET_ATTRIBUTE("avx2") void avifYUVToRGBRowAVX2(const float * y,
+                                                              const float * cb,
+                                                              const float * cr,
+                                                              uint32_t count,
+                                                              const avifYUVToRGBRowParams * params,
+                                                              uint16_t * r,
+                                                              uint16_t * g,
+                                                              uint16_t * b)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 crToR = _mm256_set1_ps(params->crToR);
+    const __m256 cbToB = _mm256_set1_ps(params->cbToB);
+    const __m256 crToG = _mm256_set1_ps(params->crToG);
+    const __m256 cbToG = _mm256_set1_ps(params->cbToG);
+    const __m256 kg = _mm256_set1_ps(params->kg);
+    const __m256 rgbMaxChannelF = _mm256_set1_ps(params->rgbMaxChannelF);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 Y = _mm256_loadu_ps(&y[i]);
+        const __m256 Cb = _mm256_loadu_ps(&cb[i]);
+        const __m256 Cr = _mm256_loadu_ps(&cr[i]);
+        const __m256 R = _mm256_add_ps(Y, _mm256_mul_ps(crToR, Cr));
+        const __m256 B = _mm256_add_ps(Y, _mm256_mul_ps(cbToB, Cb));
+        const __m256 CrCbToG = _mm256_add_ps(_mm256_mul_ps(crToG, Cr), _mm256_mul_ps(cbToG, Cb));
+        const __m256 G = _mm256_sub_ps(Y, _mm256_div_ps(_mm256_mul_ps(two, CrCbToG), kg));
+        const __m256 Rc = _mm256_min_ps(_mm256_max_ps(R, zero), one);
+        const __m256 Gc = _mm256_min_ps(_mm256_max_ps(G, zero), one);
+        const __m256 Bc = _mm256_min_ps(_mm256_max_ps(B, zero), one);
+        const __m256i R32 = _mm256_cvttps_epi32(_mm256_add_ps(half, _mm256_mul_ps(Rc, rgbMaxChannelF)));
+        const __m256i G32 = _mm256_cvttps_epi32(_mm256_add_ps(half, _mm256_mul_ps(Gc, rgbMaxChannelF)));
+        const __m256i B32 = _mm256_cvttps_epi32(_mm256_add_ps(half, _mm256_mul_ps(Bc, rgbMaxChannelF)));
+        _mm_storeu_si128((__m128i *)&r[i], avifPackUS32To16AVX2(R32));
+        _mm_storeu_si128((__m128i *)&g[i], avifPackUS32To16AVX2(G32));
+        _mm_storeu_si128((__m128i *)&b[i], avifPackUS32To16AVX2(B32));
+    }
+    avifYUVToRGBRowSSE41(&y[i], &cb[i], &cr[i], count - i, params, &r[i], &g[i], &b[i]);
+}
+
+#if defined(_MSC_VER)
+static avifBool avifCPUSupportsSSE41(void)
+{
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] >> 19) & 1;
+}
+
+static AVIF_TARGET_ATTRIBUTE("xsave") avifBool avifCPUSupportsAVX2(void)
+{
+    int info[4];
+    __cpuid(info, 1);
+    const avifBool osUsesXSAVE = (info[2] >> 27) & 1;
+    const avifBool hasAVX = (info[2] >> 28) & 1;
+    // The OS must save the YMM registers on context switches.
+    if (!osUsesXSAVE || !hasAVX || (_xgetbv(0) & 6) != 6) {
+        return AVIF_FALSE;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+}
+#else
+static avifBool avifCPUSupportsSSE41(void)
+{
+    return __builtin_cpu_supports("sse4.1") != 0;
+}
+
+static avifBool avifCPUSupportsAVX2(void)
+{
+    return __builtin_cpu_supports("avx2") != 0;
+}
+#endif
+
+#elif defined(AVIF_YUV_TO_RGB_NEON)
+
+static void avifYUVToRGBRowNEON(const float * y,
+                                const float * cb,
+                                const float * cr,
+                                uint32_t count,
+                                const avifYUVToRGBRowParams * params,
+                                uint16_t * r,
+                                uint16_t * g,
+                                uint16_t * b)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t two = vdupq_n_f32(2.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t crToR = vdupq_n_f32(params->crToR);
+    const float32x4_t cbToB = vdupq_n_f32(params->cbToB);
+    const float32x4_t crToG = vdupq_n_f32(params->crToG);
+    const float32x4_t cbToG = vdupq_n_f32(params->cbToG);
+    const float32x4_t kg = vdupq_n_f32(params->kg);
+    const float32x4_t rgbMaxChannelF = vdupq_n_f32(params->rgbMaxChannelF);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t Y = vld1q_f32(&y[i]);
+        const float32x4_t Cb = vld1q_f32(&cb[i]);
+        const float32x4_t Cr = vld1q_f32(&cr[i]);
+        const float32x4_t R = vaddq_f32(Y, vmulq_f32(crToR, Cr));
+        const float32x4_t B = vaddq_f32(Y, vmulq_f32(cbToB, Cb));
+        const float32x4_t CrCbToG = vaddq_f32(vmulq_f32(crToG, Cr), vmulq_f32(cbToG, Cb));
+        const float32x4_t G = vsubq_f32(Y, vdivq_f32(vmulq_f32(two, CrCbToG), kg));
+        const float32x4_t Rc = vminq_f32(vmaxq_f32(R, zero), one);
+        const float32x4_t Gc = vminq_f32(vmaxq_f32(G, zero), one);
+        const float32x4_t Bc = vminq_f32(vmaxq_f32(B, zero), one);
+        vst1_u16(&r[i], vqmovn_u32(vcvtq_u32_f32(vaddq_f32(half, vmulq_f32(Rc, rgbMaxChannelF)))));
+        vst1_u16(&g[i], vqmovn_u32(vcvtq_u32_f32(vaddq_f32(half, vmulq_f32(Gc, rgbMaxChannelF)))));
+        vst1_u16(&b[i], vqmovn_u32(vcvtq_u32_f32(vaddq_f32(half, vmulq_f32(Bc, rgbMaxChannelF)))));
+    }
+    avifYUVToRGBRowC(&y[i], &cb[i], &cr[i], count - i, params, &r[i], &g[i], &b[i]);
+}
+
+#endif
+
+avifYUVToRGBRowFunc avifGetYUVToRGBRowFunc(avifBool allowSIMD)
+{
+    if (allowSIMD) {
+#if defined(AVIF_YUV_TO_RGB_X86)
+        if (avifCPUSupportsAVX2()) {
+            return avifYUVToRGBRowAVX2;
+        }
+        if (avifCPUSupportsSSE41()) {
+            return avifYUVToRGBRowSSE41;
+        }
+#elif defined(AVIF_YUV_TO_RGB_NEON)
+        return avifYUVToRGBRowNEON;
+#endif
+    }
+    return avifYUVToRGBRowC;
+}
+
+// Looks up count samples of a YUV plane row in unormFloatTable.
+static void avifLookUpUNormRow(const uint8_t * row,
+                               uint32_t count,
+                               uint32_t depth,
+                               uint16_t maxChannel,
+                               const float * unormFloatTable,
+                               float * out)
+{
+    if (depth == 8) {
+        for (uint32_t i = 0; i < count; ++i) {
+            out[i] = unormFloatTable[row[i]];
+        }
+    } else {
+        const uint16_t * row16 = (const uint16_t *)row;
+        for (uint32_t i = 0; i < count; ++i) {
+            // clamp incoming data to protect against bad LUT lookups
+            out[i] = unormFloatTable[AVIF_MIN(row16[i], maxChannel)];
+        }
+    }
+}
+
+// Converts YUV with AVIF_REFORMAT_MODE_YUV_COEFFICIENTS to RGB, one row at a time. The YUV samples of each row are looked up
+// and upsampled to float rows, which are then converted by the fastest avifYUVToRGBRowFunc available. Handles any YUV and RGB
+// depth, any RGB format, any chroma subsampling and any chroma upsampling. The output is the same as the one of
+// avifImageYUVAnyToRGBAnySlow().
+//
+// Alpha (un)multiply is done in the same pass:
+// * with bilinear upsampling or if rgb has no alpha channel, before rounding, using the alpha plane of image, as
+//   avifImageYUVAnyToRGBAnySlow() does.
+// * otherwise after rounding, using the alpha channel already stored in rgb, as avifRGBImagePremultiplyAlpha() and
+//   avifRGBImageUnpremultiplyAlpha() do without libyuv.
+//
+// If rgb->isFloat is set, the RGB values and the alpha channel already stored in rgb are also converted to half floats in the
+// same pass, as avifRGBImageToF16() does.
+static avifResult avifImageYUVAnyToRGBAnyColor(const avifImage * image,
+                                               avifRGBImage * rgb,
+                                               const avifReformatState * state,
+                                               avifAlphaMultiplyMode alphaMultiplyMode)
+{
+    const uint32_t width = image->width;
+    const uint32_t chromaShiftX = state->yuv.formatInfo.chromaShiftX;
+    const uint32_t chromaShiftY = state->yuv.formatInfo.chromaShiftY;
+    const uint32_t uvWidth = (width + chromaShiftX) >> chromaShiftX;
+    const avifBool bilinear = (image->yuvFormat != AVIF_PIXEL_FORMAT_YUV444) &&
+                              (rgb->chromaUpsampling != AVIF_CHROMA_UPSAMPLING_FASTEST) &&
+                              (rgb->chromaUpsampling != AVIF_CHROMA_UPSAMPLING_NEAREST);
+
+    float * unormFloatTableY = NULL;
+    float * unormFloatTableUV = NULL;
+    AVIF_CHECKERR(avifCreateYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, image->depth, state), AVIF_RESULT_OUT_OF_MEMORY);
+    const avifBool multiplyBeforeRounding = (alphaMultiplyMode != AVIF_ALPHA_MULTIPLY_MODE_NO_OP) &&
+                                            (bilinear || !avifRGBFormatHasAlpha(rgb->format));
+    const avifBool multiplyAfterRounding = (alphaMultiplyMode != AVIF_ALPHA_MULTIPLY_MODE_NO_OP) && !multiplyBeforeRounding;
+
+    const avifBool toF16 = rgb->isFloat;
+    const avifBool hasAlpha = avifRGBFormatHasAlpha(rgb->format);
+    // The multiplier used by avifUNormRowToF16() is a denormal float, which makes each multiplication slow on some CPUs. For
+    // large enough images, all possible values are converted once to a look-up table instead.
+    const size_t f16TableSize = (size_t)1 << rgb->depth;
+    uint16_t * f16Table = NULL;
+    if (toF16 && (rgb->avoidLibYUV || (avifLibYUVVersion() == 0)) &&
+        ((size_t)width * image->height * avifRGBFormatChannelCount(rgb->format) > f16TableSize)) {
+        f16Table = (uint16_t *)avifAlloc(f16TableSize * sizeof(uint16_t));
+        if (!f16Table) {
+            avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, state);
+            return AVIF_RESULT_OUT_OF_MEMORY;
+        }
+        for (size_t i = 0; i < f16TableSize; ++i) {
+            f16Table[i] = (uint16_t)i;
+        }
+        avifUNormRowToF16(f16Table, (uint32_t)f16TableSize, rgb->depth);
+    }
+
+    // Y, Cb, Cr and A rows, two rows of U and V samples each, then R, G, B and A rows.
+    const size_t floatCount = (size_t)width * 4 + (size_t)uvWidth * 4;
+    float * buffer = (float *)avifAlloc(floatCount * sizeof(float) + (size_t)width * 4 * sizeof(uint16_t));
+    if (!buffer) {
+        avifFree(f16Table);
+        avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, state);
+        return AVIF_RESULT_OUT_OF_MEMORY;
+    }
+    float * rowY = buffer;
+    float * rowCb = rowY + width;
+    float * rowCr = rowCb + width;
+    float * rowA = rowCr + width;
+    float * rowU = rowA + width;       // Closest row of U samples.
+    float * rowUAdj = rowU + uvWidth;  // Adjacent row of U samples, for bilinear upsampling.
+    float * rowV = rowUAdj + uvWidth;  // Closest row of V samples.
+    float * rowVAdj = rowV + uvWidth;  // Adjacent row of V samples, for bilinear upsampling.
+    uint16_t * rowR = (uint16_t *)(buffer + floatCount);
+    uint16_t * rowG = rowR + width;
+    uint16_t * rowB = rowG + width;
+    uint16_t * rowAlpha = rowB + width; // Alpha channel of rgb, for the conversion to half floats.
+
+    const avifYUVToRGBRowParams params = { .crToR = 2 * (1 - state->yuv.kr),
+                                           .cbToB = 2 * (1 - state->yuv.kb),
+                                           .crToG = state->yuv.kr * (1 - state->yuv.kr),
+                                           .cbToG = state->yuv.kb * (1 - state->yuv.kb),
+                                           .kg = state->yuv.kg,
+                                           .rgbMaxChannelF = state->rgb.maxChannelF };
+    const avifYUVToRGBRowFunc yuvToRGBRow = avifGetYUVToRGBRowFunc(AVIF_TRUE);
+    const uint16_t yuvMaxChannel = (uint16_t)state->yuv.maxChannel;
+    const uint32_t rgbPixelBytes = state->rgb.pixelBytes;
+    const uint32_t uRowBytes = image->yuvRowBytes[AVIF_CHAN_U];
+    const uint32_t vRowBytes = image->yuvRowBytes[AVIF_CHAN_V];
+
+    for (uint32_t j = 0; j < image->height; ++j) {
+        const uint32_t uvJ = j >> chromaShiftY;
+        const uint8_t * ptrU = &image->yuvPlanes[AVIF_CHAN_U][uvJ * uRowBytes];
+        const uint8_t * ptrV = &image->yuvPlanes[AVIF_CHAN_V][uvJ * vRowBytes];
+        avifLookUpUNormRow(&image->yuvPlanes[AVIF_CHAN_Y][j * image->yuvRowBytes[AVIF_CHAN_Y]],
+                           width,
+                           image->depth,
+                           yuvMaxChannel,
+                           unormFloatTableY,
+                           rowY);
+        avifLookUpUNormRow(ptrU, uvWidth, image->depth, yuvMaxChannel, unormFloatTableUV, rowU);
+        avifLookUpUNormRow(ptrV, uvWidth, image->depth, yuvMaxChannel, unormFloatTableUV, rowV);
+
+        if (!bilinear) {
+            for (uint32_t i = 0; i < width; ++i) {
+                rowCb[i] = rowU[i >> chromaShiftX];
+                rowCr[i] = rowV[i >> chromaShiftX];
+            }
+        } else {
+            // Same sample selection and weights as in avifImageYUVAnyToRGBAnySlow(). With 4:2:2, or on the top and bottom
+            // edges, the adjacent row is the closest row.
+            int adjRow = 0;
+            if ((j != 0) && !((j == (image->height - 1)) && ((j % 2) != 0)) && (image->yuvFormat != AVIF_PIXEL_FORMAT_YUV422)) {
+                adjRow = ((j % 2) != 0) ? 1 : -1;
+            }
+            const uint8_t * ptrUAdj = ptrU + adjRow * (ptrdiff_t)uRowBytes;
+            const uint8_t * ptrVAdj = ptrV + adjRow * (ptrdiff_t)vRowBytes;
+            avifLookUpUNormRow(ptrUAdj, uvWidth, image->depth, yuvMaxChannel, unormFloatTableUV, rowUAdj);
+            avifLookUpUNormRow(ptrVAdj, uvWidth, image->depth, yuvMaxChannel, unormFloatTableUV, rowVAdj);
+            for (uint32_t i = 0; i < width; ++i) {
+                const uint32_t uvI = i >> 1;
+                uint32_t uvIAdj = uvI;
+                if ((i != 0) && !((i == (width - 1)) && ((i % 2) != 0))) {
+                    uvIAdj = ((i % 2) != 0) ? (uvI + 1) : (uvI - 1);
+                }
+                rowCb[i] = (rowU[uvI] * (9.0f / 16.0f)) + (rowU[uvIAdj] * (3.0f / 16.0f)) + (rowUAdj[uvI] * (3.0f / 16.0f)) +
+                           (rowUAdj[uvIAdj] * (1.0f / 16.0f));
+                rowCr[i] = (rowV[uvI] * (9.0f / 16.0f)) + (rowV[uvIAdj] * (3.0f / 16.0f)) + (rowVAdj[uvI] * (3.0f / 16.0f)) +
+                           (rowVAdj[uvIAdj] * (1.0f / 16.0f));
+            }
+        }
+
+        if (multiplyBeforeRounding) {
+            // Same alpha values as in avifImageYUVAnyToRGBAnySlow().
+            const uint8_t * ptrA = &image->alphaPlane[j * image->alphaRowBytes];
+            for (uint32_t i = 0; i < width; ++i) {
+                const uint16_t unormA = (image->depth == 8) ? ptrA[i] : AVIF_MIN(((const uint16_t *)ptrA)[i], yuvMaxChannel);
+                const float A = unormA / ((float)state->yuv.maxChannel);
+                rowA[i] = AVIF_CLAMP(A, 0.0f, 1.0f);
+            }
+            avifYUVToRGBRowAlphaMultiplyC(rowY, rowCb, rowCr, rowA, alphaMultiplyMode, width, &params, rowR, rowG, rowB);
+        } else {
+            yuvToRGBRow(rowY, rowCb, rowCr, width, &params, rowR, rowG, rowB);
+            if (multiplyAfterRounding) {
+                avifRGBRowAlphaMultiply(&rgb->pixels[state->rgb.offsetBytesA + (j * rgb->rowBytes)],
+                                        rgb->depth,
+                                        rgbPixelBytes,
+                                        alphaMultiplyMode,
+                                        width,
+                                        rowR,
+                                        rowG,
+                                        rowB);
+            }
+        }
+
+        uint16_t * ptrAlpha = NULL;
+        if (toF16) {
+            // The R, G, B and A rows are contiguous so they are converted at once.
+            uint32_t channelCount = 3;
+            if (hasAlpha) {
+                ptrAlpha = (uint16_t *)&rgb->pixels[state->rgb.offsetBytesA + (j * rgb->rowBytes)];
+                for (uint32_t i = 0; i < width; ++i) {
+                    rowAlpha[i] = ptrAlpha[i * 4];
+                }
+                channelCount = 4;
+            }
+            const uint32_t count = width * channelCount;
+            avifResult result = AVIF_RESULT_NOT_IMPLEMENTED;
+            if (!rgb->avoidLibYUV) {
+                result = avifUNormRowToF16LibYUV(rowR, count, rgb->depth);
+            }
+            if (result == AVIF_RESULT_NOT_IMPLEMENTED) {
+                if (f16Table) {
+                    for (uint32_t i = 0; i < count; ++i) {
+                        rowR[i] = f16Table[rowR[i]];
+                    }
+                } else {
+                    avifUNormRowToF16(rowR, count, rgb->depth);
+                }
+                result = AVIF_RESULT_OK;
+            }
+            if (result != AVIF_RESULT_OK) {
+                avifFree(buffer);
+                avifFree(f16Table);
+                avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, state);
+                return result;
+            }
+        }
+
+        uint8_t * ptrR = &rgb->pixels[state->rgb.offsetBytesR + (j * rgb->rowBytes)];
+        uint8_t * ptrG = &rgb->pixels[state->rgb.offsetBytesG + (j * rgb->rowBytes)];
+        uint8_t * ptrB = &rgb->pixels[state->rgb.offsetBytesB + (j * rgb->rowBytes)];
+        if (rgb->depth == 8) {
+            for (uint32_t i = 0; i < width; ++i) {
+                avifStoreRGB8Pixel(rgb->format, (uint8_t)rowR[i], (uint8_t)rowG[i], (uint8_t)rowB[i], ptrR, ptrG, ptrB);
+                ptrR += rgbPixelBytes;
+                ptrG += rgbPixelBytes;
+                ptrB += rgbPixelBytes;
+            }
+        } else {
+            for (uint32_t i = 0; i < width; ++i) {
+                *((uint16_t *)ptrR) = rowR[i];
+                *((uint16_t *)ptrG) = rowG[i];
+                *((uint16_t *)ptrB) = rowB[i];
+                ptrR += rgbPixelBytes;
+                ptrG += rgbPixelBytes;
+                ptrB += rgbPixelBytes;
+            }
+            if (ptrAlpha) {
+                for (uint32_t i = 0; i < width; ++i) {
+                    ptrAlpha[i * 4] = rowAlpha[i];
+                }
+            }
+        }
+    }
+    avifFree(buffer);
+    avifFree(f16Table);
+    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, state);
+    return AVIF_RESULT_OK;
+}
+
 // Note: This function handles alpha (un)multiply.
 static avifResult avifImageYUVAnyToRGBAnySlow(const avifImage * image,
                                               avifRGBImage * rgb,
@@ -856,72 +1510,18 @@ static avifResult avifImageYUVAnyToRGBAnySlow(const avifImage * image,
             ptrB += rgbPixelBytes;
         }
     }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV);
+    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, state);
     return AVIF_RESULT_OK;
 }
 
-static avifResult avifImageYUV16ToRGB16Color(const avifImage * image, avifRGBImage * rgb, avifReformatState * state)
+static avifResult avifImageYUV16ToRGB16Mono(const avifImage * image, avifRGBImage * rgb, avifReformatState * state)
 {
     const float kr = state->yuv.kr;
     const float kg = state->yuv.kg;
     const float kb = state->yuv.kb;
     const uint32_t rgbPixelBytes = state->rgb.pixelBytes;
     float * unormFloatTableY = NULL;
-    float * unormFloatTableUV = NULL;
-    AVIF_CHECKERR(avifCreateYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, image->depth, state), AVIF_RESULT_OUT_OF_MEMORY);
-
-    const uint16_t yuvMaxChannel = (uint16_t)state->yuv.maxChannel;
-    const float rgbMaxChannelF = state->rgb.maxChannelF;
-    for (uint32_t j = 0; j < image->height; ++j) {
-        const uint32_t uvJ = j >> state->yuv.formatInfo.chromaShiftY;
-        const uint16_t * const ptrY = (uint16_t *)&image->yuvPlanes[AVIF_CHAN_Y][(j * image->yuvRowBytes[AVIF_CHAN_Y])];
-        const uint16_t * const ptrU = (uint16_t *)&image->yuvPlanes[AVIF_CHAN_U][(uvJ * image->yuvRowBytes[AVIF_CHAN_U])];
-        const uint16_t * const ptrV = (uint16_t *)&image->yuvPlanes[AVIF_CHAN_V][(uvJ * image->yuvRowBytes[AVIF_CHAN_V])];
-        uint8_t * ptrR = &rgb->pixels[state->rgb.offsetBytesR + (j * rgb->rowBytes)];
-        uint8_t * ptrG = &rgb->pixels[state->rgb.offsetBytesG + (j * rgb->rowBytes)];
-        uint8_t * ptrB = &rgb->pixels[state->rgb.offsetBytesB + (j * rgb->rowBytes)];
-
-        for (uint32_t i = 0; i < image->width; ++i) {
-            uint32_t uvI = i >> state->yuv.formatInfo.chromaShiftX;
-
-            // clamp incoming data to protect against bad LUT lookups
-            const uint16_t unormY = AVIF_MIN(ptrY[i], yuvMaxChannel);
-            const uint16_t unormU = AVIF_MIN(ptrU[uvI], yuvMaxChannel);
-            const uint16_t unormV = AVIF_MIN(ptrV[uvI], yuvMaxChannel);
-
-            // Convert unorm to float
-            const float Y = unormFloatTableY[unormY];
-            const float Cb = unormFloatTableUV[unormU];
-            const float Cr = unormFloatTableUV[unormV];
-
-            const float R = Y + (2 * (1 - kr)) * Cr;
-            const float B = Y + (2 * (1 - kb)) * Cb;
-            const float G = Y - ((2 * ((kr * (1 - kr) * Cr) + (kb * (1 - kb) * Cb))) / kg);
-            const float Rc = AVIF_CLAMP(R, 0.0f, 1.0f);
-            const float Gc = AVIF_CLAMP(G, 0.0f, 1.0f);
-            const float Bc = AVIF_CLAMP(B, 0.0f, 1.0f);
-
-            *((uint16_t *)ptrR) = (uint16_t)(0.5f + (Rc * rgbMaxChannelF));
-            *((uint16_t *)ptrG) = (uint16_t)(0.5f + (Gc * rgbMaxChannelF));
-            *((uint16_t *)ptrB) = (uint16_t)(0.5f + (Bc * rgbMaxChannelF));
-
-            ptrR += rgbPixelBytes;
-            ptrG += rgbPixelBytes;
-            ptrB += rgbPixelBytes;
-        }
-    }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV);
-    return AVIF_RESULT_OK;
-}
-
-static avifResult avifImageYUV16ToRGB16Mono(const avifImage * image, avifRGBImage * rgb, avifReformatState * state)
-{
-    const float kr = state->yuv.kr;
-    const float kg = state->yuv.kg;
-    const float kb = state->yuv.kb;
-    const uint32_t rgbPixelBytes = state->rgb.pixelBytes;
-    float * unormFloatTableY = NULL;
-    AVIF_CHECKERR(avifCreateYUVToRGBLookUpTables(&unormFloatTableY, NULL, image->depth, state), AVIF_RESULT_OUT_OF_MEMORY);
+    AVIF_CHECKERR(avifCreateYUVToRGBLookUpTables(&unormFloatTableY, NULL, image->depth, state), AVIF_RESULT_OUT_OF_MEMORY);
 
     const uint16_t maxChannel = (uint16_t)state->yuv.maxChannel;
     const float maxChannelF = state->rgb.maxChannelF;
@@ -956,65 +1556,7 @@ static avifResult avifImageYUV16ToRGB16Mono(const avifImage * image, avifRGBImag
             ptrB += rgbPixelBytes;
         }
     }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, NULL);
-    return AVIF_RESULT_OK;
-}
-
-static avifResult avifImageYUV16ToRGB8Color(const avifImage * image, avifRGBImage * rgb, avifReformatState * state)
-{
-    const float kr = state->yuv.kr;
-    const float kg = state->yuv.kg;
-    const float kb = state->yuv.kb;
-    const uint32_t rgbPixelBytes = state->rgb.pixelBytes;
-    float * unormFloatTableY = NULL;
-    float * unormFloatTableUV = NULL;
-    AVIF_CHECKERR(avifCreateYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, image->depth, state), AVIF_RESULT_OUT_OF_MEMORY);
-
-    const uint16_t yuvMaxChannel = (uint16_t)state->yuv.maxChannel;
-    const float rgbMaxChannelF = state->rgb.maxChannelF;
-    for (uint32_t j = 0; j < image->height; ++j) {
-        const uint32_t uvJ = j >> state->yuv.formatInfo.chromaShiftY;
-        const uint16_t * const ptrY = (uint16_t *)&image->yuvPlanes[AVIF_CHAN_Y][(j * image->yuvRowBytes[AVIF_CHAN_Y])];
-        const uint16_t * const ptrU = (uint16_t *)&image->yuvPlanes[AVIF_CHAN_U][(uvJ * image->yuvRowBytes[AVIF_CHAN_U])];
-        const uint16_t * const ptrV = (uint16_t *)&image->yuvPlanes[AVIF_CHAN_V][(uvJ * image->yuvRowBytes[AVIF_CHAN_V])];
-        uint8_t * ptrR = &rgb->pixels[state->rgb.offsetBytesR + (j * rgb->rowBytes)];
-        uint8_t * ptrG = &rgb->pixels[state->rgb.offsetBytesG + (j * rgb->rowBytes)];
-        uint8_t * ptrB = &rgb->pixels[state->rgb.offsetBytesB + (j * rgb->rowBytes)];
-
-        for (uint32_t i = 0; i < image->width; ++i) {
-            uint32_t uvI = i >> state->yuv.formatInfo.chromaShiftX;
-
-            // clamp incoming data to protect against bad LUT lookups
-            const uint16_t unormY = AVIF_MIN(ptrY[i], yuvMaxChannel);
-            const uint16_t unormU = AVIF_MIN(ptrU[uvI], yuvMaxChannel);
-            const uint16_t unormV = AVIF_MIN(ptrV[uvI], yuvMaxChannel);
-
-            // Convert unorm to float
-            const float Y = unormFloatTableY[unormY];
-            const float Cb = unormFloatTableUV[unormU];
-            const float Cr = unormFloatTableUV[unormV];
-
-            const float R = Y + (2 * (1 - kr)) * Cr;
-            const float B = Y + (2 * (1 - kb)) * Cb;
-            const float G = Y - ((2 * ((kr * (1 - kr) * Cr) + (kb * (1 - kb) * Cb))) / kg);
-            const float Rc = AVIF_CLAMP(R, 0.0f, 1.0f);
-            const float Gc = AVIF_CLAMP(G, 0.0f, 1.0f);
-            const float Bc = AVIF_CLAMP(B, 0.0f, 1.0f);
-
-            avifStoreRGB8Pixel(rgb->format,
-                               (uint8_t)(0.5f + (Rc * rgbMaxChannelF)),
-                               (uint8_t)(0.5f + (Gc * rgbMaxChannelF)),
-                               (uint8_t)(0.5f + (Bc * rgbMaxChannelF)),
-                               ptrR,
-                               ptrG,
-                               ptrB);
-
-            ptrR += rgbPixelBytes;
-            ptrG += rgbPixelBytes;
-            ptrB += rgbPixelBytes;
-        }
-    }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV);
+    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, NULL, state);
     return AVIF_RESULT_OK;
 }
 
@@ -1064,55 +1606,7 @@ static avifResult avifImageYUV16ToRGB8Mono(const avifImage * image, avifRGBImage
             ptrB += rgbPixelBytes;
         }
     }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, NULL);
-    return AVIF_RESULT_OK;
-}
-
-static avifResult avifImageYUV8ToRGB16Color(const avifImage * image, avifRGBImage * rgb, avifReformatState * state)
-{
-    const float kr = state->yuv.kr;
-    const float kg = state->yuv.kg;
-    const float kb = state->yuv.kb;
-    const uint32_t rgbPixelBytes = state->rgb.pixelBytes;
-    float * unormFloatTableY = NULL;
-    float * unormFloatTableUV = NULL;
-    AVIF_CHECKERR(avifCreateYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, image->depth, state), AVIF_RESULT_OUT_OF_MEMORY);
-
-    const float rgbMaxChannelF = state->rgb.maxChannelF;
-    for (uint32_t j = 0; j < image->height; ++j) {
-        const uint32_t uvJ = j >> state->yuv.formatInfo.chromaShiftY;
-        const uint8_t * const ptrY = &image->yuvPlanes[AVIF_CHAN_Y][(j * image->yuvRowBytes[AVIF_CHAN_Y])];
-        const uint8_t * const ptrU = &image->yuvPlanes[AVIF_CHAN_U][(uvJ * image->yuvRowBytes[AVIF_CHAN_U])];
-        const uint8_t * const ptrV = &image->yuvPlanes[AVIF_CHAN_V][(uvJ * image->yuvRowBytes[AVIF_CHAN_V])];
-        uint8_t * ptrR = &rgb->pixels[state->rgb.offsetBytesR + (j * rgb->rowBytes)];
-        uint8_t * ptrG = &rgb->pixels[state->rgb.offsetBytesG + (j * rgb->rowBytes)];
-        uint8_t * ptrB = &rgb->pixels[state->rgb.offsetBytesB + (j * rgb->rowBytes)];
-
-        for (uint32_t i = 0; i < image->width; ++i) {
-            uint32_t uvI = i >> state->yuv.formatInfo.chromaShiftX;
-
-            // Convert unorm to float (no clamp necessary, the full uint8_t range is a legal lookup)
-            const float Y = unormFloatTableY[ptrY[i]];
-            const float Cb = unormFloatTableUV[ptrU[uvI]];
-            const float Cr = unormFloatTableUV[ptrV[uvI]];
-
-            const float R = Y + (2 * (1 - kr)) * Cr;
-            const float B = Y + (2 * (1 - kb)) * Cb;
-            const float G = Y - ((2 * ((kr * (1 - kr) * Cr) + (kb * (1 - kb) * Cb))) / kg);
-            const float Rc = AVIF_CLAMP(R, 0.0f, 1.0f);
-            const float Gc = AVIF_CLAMP(G, 0.0f, 1.0f);
-            const float Bc = AVIF_CLAMP(B, 0.0f, 1.0f);
-
-            *((uint16_t *)ptrR) = (uint16_t)(0.5f + (Rc * rgbMaxChannelF));
-            *((uint16_t *)ptrG) = (uint16_t)(0.5f + (Gc * rgbMaxChannelF));
-            *((uint16_t *)ptrB) = (uint16_t)(0.5f + (Bc * rgbMaxChannelF));
-
-            ptrR += rgbPixelBytes;
-            ptrG += rgbPixelBytes;
-            ptrB += rgbPixelBytes;
-        }
-    }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV);
+    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, NULL, state);
     return AVIF_RESULT_OK;
 }
 
@@ -1154,7 +1648,7 @@ static avifResult avifImageYUV8ToRGB16Mono(const avifImage * image, avifRGBImage
             ptrB += rgbPixelBytes;
         }
     }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, NULL);
+    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, NULL, state);
     return AVIF_RESULT_OK;
 }
 
@@ -1191,58 +1685,6 @@ static avifResult avifImageIdentity8ToRGB8ColorFullRange(const avifImage * image
     return AVIF_RESULT_OK;
 }
 
-static avifResult avifImageYUV8ToRGB8Color(const avifImage * image, avifRGBImage * rgb, avifReformatState * state)
-{
-    const float kr = state->yuv.kr;
-    const float kg = state->yuv.kg;
-    const float kb = state->yuv.kb;
-    const uint32_t rgbPixelBytes = state->rgb.pixelBytes;
-    float * unormFloatTableY = NULL;
-    float * unormFloatTableUV = NULL;
-    AVIF_CHECKERR(avifCreateYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, image->depth, state), AVIF_RESULT_OUT_OF_MEMORY);
-
-    const float rgbMaxChannelF = state->rgb.maxChannelF;
-    for (uint32_t j = 0; j < image->height; ++j) {
-        const uint32_t uvJ = j >> state->yuv.formatInfo.chromaShiftY;
-        const uint8_t * const ptrY = &image->yuvPlanes[AVIF_CHAN_Y][(j * image->yuvRowBytes[AVIF_CHAN_Y])];
-        const uint8_t * const ptrU = &image->yuvPlanes[AVIF_CHAN_U][(uvJ * image->yuvRowBytes[AVIF_CHAN_U])];
-        const uint8_t * const ptrV = &image->yuvPlanes[AVIF_CHAN_V][(uvJ * image->yuvRowBytes[AVIF_CHAN_V])];
-        uint8_t * ptrR = &rgb->pixels[state->rgb.offsetBytesR + (j * rgb->rowBytes)];
-        uint8_t * ptrG = &rgb->pixels[state->rgb.offsetBytesG + (j * rgb->rowBytes)];
-        uint8_t * ptrB = &rgb->pixels[state->rgb.offsetBytesB + (j * rgb->rowBytes)];
-
-        for (uint32_t i = 0; i < image->width; ++i) {
-            uint32_t uvI = i >> state->yuv.formatInfo.chromaShiftX;
-
-            // Convert unorm to float (no clamp necessary, the full uint8_t range is a legal lookup)
-            const float Y = unormFloatTableY[ptrY[i]];
-            const float Cb = unormFloatTableUV[ptrU[uvI]];
-            const float Cr = unormFloatTableUV[ptrV[uvI]];
-
-            const float R = Y + (2 * (1 - kr)) * Cr;
-            const float B = Y + (2 * (1 - kb)) * Cb;
-            const float G = Y - ((2 * ((kr * (1 - kr) * Cr) + (kb * (1 - kb) * Cb))) / kg);
-            const float Rc = AVIF_CLAMP(R, 0.0f, 1.0f);
-            const float Gc = AVIF_CLAMP(G, 0.0f, 1.0f);
-            const float Bc = AVIF_CLAMP(B, 0.0f, 1.0f);
-
-            avifStoreRGB8Pixel(rgb->format,
-                               (uint8_t)(0.5f + (Rc * rgbMaxChannelF)),
-                               (uint8_t)(0.5f + (Gc * rgbMaxChannelF)),
-                               (uint8_t)(0.5f + (Bc * rgbMaxChannelF)),
-                               ptrR,
-                               ptrG,
-                               ptrB);
-
-            ptrR += rgbPixelBytes;
-            ptrG += rgbPixelBytes;
-            ptrB += rgbPixelBytes;
-        }
-    }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV);
-    return AVIF_RESULT_OK;
-}
-
 static avifResult avifImageYUV8ToRGB8Mono(const avifImage * image, avifRGBImage * rgb, avifReformatState * state)
 {
     const float kr = state->yuv.kr;
@@ -1285,20 +1727,10 @@ static avifResult avifImageYUV8ToRGB8Mono(const avifImage * image, avifRGBImage
             ptrB += rgbPixelBytes;
         }
     }
-    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, NULL);
+    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, NULL, state);
     return AVIF_RESULT_OK;
 }
 
-// This constant comes from libyuv. For details, see here:
-// https://chromium.googlesource.com/libyuv/libyuv/+/2f87e9a7/source/row_common.cc#3537
-#define F16_MULTIPLIER 1.9259299444e-34f
-
-typedef union avifF16
-{
-    float f;
-    uint32_t u32;
-} avifF16;
-
 static avifResult avifRGBImageToF16(avifRGBImage * rgb)
 {
     avifResult libyuvResult = AVIF_RESULT_NOT_IMPLEMENTED;
@@ -1309,34 +1741,41 @@ static avifResult avifRGBImageToF16(avifRGBImage * rgb)
         return libyuvResult;
     }
     const uint32_t channelCount = avifRGBFormatChannelCount(rgb->format);
-    const float scale = 1.0f / ((1 << rgb->depth) - 1);
-    const float multiplier = F16_MULTIPLIER * scale;
-    uint16_t * pixelRowBase = (uint16_t *)rgb->pixels;
-    const uint32_t stride = rgb->rowBytes >> 1;
     for (uint32_t j = 0; j < rgb->height; ++j) {
-        uint16_t * pixel = pixelRowBase;
-        for (uint32_t i = 0; i < rgb->width * channelCount; ++i, ++pixel) {
-            avifF16 f16;
-            f16.f = *pixel * multiplier;
-            *pixel = (uint16_t)(f16.u32 >> 13);
-        }
-        pixelRowBase += stride;
+        uint16_t * pixelRow = (uint16_t *)&rgb->pixels[(size_t)j * rgb->rowBytes];
+        avifUNormRowToF16(pixelRow, rgb->width * channelCount, rgb->depth);
     }
     return AVIF_RESULT_OK;
 }
 
+// Returns AVIF_TRUE if avifRGBImagePremultiplyAlpha() and avifRGBImageUnpremultiplyAlpha() would use libyuv for rgb.
+static avifBool avifRGBImageAlphaMultiplyUsesLibYUV(const avifRGBImage * rgb)
+{
+    return (avifLibYUVVersion() != 0) && (rgb->depth == 8) &&
+           ((rgb->format == AVIF_RGB_FORMAT_RGBA) || (rgb->format == AVIF_RGB_FORMAT_BGRA)) && (rgb->width <= INT_MAX) &&
+           (rgb->height <= INT_MAX) && (rgb->rowBytes <= INT_MAX);
+}
+
 static avifResult avifImageYUVToRGBImpl(const avifImage * image, avifRGBImage * rgb, avifReformatState * state, avifAlphaMultiplyMode alphaMultiplyMode)
 {
     avifBool convertedWithLibYUV = AVIF_FALSE;
+    // Set if avifImageYUVAnyToRGBAnyColor() converted the pixels to half floats (F16) in the same pass.
+    avifBool convertedToF16 = AVIF_FALSE;
     // Reformat alpha, if user asks for it, or (un)multiply processing needs it.
     avifBool reformatAlpha = avifRGBFormatHasAlpha(rgb->format) &&
                              (!rgb->ignoreAlpha || (alphaMultiplyMode != AVIF_ALPHA_MULTIPLY_MODE_NO_OP));
     // This value is used only when reformatAlpha is true.
     avifBool alphaReformattedWithLibYUV = AVIF_FALSE;
     if (!rgb->avoidLibYUV && ((alphaMultiplyMode == AVIF_ALPHA_MULTIPLY_MODE_NO_OP) || avifRGBFormatHasAlpha(rgb->format))) {
-        avifResult libyuvResult = avifImageYUVToRGBLibYUV(image, rgb, reformatAlpha, &alphaReformattedWithLibYUV);
+        const avifBool premultiplyAlpha = (alphaMultiplyMode == AVIF_ALPHA_MULTIPLY_MODE_MULTIPLY);
+        avifResult libyuvResult =
+            avifImageYUVToRGBLibYUV(image, rgb, reformatAlpha, &alphaReformattedWithLibYUV, premultiplyAlpha);
         if (libyuvResult == AVIF_RESULT_OK) {
             convertedWithLibYUV = AVIF_TRUE;
+            if (premultiplyAlpha && alphaReformattedWithLibYUV) {
+                // libyuv premultiplied the color channels while copying the alpha channel.
+                alphaMultiplyMode = AVIF_ALPHA_MULTIPLY_MODE_NO_OP;
+            }
         } else {
             if (libyuvResult != AVIF_RESULT_NOT_IMPLEMENTED) {
                 return libyuvResult;
@@ -1383,10 +1822,9 @@ static avifResult avifImageYUVToRGBImpl(const avifImage * image, avifRGBImage *
              ((rgb->chromaUpsampling == AVIF_CHROMA_UPSAMPLING_FASTEST) || (rgb->chromaUpsampling == AVIF_CHROMA_UPSAMPLING_NEAREST))) &&
             (alphaMultiplyMode == AVIF_ALPHA_MULTIPLY_MODE_NO_OP || avifRGBFormatHasAlpha(rgb->format))) {
             // Explanations on the above conditional:
-            // * None of these fast paths currently support bilinear upsampling, so avoid all of them
-            //   unless the YUV data isn't subsampled or they explicitly requested AVIF_CHROMA_UPSAMPLING_NEAREST.
-            // * None of these fast paths currently handle alpha (un)multiply, so avoid all of them
-            //   if we can't do alpha (un)multiply as a separated post step (destination format doesn't have alpha).
+            // * Only avifImageYUVAnyToRGBAnyColor() supports bilinear upsampling, see the else branch below.
+            // * Except for avifImageYUVAnyToRGBAnyColor(), these fast paths do not handle alpha (un)multiply, so avoid all
+            //   of them if we can't do alpha (un)multiply as a separated post step (destination format doesn't have alpha).
 
             if (state->yuv.mode == AVIF_REFORMAT_MODE_IDENTITY) {
                 if ((image->depth == 8) && (rgb->depth == 8) && (image->yuvFormat == AVIF_PIXEL_FORMAT_YUV444) &&
@@ -1396,48 +1834,44 @@ static avifResult avifImageYUVToRGBImpl(const avifImage * image, avifRGBImage *
 
                 // TODO: Add more fast paths for identity
             } else if (state->yuv.mode == AVIF_REFORMAT_MODE_YUV_COEFFICIENTS) {
-                if (image->depth > 8) {
+                if (hasColor) {
+                    // Fuse the alpha (un)multiply post step into the conversion, unless that step would use libyuv, whose
+                    // rounding differs.
+                    const avifAlphaMultiplyMode fusedAlphaMultiplyMode =
+                        avifRGBImageAlphaMultiplyUsesLibYUV(rgb) ? AVIF_ALPHA_MULTIPLY_MODE_NO_OP : alphaMultiplyMode;
+                    convertResult = avifImageYUVAnyToRGBAnyColor(image, rgb, state, fusedAlphaMultiplyMode);
+                    if (fusedAlphaMultiplyMode != AVIF_ALPHA_MULTIPLY_MODE_NO_OP) {
+                        alphaMultiplyMode = AVIF_ALPHA_MULTIPLY_MODE_NO_OP;
+                    }
+                    convertedToF16 = rgb->isFloat;
+                } else if (image->depth > 8) {
                     // yuv:u16
 
                     if (rgb->depth > 8) {
                         // yuv:u16, rgb:u16
-
-                        if (hasColor) {
-                            convertResult = avifImageYUV16ToRGB16Color(image, rgb, state);
-                        } else {
-                            convertResult = avifImageYUV16ToRGB16Mono(image, rgb, state);
-                        }
+                        convertResult = avifImageYUV16ToRGB16Mono(image, rgb, state);
                     } else {
                         // yuv:u16, rgb:u8
-
-                        if (hasColor) {
-                            convertResult = avifImageYUV16ToRGB8Color(image, rgb, state);
-                        } else {
-                            convertResult = avifImageYUV16ToRGB8Mono(image, rgb, state);
-                        }
+                        convertResult = avifImageYUV16ToRGB8Mono(image, rgb, state);
                     }
                 } else {
                     // yuv:u8
 
                     if (rgb->depth > 8) {
                         // yuv:u8, rgb:u16
-
-                        if (hasColor) {
-                            convertResult = avifImageYUV8ToRGB16Color(image, rgb, state);
-                        } else {
-                            convertResult = avifImageYUV8ToRGB16Mono(image, rgb, state);
-                        }
+                        convertResult = avifImageYUV8ToRGB16Mono(image, rgb, state);
                     } else {
                         // yuv:u8, rgb:u8
-
-                        if (hasColor) {
-                            convertResult = avifImageYUV8ToRGB8Color(image, rgb, state);
-                        } else {
-                            convertResult = avifImageYUV8ToRGB8Mono(image, rgb, state);
-                        }
+                        convertResult = avifImageYUV8ToRGB8Mono(image, rgb, state);
                     }
                 }
             }
+        } else if (hasColor && (state->yuv.mode == AVIF_REFORMAT_MODE_YUV_COEFFICIENTS)) {
+            // Bilinear upsampling of subsampled chroma, or alpha (un)multiply into a destination format without alpha. Alpha
+            // (un)multiply is done in the same pass, like avifImageYUVAnyToRGBAnySlow() does.
+            convertResult = avifImageYUVAnyToRGBAnyColor(image, rgb, state, alphaMultiplyMode);
+            alphaMultiplyMode = AVIF_ALPHA_MULTIPLY_MODE_NO_OP;
+            convertedToF16 = rgb->isFloat;
         }
 
         if (convertResult == AVIF_RESULT_NOT_IMPLEMENTED) {
@@ -1453,6 +1887,10 @@ static avifResult avifImageYUVToRGBImpl(const avifImage * image, avifRGBImage *
         }
     }
 
+    // The alpha (un)multiply step below must not run on half floats. It is always done by avifImageYUVAnyToRGBAnyColor() for
+    // 16-bit RGB, the only depth allowed with isFloat.
+    AVIF_ASSERT_OR_RETURN(!convertedToF16 || (alphaMultiplyMode == AVIF_ALPHA_MULTIPLY_MODE_NO_OP));
+
     // Process alpha premultiplication, if necessary
     if (alphaMultiplyMode == AVIF_ALPHA_MULTIPLY_MODE_MULTIPLY) {
         avifResult result = avifRGBImagePremultiplyAlpha(rgb);
@@ -1467,7 +1905,7 @@ static avifResult avifImageYUVToRGBImpl(const avifImage * image, avifRGBImage *
     }
 
     // Convert pixels to half floats (F16), if necessary.
-    if (rgb->isFloat) {
+    if (rgb->isFloat && !convertedToF16) {
         return avifRGBImageToF16(rgb);
     }
 
@@ -1476,72 +1914,79 @@ static avifResult avifImageYUVToRGBImpl(const avifImage * image, avifRGBImage *
 
 typedef struct
 {
-#if defined(_WIN32)
-    HANDLE thread;
-#else
-    pthread_t thread;
-#endif
     avifImage image;
     avifRGBImage rgb;
     avifReformatState * state;
     avifAlphaMultiplyMode alphaMultiplyMode;
+    // Set when the chroma upsampling filter reads the chroma rows above and below each output row. In that case the first and
+    // last rows of the job depend on chroma samples outside of the job and are converted again with enough context.
+    avifBool hasVerticalChromaDependency;
+    const avifImage * fullImage;
+    uint32_t startRow; // Relative to fullImage.
     avifResult result;
-    avifBool threadCreated;
 } YUVToRGBThreadData;
 
-#if defined(_WIN32)
-static unsigned int __stdcall avifImageYUVToRGBThreadWorker(void * arg)
-#else
-static void * avifImageYUVToRGBThreadWorker(void * arg)
-#endif
-{
-    YUVToRGBThreadData * data = (YUVToRGBThreadData *)arg;
-    data->result = avifImageYUVToRGBImpl(&data->image, &data->rgb, data->state, data->alphaMultiplyMode);
-#if defined(_WIN32)
-    return 0;
-#else
-    return NULL;
-#endif
-}
-
-static avifBool avifCreateYUVToRGBThread(YUVToRGBThreadData * tdata)
+// Converts the row y of data->fullImage, which must be one of the rows of data->rgb, using the chroma rows around it. The
+// conversion happens on a window of up to four Y rows starting at an even row, in which the row y is never the first or the
+// last row unless it is also the first or the last row of data->fullImage, so that the result matches the conversion of the
+// whole image. scratch is a buffer of at least four RGB rows.
+static avifResult avifImageYUVToRGBRowWithContext(YUVToRGBThreadData * data,
+                                                  uint32_t y,
+                                                  uint8_t * scratch,
+                                                  uint32_t scratchRowBytes)
 {
-#if defined(_WIN32)
-    tdata->thread = (HANDLE)_beginthreadex(/*security=*/NULL,
-                                           /*stack_size=*/0,
-                                           &avifImageYUVToRGBThreadWorker,
-                                           tdata,
-                                           /*initflag=*/0,
-                                           /*thrdaddr=*/NULL);
-    return tdata->thread != NULL;
-#else
-    // TODO: Set the thread name for ease of debugging.
-    return pthread_create(&tdata->thread, NULL, &avifImageYUVToRGBThreadWorker, tdata) == 0;
-#endif
-}
-
-static avifBool avifJoinYUVToRGBThread(YUVToRGBThreadData * tdata)
-{
-#if defined(_WIN32)
-    return WaitForSingleObject(tdata->thread, INFINITE) == WAIT_OBJECT_0 && CloseHandle(tdata->thread) != 0;
-#else
-    return pthread_join(tdata->thread, NULL) == 0;
-#endif
+    const avifImage * fullImage = data->fullImage;
+    const uint32_t windowY = (y == 0) ? 0 : ((y - 1) & ~1u);
+    const uint32_t windowHeight = AVIF_MIN(4u, fullImage->height - windowY);
+    const avifCropRect rect = { .x = 0, .y = windowY, .width = fullImage->width, .height = windowHeight };
+    avifImage window;
+    memset(&window, 0, sizeof(window));
+    AVIF_CHECKERR(avifImageSetViewRect(&window, data->fullImage, &rect) == AVIF_RESULT_OK, AVIF_RESULT_REFORMAT_FAILED);
+
+    avifRGBImage windowRGB = data->rgb;
+    windowRGB.height = rect.height;
+    windowRGB.pixels = scratch;
+    windowRGB.rowBytes = scratchRowBytes;
+    AVIF_CHECKRES(avifImageYUVToRGBImpl(&window, &windowRGB, data->state, data->alphaMultiplyMode));
+
+    memcpy(&data->rgb.pixels[(size_t)(y - data->startRow) * data->rgb.rowBytes],
+           &scratch[(size_t)(y - windowY) * scratchRowBytes],
+           scratchRowBytes);
+    return AVIF_RESULT_OK;
 }
 
-avifResult avifImageYUVToRGB(const avifImage * image, avifRGBImage * rgb)
+static void avifImageYUVToRGBThreadWorker(void * arg)
 {
-    // It is okay for rgb->maxThreads to be equal to zero in order to allow clients to zero initialize the avifRGBImage struct
-    // with memset.
-    if (!image->yuvPlanes[AVIF_CHAN_Y] || rgb->maxThreads < 0) {
-        return AVIF_RESULT_REFORMAT_FAILED;
+    YUVToRGBThreadData * data = (YUVToRGBThreadData *)arg;
+    data->result = avifImageYUVToRGBImpl(&data->image, &data->rgb, data->state, data->alphaMultiplyMode);
+    if (data->result != AVIF_RESULT_OK || !data->hasVerticalChromaDependency) {
+        return;
     }
 
-    avifReformatState state;
-    if (!avifPrepareReformatState(image, rgb, &state)) {
-        return AVIF_RESULT_REFORMAT_FAILED;
+    // The rows next to the borders between jobs were converted as if they were at the top or bottom edge of the image.
+    // Convert them again, reading one extra chroma row of context from the neighboring job.
+    const avifBool fixFirstRow = data->startRow > 0;
+    const avifBool fixLastRow = data->startRow + data->image.height < data->fullImage->height;
+    if (!fixFirstRow && !fixLastRow) {
+        return;
+    }
+    const uint32_t scratchRowBytes = data->rgb.width * avifRGBImagePixelSize(&data->rgb);
+    uint8_t * scratch = (uint8_t *)avifAlloc((size_t)scratchRowBytes * 4);
+    if (!scratch) {
+        data->result = AVIF_RESULT_OUT_OF_MEMORY;
+        return;
+    }
+    if (fixFirstRow) {
+        data->result = avifImageYUVToRGBRowWithContext(data, data->startRow, scratch, scratchRowBytes);
     }
+    if (data->result == AVIF_RESULT_OK && fixLastRow) {
+        data->result = avifImageYUVToRGBRowWithContext(data, data->startRow + data->image.height - 1, scratch, scratchRowBytes);
+    }
+    avifFree(scratch);
+}
 
+static avifAlphaMultiplyMode avifGetAlphaMultiplyMode(const avifImage * image, const avifRGBImage * rgb)
+{
     avifAlphaMultiplyMode alphaMultiplyMode = AVIF_ALPHA_MULTIPLY_MODE_NO_OP;
     if (image->alphaPlane) {
         if (!avifRGBFormatHasAlpha(rgb->format) || rgb->ignoreAlpha) {
@@ -1558,21 +2003,40 @@ avifResult avifImageYUVToRGB(const avifImage * image, avifRGBImage * rgb)
             }
         }
     }
+    return alphaMultiplyMode;
+}
+
+// Returns true if the yuv format is 420 and chromaUpsampling could be BILINEAR, in which case the conversion of each row reads
+// the chroma rows above and below it.
+static avifBool avifHasVerticalChromaDependency(const avifImage * image, const avifRGBImage * rgb)
+{
+    const avifChromaUpsampling upsampling = rgb->chromaUpsampling;
+    return image->yuvFormat == AVIF_PIXEL_FORMAT_YUV420 && image->yuvPlanes[AVIF_CHAN_U] && image->yuvPlanes[AVIF_CHAN_V] &&
+           (upsampling == AVIF_CHROMA_UPSAMPLING_AUTOMATIC || upsampling == AVIF_CHROMA_UPSAMPLING_BEST_QUALITY ||
+            upsampling == AVIF_CHROMA_UPSAMPLING_BILINEAR);
+}
+
+// state must have been prepared by avifPrepareReformatState() for image and rgb, or for images with the same properties.
+static avifResult avifImageYUVToRGBWithState(const avifImage * image, avifRGBImage * rgb, avifReformatState * state)
+{
+    // It is okay for rgb->maxThreads to be equal to zero in order to allow clients to zero initialize the avifRGBImage struct
+    // with memset.
+    if (!image->yuvPlanes[AVIF_CHAN_Y] || rgb->maxThreads < 0) {
+        return AVIF_RESULT_REFORMAT_FAILED;
+    }
+
+    const avifAlphaMultiplyMode alphaMultiplyMode = avifGetAlphaMultiplyMode(image, rgb);
 
     // In practice, we rarely need more than 8 threads for YUV to RGB conversion.
     uint32_t jobs = AVIF_CLAMP(rgb->maxThreads, 1, 8);
 
-    // When yuv format is 420 and chromaUpsampling could be BILINEAR, there is a dependency across the horizontal borders of each
-    // job. So we disallow multithreading in that case.
-    if (image->yuvFormat == AVIF_PIXEL_FORMAT_YUV420 && (rgb->chromaUpsampling == AVIF_CHROMA_UPSAMPLING_AUTOMATIC ||
-                                                         rgb->chromaUpsampling == AVIF_CHROMA_UPSAMPLING_BEST_QUALITY ||
-                                                         rgb->chromaUpsampling == AVIF_CHROMA_UPSAMPLING_BILINEAR)) {
-        jobs = 1;
-    }
+    // When there is a vertical chroma dependency, the rows along the horizontal borders of each job are fixed up by each job once
+    // its own rows are converted.
+    const avifBool hasVerticalChromaDependency = avifHasVerticalChromaDependency(image, rgb);
 
     // Each thread worker needs at least 2 Y rows (to account for potential U/V subsampling).
     if (jobs == 1 || (image->height / 2) < jobs) {
-        return avifImageYUVToRGBImpl(image, rgb, &state, alphaMultiplyMode);
+        return avifImageYUVToRGBImpl(image, rgb, state, alphaMultiplyMode);
     }
 
     const size_t byteCount = sizeof(YUVToRGBThreadData) * jobs;
@@ -1588,48 +2052,161 @@ avifResult avifImageYUVToRGB(const avifImage * image, avifRGBImage * rgb)
     }
     const uint32_t rowsForLastJob = image->height - rowsPerJob * (jobs - 1);
     uint32_t startRow = 0;
-    uint32_t i;
-    for (i = 0; i < jobs; ++i, startRow += rowsPerJob) {
+    for (uint32_t i = 0; i < jobs; ++i, startRow += rowsPerJob) {
         YUVToRGBThreadData * tdata = &threadData[i];
         const avifCropRect rect = { .x = 0, .y = startRow, .width = image->width, .height = (i == jobs - 1) ? rowsForLastJob : rowsPerJob };
         if (avifImageSetViewRect(&tdata->image, image, &rect) != AVIF_RESULT_OK) {
-            tdata->result = AVIF_RESULT_REFORMAT_FAILED;
-            break;
+            avifFree(threadData);
+            return AVIF_RESULT_REFORMAT_FAILED;
         }
 
         tdata->rgb = *rgb;
         tdata->rgb.pixels += startRow * (size_t)rgb->rowBytes;
         tdata->rgb.height = tdata->image.height;
 
-        tdata->state = &state;
+        tdata->state = state;
         tdata->alphaMultiplyMode = alphaMultiplyMode;
-
-        if (i > 0) {
-            tdata->threadCreated = avifCreateYUVToRGBThread(tdata);
-            if (!tdata->threadCreated) {
-                tdata->result = AVIF_RESULT_REFORMAT_FAILED;
-                break;
-            }
-        }
-    }
-    // If above loop ran successfully, run the first job in the current thread.
-    if (i == jobs) {
-        avifImageYUVToRGBThreadWorker(&threadData[0]);
+        tdata->hasVerticalChromaDependency = hasVerticalChromaDependency;
+        tdata->fullImage = image;
+        tdata->startRow = startRow;
     }
     avifResult result = AVIF_RESULT_OK;
-    for (i = 0; i < jobs; ++i) {
-        YUVToRGBThreadData * tdata = &threadData[i];
-        if (tdata->threadCreated && !avifJoinYUVToRGBThread(tdata)) {
-            result = AVIF_RESULT_REFORMAT_FAILED;
-        }
-        if (tdata->result != AVIF_RESULT_OK) {
-            result = tdata->result;
+    if (!avifRunInParallel(rgb->threadPool, avifImageYUVToRGBThreadWorker, threadData, sizeof(YUVToRGBThreadData), jobs)) {
+        result = AVIF_RESULT_REFORMAT_FAILED;
+    }
+    for (uint32_t i = 0; i < jobs; ++i) {
+        if (threadData[i].result != AVIF_RESULT_OK) {
+            result = threadData[i].result;
         }
     }
     avifFree(threadData);
     return result;
 }
 
+avifResult avifImageYUVToRGB(const avifImage * image, avifRGBImage * rgb)
+{
+    avifReformatState state;
+    if (!avifPrepareReformatState(image, rgb, &state)) {
+        return AVIF_RESULT_REFORMAT_FAILED;
+    }
+    return avifImageYUVToRGBWithState(image, rgb, &state);
+}
+
+avifResult avifImageYUVToRGBRows(const avifImage * image, avifRGBImage * rgb, uint32_t startRow, uint32_t rowCount)
+{
+    if (!image->yuvPlanes[AVIF_CHAN_Y]) {
+        return AVIF_RESULT_REFORMAT_FAILED;
+    }
+    AVIF_CHECKERR(rgb->pixels && rgb->width == image->width && rgb->height == rowCount, AVIF_RESULT_INVALID_ARGUMENT);
+    AVIF_CHECKERR(rowCount > 0 && startRow < image->height && rowCount <= image->height - startRow, AVIF_RESULT_INVALID_ARGUMENT);
+    AVIF_CHECKERR(rgb->rowBytes >= rgb->width * avifRGBImagePixelSize(rgb), AVIF_RESULT_INVALID_ARGUMENT);
+
+    avifReformatState state;
+    if (!avifPrepareReformatState(image, rgb, &state)) {
+        return AVIF_RESULT_REFORMAT_FAILED;
+    }
+
+    // The stripe is converted like a job of avifImageYUVToRGBWithState(), except that it may start at an odd row.
+    YUVToRGBThreadData data;
+    memset(&data, 0, sizeof(data));
+    data.rgb = *rgb;
+    data.state = &state;
+    data.alphaMultiplyMode = avifGetAlphaMultiplyMode(image, rgb);
+    data.hasVerticalChromaDependency = avifHasVerticalChromaDependency(image, rgb);
+    data.fullImage = image;
+    data.startRow = startRow;
+
+    uint32_t viewStartRow = startRow;
+    avifPixelFormatInfo info;
+    avifGetPixelFormatInfo(image->yuvFormat, &info);
+    if ((startRow % 2) && !info.monochrome && info.chromaShiftY) {
+        // A view cannot start in the middle of a subsampled chroma row. Convert the first row on its own, with the rows
+        // around it.
+        const uint32_t scratchRowBytes = rgb->width * avifRGBImagePixelSize(rgb);
+        uint8_t * scratch = (uint8_t *)avifAlloc((size_t)scratchRowBytes * 4);
+        AVIF_CHECKERR(scratch != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+        const avifResult result = avifImageYUVToRGBRowWithContext(&data, startRow, scratch, scratchRowBytes);
+        avifFree(scratch);
+        AVIF_CHECKRES(result);
+        ++viewStartRow;
+        if (viewStartRow == startRow + rowCount) {
+            return AVIF_RESULT_OK;
+        }
+    }
+
+    const avifCropRect rect = { .x = 0, .y = viewStartRow, .width = image->width, .height = startRow + rowCount - viewStartRow };
+    AVIF_CHECKERR(avifImageSetViewRect(&data.image, image, &rect) == AVIF_RESULT_OK, AVIF_RESULT_REFORMAT_FAILED);
+    data.rgb.pixels += (size_t)(viewStartRow - startRow) * rgb->rowBytes;
+    data.rgb.height = rect.height;
+    data.startRow = viewStartRow;
+    // The worker converts the rows at the top and bottom edges of the stripe again with the chroma rows outside of the stripe.
+    avifImageYUVToRGBThreadWorker(&data);
+    return data.result;
+}
+
+struct avifRGBConverter
+{
+    avifReformatState state;
+
+    // Properties of the template avifImage and avifRGBImage that state depends on.
+    uint32_t yuvDepth;
+    avifPixelFormat yuvFormat;
+    avifRange yuvRange;
+    avifColorPrimaries colorPrimaries;
+    avifMatrixCoefficients matrixCoefficients;
+    uint32_t rgbDepth;
+    avifRGBFormat rgbFormat;
+    avifBool rgbIsFloat;
+};
+
+avifRGBConverter * avifRGBConverterCreate(const avifImage * image, const avifRGBImage * rgb)
+{
+    avifRGBConverter * converter = (avifRGBConverter *)avifAlloc(sizeof(avifRGBConverter));
+    if (converter == NULL) {
+        return NULL;
+    }
+    memset(converter, 0, sizeof(avifRGBConverter));
+    avifReformatState * state = &converter->state;
+    if (!avifPrepareReformatState(image, rgb, state) ||
+        !avifCreateYUVToRGBLookUpTables(&state->unormFloatTableY, &state->unormFloatTableUV, image->depth, state)) {
+        avifFree(converter);
+        return NULL;
+    }
+    converter->yuvDepth = image->depth;
+    converter->yuvFormat = image->yuvFormat;
+    converter->yuvRange = image->yuvRange;
+    converter->colorPrimaries = image->colorPrimaries;
+    converter->matrixCoefficients = image->matrixCoefficients;
+    converter->rgbDepth = rgb->depth;
+    converter->rgbFormat = rgb->format;
+    converter->rgbIsFloat = rgb->isFloat;
+    return converter;
+}
+
+void avifRGBConverterDestroy(avifRGBConverter * converter)
+{
+    if (converter == NULL) {
+        return;
+    }
+    float * unormFloatTableY = converter->state.unormFloatTableY;
+    float * unormFloatTableUV = converter->state.unormFloatTableUV;
+    converter->state.unormFloatTableY = NULL;
+    converter->state.unormFloatTableUV = NULL;
+    avifFreeYUVToRGBLookUpTables(&unormFloatTableY, &unormFloatTableUV, &converter->state);
+    avifFree(converter);
+}
+
+avifResult avifRGBConverterConvert(avifRGBConverter * converter, const avifImage * image, avifRGBImage * rgb)
+{
+    if ((image->depth != converter->yuvDepth) || (image->yuvFormat != converter->yuvFormat) ||
+        (image->yuvRange != converter->yuvRange) || (image->colorPrimaries != converter->colorPrimaries) ||
+        (image->matrixCoefficients != converter->matrixCoefficients) || (rgb->depth != converter->rgbDepth) ||
+        (rgb->format != converter->rgbFormat) || (rgb->isFloat != converter->rgbIsFloat)) {
+        return AVIF_RESULT_INVALID_ARGUMENT;
+    }
+    return avifImageYUVToRGBWithState(image, rgb, &converter->state);
+}
+
 // Limited -> Full
 // Plan: subtract limited offset, then multiply by ratio of FULLSIZE/LIMITEDSIZE (rounding), then clamp.
 // RATIO = (FULLY - 0) / (MAXLIMITEDY - MINLIMITEDY)
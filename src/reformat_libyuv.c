@@ -12,11 +12,16 @@ avifResult avifImageRGBToYUVLibYUV(avifImage * image, const avifRGBImage * rgb)
     (void)rgb;
     return AVIF_RESULT_NOT_IMPLEMENTED;
 }
-avifResult avifImageYUVToRGBLibYUV(const avifImage * image, avifRGBImage * rgb, avifBool reformatAlpha, avifBool * alphaReformattedWithLibYUV)
+avifResult avifImageYUVToRGBLibYUV(const avifImage * image,
+                                   avifRGBImage * rgb,
+                                   avifBool reformatAlpha,
+                                   avifBool * alphaReformattedWithLibYUV,
+                                   avifBool premultiplyAlpha)
 {
     (void)image;
     (void)rgb;
     (void)reformatAlpha;
+    (void)premultiplyAlpha;
     *alphaReformattedWithLibYUV = AVIF_FALSE;
     return AVIF_RESULT_NOT_IMPLEMENTED;
 }
@@ -35,6 +40,13 @@ avifResult avifRGBImageToF16LibYUV(avifRGBImage * rgb)
     (void)rgb;
     return AVIF_RESULT_NOT_IMPLEMENTED;
 }
+avifResult avifUNormRowToF16LibYUV(uint16_t * row, uint32_t count, uint32_t depth)
+{
+    (void)row;
+    (void)count;
+    (void)depth;
+    return AVIF_RESULT_NOT_IMPLEMENTED;
+}
 unsigned int avifLibYUVVersion(void)
 {
     return 0;
@@ -914,7 +926,11 @@ static avifResult avifImageDownshiftTo8bpc(const avifImage * image, avifImage *
     return AVIF_RESULT_OK;
 }
 
-IGNORE_CFI_ICALL avifResult avifImageYUVToRGBLibYUV(const avifImage * image, avifRGBImage * rgb, avifBool reformatAlpha, avifBool * alphaReformattedWithLibYUV)
+IGNORE_CFI_ICALL avifResult avifImageYUVToRGBLibYUV(const avifImage * image,
+                                                    avifRGBImage * rgb,
+                                                    avifBool reformatAlpha,
+                                                    avifBool * alphaReformattedWithLibYUV,
+                                                    avifBool premultiplyAlpha)
 {
     *alphaReformattedWithLibYUV = AVIF_FALSE;
     // The width, height, and stride parameters of libyuv functions are all of the int type.
@@ -942,6 +958,8 @@ IGNORE_CFI_ICALL avifResult avifImageYUVToRGBLibYUV(const avifImage * image, avi
         // If the image does not have an alpha plane, then libyuv always prefills the output RGB image with opaque alpha values.
         *alphaReformattedWithLibYUV = AVIF_TRUE;
     }
+    // The YUVA functions premultiply the color channels in the same pass when attenuate is not zero, as ARGBAttenuate() does.
+    const int attenuate = premultiplyAlpha ? 1 : 0;
     avifBool isYVU = lutIsYVU[rgb->format];
     const struct YuvConstants * matrix = isYVU ? matrixYVU : matrixYUV;
     int libyuvResult = -1;
@@ -978,7 +996,7 @@ IGNORE_CFI_ICALL avifResult avifImageYUVToRGBLibYUV(const avifImage * image, avi
                                                              matrix,
                                                              image->width,
                                                              image->height,
-                                                             /*attenuate=*/0,
+                                                             attenuate,
                                                              filter);
         *alphaReformattedWithLibYUV = AVIF_TRUE;
     } else if (lcf.yuvToRgbMatrixHighBitDepth != NULL) {
@@ -1007,7 +1025,7 @@ IGNORE_CFI_ICALL avifResult avifImageYUVToRGBLibYUV(const avifImage * image, avi
                                                        matrix,
                                                        image->width,
                                                        image->height,
-                                                       /*attentuate=*/0);
+                                                       attenuate);
         *alphaReformattedWithLibYUV = AVIF_TRUE;
     } else {
         avifImage image8;
@@ -1052,7 +1070,7 @@ IGNORE_CFI_ICALL avifResult avifImageYUVToRGBLibYUV(const avifImage * image, avi
                                                      matrix,
                                                      image->width,
                                                      image->height,
-                                                     /*attenuate=*/0,
+                                                     attenuate,
                                                      filter);
             *alphaReformattedWithLibYUV = AVIF_TRUE;
         } else if (lcf.yuvToRgbMatrix != NULL) {
@@ -1081,7 +1099,7 @@ IGNORE_CFI_ICALL avifResult avifImageYUVToRGBLibYUV(const avifImage * image, avi
                                                matrix,
                                                image->width,
                                                image->height,
-                                               /*attenuate=*/0);
+                                               attenuate);
             *alphaReformattedWithLibYUV = AVIF_TRUE;
         }
         if (inputIsHighBitDepth) {
@@ -1163,6 +1181,18 @@ avifResult avifRGBImageToF16LibYUV(avifRGBImage * rgb)
     return (result == 0) ? AVIF_RESULT_OK : AVIF_RESULT_INVALID_ARGUMENT;
 }
 
+avifResult avifUNormRowToF16LibYUV(uint16_t * row, uint32_t count, uint32_t depth)
+{
+    // The width and stride parameters of libyuv functions are of the int type.
+    if (count > INT_MAX / sizeof(uint16_t)) {
+        return AVIF_RESULT_NOT_IMPLEMENTED;
+    }
+    const float scale = 1.0f / ((1 << depth) - 1);
+    const int stride = (int)(count * sizeof(uint16_t));
+    const int result = HalfFloatPlane(row, stride, row, stride, scale, (int)count, 1);
+    return (result == 0) ? AVIF_RESULT_OK : AVIF_RESULT_INVALID_ARGUMENT;
+}
+
 unsigned int avifLibYUVVersion(void)
 {
     return (unsigned int)LIBYUV_VERSION;
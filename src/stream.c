@@ -306,17 +306,34 @@ avifBool avifROStreamReadAndEnforceVersion(avifROStream * stream, uint8_t enforc
 // ---------------------------------------------------------------------------
 // avifRWStream
 
-#define AVIF_STREAM_BUFFER_INCREMENT (1024 * 1024)
+#define AVIF_STREAM_BUFFER_MIN_SIZE 1024
+// Unused capacity that avifRWStreamFinishWrite() keeps rather than paying for another allocation and a copy. It is larger
+// than the overestimate reserved by avifEncoderFinish() for typical files, so that they are written with one allocation.
+#define AVIF_STREAM_MAX_KEPT_UNUSED_SIZE (64 * 1024)
 static avifResult makeRoom(avifRWStream * stream, size_t size)
 {
-    size_t neededSize = stream->offset + size;
-    size_t newSize = stream->raw->size;
+    AVIF_CHECKERR(size <= SIZE_MAX - stream->offset, AVIF_RESULT_OUT_OF_MEMORY);
+    const size_t neededSize = stream->offset + size;
+    if (neededSize <= stream->raw->size) {
+        return AVIF_RESULT_OK;
+    }
+    // Grow geometrically so that writing N bytes in small pieces costs O(N) copies in total.
+    size_t newSize = AVIF_MAX(stream->raw->size, (size_t)AVIF_STREAM_BUFFER_MIN_SIZE);
     while (newSize < neededSize) {
-        newSize += AVIF_STREAM_BUFFER_INCREMENT;
+        newSize = (newSize <= SIZE_MAX / 2) ? newSize * 2 : neededSize;
     }
     return avifRWDataRealloc(stream->raw, newSize);
 }
 
+avifResult avifRWStreamReserve(avifRWStream * stream, size_t size)
+{
+    AVIF_CHECKERR(size <= SIZE_MAX - stream->offset, AVIF_RESULT_OUT_OF_MEMORY);
+    if (stream->offset + size <= stream->raw->size) {
+        return AVIF_RESULT_OK;
+    }
+    return avifRWDataRealloc(stream->raw, stream->offset + size);
+}
+
 void avifRWStreamStart(avifRWStream * stream, avifRWData * raw)
 {
     stream->raw = raw;
@@ -341,6 +358,14 @@ void avifRWStreamFinishWrite(avifRWStream * stream)
 {
     if (stream->raw->size != stream->offset) {
         if (stream->offset) {
+            const size_t unusedSize = stream->raw->size - stream->offset;
+            if (unusedSize > AVIF_MAX(stream->offset / 4, (size_t)AVIF_STREAM_MAX_KEPT_UNUSED_SIZE)) {
+                // Geometric growth may leave up to half of the buffer unused. Give it back at the cost of a copy. On allocation
+                // failure, the larger buffer is kept.
+                if (avifRWDataRealloc(stream->raw, stream->offset) == AVIF_RESULT_OK) {
+                    return;
+                }
+            }
             stream->raw->size = stream->offset;
         } else {
             avifRWDataFree(stream->raw);
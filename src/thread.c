@@ -0,0 +1,490 @@
+// Copyright 2024 Google LLC
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "avif/internal.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#include <process.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// avifThread
+
+struct avifThread
+{
+#if defined(_WIN32)
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    avifThreadFunc func;
+    void * arg;
+};
+
+#if defined(_WIN32)
+static unsigned int __stdcall avifThreadStart(void * arg)
+#else
+static void * avifThreadStart(void * arg)
+#endif
+{
+    avifThread * thread = (avifThread *)arg;
+    thread->func(thread->arg);
+#if defined(_WIN32)
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+avifThread * avifThreadCreate(avifThreadFunc func, void * arg)
+{
+    avifThread * thread = (avifThread *)avifAlloc(sizeof(avifThread));
+    if (thread == NULL) {
+        return NULL;
+    }
+    thread->func = func;
+    thread->arg = arg;
+#if defined(_WIN32)
+    thread->handle = (HANDLE)_beginthreadex(/*security=*/NULL,
+                                            /*stack_size=*/0,
+                                            &avifThreadStart,
+                                            thread,
+                                            /*initflag=*/0,
+                                            /*thrdaddr=*/NULL);
+    const avifBool created = thread->handle != NULL;
+#else
+    // TODO: Set the thread name for ease of debugging.
+    const avifBool created = pthread_create(&thread->handle, NULL, &avifThreadStart, thread) == 0;
+#endif
+    if (!created) {
+        avifFree(thread);
+        return NULL;
+    }
+    return thread;
+}
+
+avifBool avifThreadJoin(avifThread * thread)
+{
+#if defined(_WIN32)
+    const avifBool joined = WaitForSingleObject(thread->handle, INFINITE) == WAIT_OBJECT_0 && CloseHandle(thread->handle) != 0;
+#else
+    const avifBool joined = pthread_join(thread->handle, NULL) == 0;
+#endif
+    avifFree(thread);
+    return joined;
+}
+
+// ---------------------------------------------------------------------------
+// avifMutex and avifCond
+
+typedef struct avifMutex
+{
+#if defined(_WIN32)
+    SRWLOCK lock;
+#else
+    pthread_mutex_t mutex;
+#endif
+} avifMutex;
+
+typedef struct avifCond
+{
+#if defined(_WIN32)
+    CONDITION_VARIABLE cond;
+#else
+    pthread_cond_t cond;
+#endif
+} avifCond;
+
+static avifBool avifMutexInit(avifMutex * mutex)
+{
+#if defined(_WIN32)
+    InitializeSRWLock(&mutex->lock);
+    return AVIF_TRUE;
+#else
+    return pthread_mutex_init(&mutex->mutex, NULL) == 0;
+#endif
+}
+
+static void avifMutexDestroy(avifMutex * mutex)
+{
+#if defined(_WIN32)
+    (void)mutex;
+#else
+    pthread_mutex_destroy(&mutex->mutex);
+#endif
+}
+
+static void avifMutexLock(avifMutex * mutex)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&mutex->lock);
+#else
+    pthread_mutex_lock(&mutex->mutex);
+#endif
+}
+
+static void avifMutexUnlock(avifMutex * mutex)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive(&mutex->lock);
+#else
+    pthread_mutex_unlock(&mutex->mutex);
+#endif
+}
+
+static avifBool avifCondInit(avifCond * cond)
+{
+#if defined(_WIN32)
+    InitializeConditionVariable(&cond->cond);
+    return AVIF_TRUE;
+#else
+    return pthread_cond_init(&cond->cond, NULL) == 0;
+#endif
+}
+
+static void avifCondDestroy(avifCond * cond)
+{
+#if defined(_WIN32)
+    (void)cond;
+#else
+    pthread_cond_destroy(&cond->cond);
+#endif
+}
+
+static void avifCondWait(avifCond * cond, avifMutex * mutex)
+{
+#if defined(_WIN32)
+    SleepConditionVariableSRW(&cond->cond, &mutex->lock, INFINITE, 0);
+#else
+    pthread_cond_wait(&cond->cond, &mutex->mutex);
+#endif
+}
+
+static void avifCondBroadcast(avifCond * cond)
+{
+#if defined(_WIN32)
+    WakeAllConditionVariable(&cond->cond);
+#else
+    pthread_cond_broadcast(&cond->cond);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// avifThreadPool
+//
+// Each worker owns a double-ended queue of tasks. The tasks submitted by the user-facing threads
+// are spread over the queues in a round-robin fashion. A worker pops tasks from the back of its own
+// queue and, once it is empty, steals tasks from the front of the other queues. The number of
+// queued tasks is tracked separately, under the pool mutex, so that idle workers can sleep until
+// there is something to do. A thread waiting for a group of tasks to complete helps executing
+// queued tasks in the meantime, which also makes nested parallel work safe.
+
+typedef struct avifTaskGroup
+{
+    uint32_t remainingTaskCount; // Protected by avifThreadPool::mutex.
+} avifTaskGroup;
+
+typedef struct avifTask
+{
+    avifThreadFunc func;
+    void * arg;
+    avifTaskGroup * group;
+} avifTask;
+
+typedef struct avifTaskQueue
+{
+    avifMutex mutex;
+    avifTask * tasks; // Ring buffer.
+    uint32_t capacity;
+    uint32_t front;
+    uint32_t count;
+} avifTaskQueue;
+
+struct avifThreadPool
+{
+    avifMutex mutex;
+    avifCond cond; // Signaled when a task is queued, when a group of tasks completes, and on destruction.
+    uint32_t queuedTaskCount; // Number of tasks in the queues that were not yet claimed by a thread.
+    uint32_t nextQueueIndex;  // For round-robin submission.
+    avifBool stopping;
+
+    uint32_t threadCount;
+    avifThread ** threads;
+    avifTaskQueue * queues;
+    avifBool mutexInitialized;
+    avifBool condInitialized;
+    uint32_t initializedQueueCount;
+};
+
+static avifBool avifTaskQueuePushBack(avifTaskQueue * queue, const avifTask * task)
+{
+    avifBool pushed = AVIF_TRUE;
+    avifMutexLock(&queue->mutex);
+    if (queue->count == queue->capacity) {
+        const uint32_t newCapacity = queue->capacity ? queue->capacity * 2 : 16;
+        avifTask * newTasks = (avifTask *)avifAlloc(sizeof(avifTask) * newCapacity);
+        if (newTasks == NULL) {
+            pushed = AVIF_FALSE;
+        } else {
+            for (uint32_t i = 0; i < queue->count; ++i) {
+                newTasks[i] = queue->tasks[(queue->front + i) % queue->capacity];
+            }
+            avifFree(queue->tasks);
+            queue->tasks = newTasks;
+            queue->capacity = newCapacity;
+            queue->front = 0;
+        }
+    }
+    if (pushed) {
+        queue->tasks[(queue->front + queue->count) % queue->capacity] = *task;
+        ++queue->count;
+    }
+    avifMutexUnlock(&queue->mutex);
+    return pushed;
+}
+
+static avifBool avifTaskQueuePop(avifTaskQueue * queue, avifBool back, avifTask * task)
+{
+    avifBool popped = AVIF_FALSE;
+    avifMutexLock(&queue->mutex);
+    if (queue->count > 0) {
+        if (back) {
+            *task = queue->tasks[(queue->front + queue->count - 1) % queue->capacity];
+        } else {
+            *task = queue->tasks[queue->front];
+            queue->front = (queue->front + 1) % queue->capacity;
+        }
+        --queue->count;
+        popped = AVIF_TRUE;
+    }
+    avifMutexUnlock(&queue->mutex);
+    return popped;
+}
+
+// Takes a task that was claimed by decrementing queuedTaskCount. preferredQueueIndex is the queue
+// of the calling worker, or threadCount if the calling thread is not a worker.
+static void avifThreadPoolTakeClaimedTask(avifThreadPool * pool, uint32_t preferredQueueIndex, avifTask * task)
+{
+    if (preferredQueueIndex < pool->threadCount &&
+        avifTaskQueuePop(&pool->queues[preferredQueueIndex], /*back=*/AVIF_TRUE, task)) {
+        return;
+    }
+    // A claimed task is guaranteed to be in one of the queues, so this loop terminates.
+    for (uint32_t i = 0;; i = (i + 1) % pool->threadCount) {
+        if (avifTaskQueuePop(&pool->queues[i], /*back=*/AVIF_FALSE, task)) {
+            return;
+        }
+    }
+}
+
+static void avifThreadPoolRunTask(avifThreadPool * pool, const avifTask * task)
+{
+    task->func(task->arg);
+    avifMutexLock(&pool->mutex);
+    if (--task->group->remainingTaskCount == 0) {
+        avifCondBroadcast(&pool->cond);
+    }
+    avifMutexUnlock(&pool->mutex);
+}
+
+typedef struct avifThreadPoolWorker
+{
+    avifThreadPool * pool;
+    uint32_t queueIndex;
+} avifThreadPoolWorker;
+
+static void avifThreadPoolWorkerMain(void * arg)
+{
+    avifThreadPoolWorker * worker = (avifThreadPoolWorker *)arg;
+    avifThreadPool * pool = worker->pool;
+    const uint32_t queueIndex = worker->queueIndex;
+    avifFree(worker);
+
+    for (;;) {
+        avifMutexLock(&pool->mutex);
+        while (pool->queuedTaskCount == 0 && !pool->stopping) {
+            avifCondWait(&pool->cond, &pool->mutex);
+        }
+        if (pool->queuedTaskCount == 0) {
+            avifMutexUnlock(&pool->mutex);
+            return;
+        }
+        --pool->queuedTaskCount;
+        avifMutexUnlock(&pool->mutex);
+
+        avifTask task;
+        avifThreadPoolTakeClaimedTask(pool, queueIndex, &task);
+        avifThreadPoolRunTask(pool, &task);
+    }
+}
+
+avifThreadPool * avifThreadPoolCreate(int threadCount)
+{
+    if (threadCount < 1) {
+        return NULL;
+    }
+    avifThreadPool * pool = (avifThreadPool *)avifAlloc(sizeof(avifThreadPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    memset(pool, 0, sizeof(avifThreadPool));
+    pool->mutexInitialized = avifMutexInit(&pool->mutex);
+    if (!pool->mutexInitialized) {
+        goto error;
+    }
+    pool->condInitialized = avifCondInit(&pool->cond);
+    if (!pool->condInitialized) {
+        goto error;
+    }
+    pool->threads = (avifThread **)avifAlloc(sizeof(avifThread *) * threadCount);
+    pool->queues = (avifTaskQueue *)avifAlloc(sizeof(avifTaskQueue) * threadCount);
+    if (pool->threads == NULL || pool->queues == NULL) {
+        goto error;
+    }
+    memset(pool->queues, 0, sizeof(avifTaskQueue) * threadCount);
+    for (; pool->initializedQueueCount < (uint32_t)threadCount; ++pool->initializedQueueCount) {
+        if (!avifMutexInit(&pool->queues[pool->initializedQueueCount].mutex)) {
+            goto error;
+        }
+    }
+    for (; pool->threadCount < (uint32_t)threadCount; ++pool->threadCount) {
+        avifThreadPoolWorker * worker = (avifThreadPoolWorker *)avifAlloc(sizeof(avifThreadPoolWorker));
+        if (worker == NULL) {
+            goto error;
+        }
+        worker->pool = pool;
+        worker->queueIndex = pool->threadCount;
+        pool->threads[pool->threadCount] = avifThreadCreate(avifThreadPoolWorkerMain, worker);
+        if (pool->threads[pool->threadCount] == NULL) {
+            avifFree(worker);
+            goto error;
+        }
+    }
+    return pool;
+
+error:
+    avifThreadPoolDestroy(pool);
+    return NULL;
+}
+
+void avifThreadPoolDestroy(avifThreadPool * pool)
+{
+    if (pool->threadCount > 0) {
+        avifMutexLock(&pool->mutex);
+        pool->stopping = AVIF_TRUE;
+        avifCondBroadcast(&pool->cond);
+        avifMutexUnlock(&pool->mutex);
+        for (uint32_t i = 0; i < pool->threadCount; ++i) {
+            (void)avifThreadJoin(pool->threads[i]);
+        }
+    }
+    for (uint32_t i = 0; i < pool->initializedQueueCount; ++i) {
+        avifMutexDestroy(&pool->queues[i].mutex);
+        avifFree(pool->queues[i].tasks);
+    }
+    avifFree(pool->queues);
+    avifFree(pool->threads);
+    if (pool->condInitialized) {
+        avifCondDestroy(&pool->cond);
+    }
+    if (pool->mutexInitialized) {
+        avifMutexDestroy(&pool->mutex);
+    }
+    avifFree(pool);
+}
+
+int avifThreadPoolGetThreadCount(const avifThreadPool * pool)
+{
+    return (int)pool->threadCount;
+}
+
+static avifBool avifThreadPoolRunInParallel(avifThreadPool * pool,
+                                            avifThreadFunc func,
+                                            uint8_t * args,
+                                            size_t argSize,
+                                            uint32_t count)
+{
+    avifTaskGroup group = { count };
+    for (uint32_t i = 0; i < count; ++i) {
+        const avifTask task = { func, args + i * argSize, &group };
+        avifMutexLock(&pool->mutex);
+        const uint32_t queueIndex = pool->nextQueueIndex;
+        pool->nextQueueIndex = (pool->nextQueueIndex + 1) % pool->threadCount;
+        avifMutexUnlock(&pool->mutex);
+        if (!avifTaskQueuePushBack(&pool->queues[queueIndex], &task)) {
+            // Out of memory. Run the task in the current thread instead.
+            avifThreadPoolRunTask(pool, &task);
+            continue;
+        }
+        avifMutexLock(&pool->mutex);
+        ++pool->queuedTaskCount;
+        avifCondBroadcast(&pool->cond);
+        avifMutexUnlock(&pool->mutex);
+    }
+
+    // Help with the queued tasks, not necessarily from this group, until all of the group's tasks are done.
+    avifMutexLock(&pool->mutex);
+    while (group.remainingTaskCount > 0) {
+        if (pool->queuedTaskCount == 0) {
+            avifCondWait(&pool->cond, &pool->mutex);
+            continue;
+        }
+        --pool->queuedTaskCount;
+        avifMutexUnlock(&pool->mutex);
+        avifTask task;
+        avifThreadPoolTakeClaimedTask(pool, pool->threadCount, &task);
+        avifThreadPoolRunTask(pool, &task);
+        avifMutexLock(&pool->mutex);
+    }
+    avifMutexUnlock(&pool->mutex);
+    return AVIF_TRUE;
+}
+
+// ---------------------------------------------------------------------------
+
+avifBool avifRunInParallel(avifThreadPool * pool, avifThreadFunc func, void * args, size_t argSize, uint32_t count)
+{
+    uint8_t * bytes = (uint8_t *)args;
+    if (count == 0) {
+        return AVIF_TRUE;
+    }
+    if (count == 1) {
+        func(bytes);
+        return AVIF_TRUE;
+    }
+    if (pool != NULL) {
+        return avifThreadPoolRunInParallel(pool, func, bytes, argSize, count);
+    }
+
+    avifThread ** threads = (avifThread **)avifAlloc(sizeof(avifThread *) * count);
+    if (threads == NULL) {
+        // Out of memory. Run everything in the current thread instead.
+        for (uint32_t i = 0; i < count; ++i) {
+            func(bytes + i * argSize);
+        }
+        return AVIF_TRUE;
+    }
+    threads[0] = NULL;
+    for (uint32_t i = 1; i < count; ++i) {
+        threads[i] = avifThreadCreate(func, bytes + i * argSize);
+        if (threads[i] == NULL) {
+            // Fall back to running this call in the current thread.
+            func(bytes + i * argSize);
+        }
+    }
+    // Run the first call in the current thread.
+    func(bytes);
+    avifBool joined = AVIF_TRUE;
+    for (uint32_t i = 1; i < count; ++i) {
+        if (threads[i] != NULL && !avifThreadJoin(threads[i])) {
+            joined = AVIF_FALSE;
+        }
+    }
+    avifFree(threads);
+    return joined;
+}
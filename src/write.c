@@ -4,6 +4,7 @@
 #include "avif/internal.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <string.h>
 #include <time.h>
 
@@ -182,6 +183,9 @@ typedef struct avifEncoderItem
 
     uint16_t dimgFromID; // if non-zero, make an iref from dimgFromID -> this id
 
+    avifBool warmCodec; // if true, codec was kept by avifEncoderReset() and its next frame must be a keyframe
+    avifBool thumbnail; // if true, this is the thumbnail of the primary item or its alpha, encoded once from a downscaled image
+
     struct ipmaArray ipma;
 } avifEncoderItem;
 AVIF_ARRAY_DECLARE(avifEncoderItemArray, avifEncoderItem, item);
@@ -202,6 +206,27 @@ typedef struct avifEncoderFrame
 } avifEncoderFrame;
 AVIF_ARRAY_DECLARE(avifEncoderFrameArray, avifEncoderFrame, frame);
 
+// ---------------------------------------------------------------------------
+// avifEncoderWarmCodec
+
+// Codec instance kept by avifEncoderReset(), with the properties of the image it last encoded.
+// It can only be reused for an image with the exact same properties.
+typedef struct avifEncoderWarmCodec
+{
+    avifCodec * codec;
+    avifItemCategory itemCategory;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    avifPixelFormat yuvFormat;
+    avifRange yuvRange;
+    avifChromaSamplePosition yuvChromaSamplePosition;
+    avifColorPrimaries colorPrimaries;
+    avifTransferCharacteristics transferCharacteristics;
+    avifMatrixCoefficients matrixCoefficients;
+} avifEncoderWarmCodec;
+AVIF_ARRAY_DECLARE(avifEncoderWarmCodecArray, avifEncoderWarmCodec, warmCodec);
+
 // ---------------------------------------------------------------------------
 // avifEncoderData
 
@@ -234,12 +259,16 @@ typedef struct avifEncoderData
     // altenate image
     avifImage * altImageMetadata;
 #endif
+    // Same as imageMetadata but with the dimensions of the thumbnail items, if any
+    avifImage * thumbnailMetadata;
     uint16_t lastItemID;
     uint16_t primaryItemID;
     avifEncoderItemIdArray alternativeItemIDs; // list of item ids for an 'altr' box (group of alternatives to each other)
     avifBool singleImage; // if true, the AVIF_ADD_IMAGE_FLAG_SINGLE flag was set on the first call to avifEncoderAddImage()
     avifBool alphaPresent;
+    avifBool codecsFinished; // if true, encodeFinish() was called on all item codecs and must not be called again
     size_t gainMapSizeBytes;
+    avifEncoderWarmCodecArray warmCodecs; // codecs kept by avifEncoderReset(), taken by the next avifEncoderAddImage()
     // Fields specific to AV1/AV2
     const char * imageItemType;  // "av01" for AV1 ("av02" for AV2 if AVIF_CODEC_AVM)
     const char * configPropName; // "av1C" for AV1 ("av2C" for AV2 if AVIF_CODEC_AVM)
@@ -265,6 +294,10 @@ static avifEncoderData * avifEncoderDataCreate(void)
         goto error;
     }
 #endif
+    data->thumbnailMetadata = avifImageCreateEmpty();
+    if (!data->thumbnailMetadata) {
+        goto error;
+    }
     if (!avifArrayCreate(&data->items, sizeof(avifEncoderItem), 8)) {
         goto error;
     }
@@ -274,6 +307,9 @@ static avifEncoderData * avifEncoderDataCreate(void)
     if (!avifArrayCreate(&data->alternativeItemIDs, sizeof(uint16_t), 1)) {
         goto error;
     }
+    if (!avifArrayCreate(&data->warmCodecs, sizeof(avifEncoderWarmCodec), 2)) {
+        goto error;
+    }
     return data;
 
 error:
@@ -322,7 +358,15 @@ static avifEncoderItem * avifEncoderDataFindItemByID(avifEncoderData * data, uin
     return NULL;
 }
 
-static void avifEncoderDataDestroy(avifEncoderData * data)
+static void avifEncoderDataDestroyWarmCodecs(avifEncoderData * data)
+{
+    for (uint32_t i = 0; i < data->warmCodecs.count; ++i) {
+        avifCodecDestroy(data->warmCodecs.warmCodec[i].codec);
+    }
+    data->warmCodecs.count = 0;
+}
+
+static void avifEncoderDataDestroyItems(avifEncoderData * data)
 {
     for (uint32_t i = 0; i < data->items.count; ++i) {
         avifEncoderItem * item = &data->items.item[i];
@@ -333,6 +377,37 @@ static void avifEncoderDataDestroy(avifEncoderData * data)
         avifRWDataFree(&item->metadataPayload);
         avifArrayDestroy(&item->mdatFixups);
     }
+    data->items.count = 0;
+}
+
+// Returns a codec kept by avifEncoderReset() that last encoded an image of the given category with the same
+// properties as imageMetadata, removing it from data->warmCodecs. Returns NULL if there is none.
+static avifCodec * avifEncoderDataTakeWarmCodec(avifEncoderData * data,
+                                                 avifItemCategory itemCategory,
+                                                 const avifImage * imageMetadata)
+{
+    for (uint32_t i = 0; i < data->warmCodecs.count; ++i) {
+        const avifEncoderWarmCodec * warmCodec = &data->warmCodecs.warmCodec[i];
+        if ((warmCodec->itemCategory == itemCategory) && (warmCodec->width == imageMetadata->width) &&
+            (warmCodec->height == imageMetadata->height) && (warmCodec->depth == imageMetadata->depth) &&
+            (warmCodec->yuvFormat == imageMetadata->yuvFormat) && (warmCodec->yuvRange == imageMetadata->yuvRange) &&
+            (warmCodec->yuvChromaSamplePosition == imageMetadata->yuvChromaSamplePosition) &&
+            (warmCodec->colorPrimaries == imageMetadata->colorPrimaries) &&
+            (warmCodec->transferCharacteristics == imageMetadata->transferCharacteristics) &&
+            (warmCodec->matrixCoefficients == imageMetadata->matrixCoefficients)) {
+            avifCodec * codec = warmCodec->codec;
+            data->warmCodecs.warmCodec[i] = data->warmCodecs.warmCodec[data->warmCodecs.count - 1];
+            --data->warmCodecs.count;
+            return codec;
+        }
+    }
+    return NULL;
+}
+
+static void avifEncoderDataDestroy(avifEncoderData * data)
+{
+    avifEncoderDataDestroyItems(data);
+    avifEncoderDataDestroyWarmCodecs(data);
     if (data->imageMetadata) {
         avifImageDestroy(data->imageMetadata);
     }
@@ -341,9 +416,13 @@ static void avifEncoderDataDestroy(avifEncoderData * data)
         avifImageDestroy(data->altImageMetadata);
     }
 #endif
+    if (data->thumbnailMetadata) {
+        avifImageDestroy(data->thumbnailMetadata);
+    }
     avifArrayDestroy(&data->items);
     avifArrayDestroy(&data->frames);
     avifArrayDestroy(&data->alternativeItemIDs);
+    avifArrayDestroy(&data->warmCodecs);
     avifFree(data);
 }
 
@@ -1191,9 +1270,22 @@ static avifResult avifEncoderAddImageItems(avifEncoder * encoder,
         avifEncoderItem * item =
             avifEncoderDataCreateItem(encoder->data, encoder->data->imageItemType, infeName, infeNameSize, cellIndex);
         AVIF_CHECKERR(item, AVIF_RESULT_OUT_OF_MEMORY);
-        AVIF_CHECKRES(avifCodecCreate(encoder->codecChoice, AVIF_CODEC_FLAG_CAN_ENCODE, &item->codec));
+        // Only the codecs of single, non-grid color and alpha items can be kept by avifEncoderReset().
+        avifBool reusable = encoder->data->singleImage && (cellCount == 1) &&
+                            ((itemCategory == AVIF_ITEM_COLOR) || (itemCategory == AVIF_ITEM_ALPHA));
+#if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
+        reusable = reusable && (encoder->sampleTransformRecipe == AVIF_SAMPLE_TRANSFORM_NONE);
+#endif
+        if (reusable) {
+            item->codec = avifEncoderDataTakeWarmCodec(encoder->data, itemCategory, encoder->data->imageMetadata);
+            item->warmCodec = (item->codec != NULL);
+        }
+        if (!item->codec) {
+            AVIF_CHECKRES(avifCodecCreate(encoder->codecChoice, AVIF_CODEC_FLAG_CAN_ENCODE, &item->codec));
+        }
         item->codec->csOptions = encoder->csOptions;
         item->codec->diag = &encoder->diag;
+        item->codec->keepEncoderAlive = reusable;
         item->itemCategory = itemCategory;
         item->extraLayerCount = encoder->extraLayerCount;
 
@@ -1598,6 +1690,399 @@ static avifResult avifValidateGrid(uint32_t gridCols,
     return AVIF_RESULT_OK;
 }
 
+// Encodes the current frame of the given item, using up to codecMaxThreads threads and reporting errors to diag.
+// diag and codecMaxThreads are passed separately because this may be called concurrently for different items.
+static avifResult avifEncoderEncodeItem(avifEncoder * encoder,
+                                        avifEncoderItem * item,
+                                        const avifImage * const * cellImages,
+                                        const avifImage * firstCell,
+                                        avifEncoderChanges * encoderChanges,
+                                        avifAddImageFlags addImageFlags,
+                                        int codecMaxThreads,
+                                        avifDiagnostics * diag)
+{
+    const avifImage * cellImage = cellImages[item->cellIndex];
+    avifImage * cellImagePlaceholder = NULL; // May be used as a temporary, modified cellImage. Left as NULL otherwise.
+    const avifImage * firstCellImage = firstCell;
+
+#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
+    if (item->itemCategory == AVIF_ITEM_GAIN_MAP) {
+        AVIF_ASSERT_OR_RETURN(cellImage->gainMap && cellImage->gainMap->image);
+        cellImage = cellImage->gainMap->image;
+        AVIF_ASSERT_OR_RETURN(firstCell->gainMap && firstCell->gainMap->image);
+        firstCellImage = firstCell->gainMap->image;
+    }
+#endif
+
+    if ((cellImage->width != firstCellImage->width) || (cellImage->height != firstCellImage->height)) {
+        // Pad the right-most and/or bottom-most tiles so that all tiles share the same dimensions.
+        cellImagePlaceholder = avifImageCreateEmpty();
+        AVIF_CHECKERR(cellImagePlaceholder, AVIF_RESULT_OUT_OF_MEMORY);
+        const avifResult result =
+            avifImageCopyAndPad(cellImagePlaceholder, cellImage, firstCellImage->width, firstCellImage->height);
+        if (result != AVIF_RESULT_OK) {
+            avifImageDestroy(cellImagePlaceholder);
+            return result;
+        }
+        cellImage = cellImagePlaceholder;
+    }
+
+    const avifBool isAlpha = avifIsAlpha(item->itemCategory);
+    int quantizer = isAlpha ? encoder->data->quantizerAlpha
+#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
+                    : (item->itemCategory == AVIF_ITEM_GAIN_MAP) ? encoder->data->quantizerGainMap
+#endif
+                                                                 : encoder->data->quantizer;
+
+#if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
+    // Remember original quantizer values in case they change, to reset them afterwards.
+    int * encoderMinQuantizer = isAlpha ? &encoder->minQuantizerAlpha : &encoder->minQuantizer;
+    int * encoderMaxQuantizer = isAlpha ? &encoder->maxQuantizerAlpha : &encoder->maxQuantizer;
+    const int originalMinQuantizer = *encoderMinQuantizer;
+    const int originalMaxQuantizer = *encoderMaxQuantizer;
+
+    if (encoder->sampleTransformRecipe != AVIF_SAMPLE_TRANSFORM_NONE) {
+        if ((encoder->sampleTransformRecipe == AVIF_SAMPLE_TRANSFORM_BIT_DEPTH_EXTENSION_8B_8B ||
+             encoder->sampleTransformRecipe == AVIF_SAMPLE_TRANSFORM_BIT_DEPTH_EXTENSION_12B_4B) &&
+            (item->itemCategory == AVIF_ITEM_COLOR || item->itemCategory == AVIF_ITEM_ALPHA)) {
+            // Encoding the least significant bits of a sample does not make any sense if the
+            // other bits are lossily compressed. Encode the most significant bits losslessly.
+            quantizer = AVIF_QUANTIZER_LOSSLESS;
+            *encoderMinQuantizer = AVIF_QUANTIZER_LOSSLESS;
+            *encoderMaxQuantizer = AVIF_QUANTIZER_LOSSLESS;
+            if (!avifEncoderDetectChanges(encoder, encoderChanges)) {
+                assert(AVIF_FALSE);
+            }
+        }
+
+        // Replace cellImage by the first or second input to the AVIF_ITEM_SAMPLE_TRANSFORM derived image item.
+        const avifBool itemWillBeEncodedLosslessly = (quantizer == AVIF_QUANTIZER_LOSSLESS);
+        avifImage * sampleTransformedImage = NULL;
+        if (cellImagePlaceholder) {
+            avifImageDestroy(cellImagePlaceholder); // Replaced by sampleTransformedImage.
+            cellImagePlaceholder = NULL;
+        }
+        AVIF_CHECKRES(avifEncoderCreateBitDepthExtensionImage(encoder,
+                                                              item,
+                                                              itemWillBeEncodedLosslessly,
+                                                              cellImage,
+                                                              &sampleTransformedImage));
+        cellImagePlaceholder = sampleTransformedImage; // Transfer ownership.
+        cellImage = cellImagePlaceholder;
+    }
+#endif // AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM
+
+    // If alpha channel is present, set disableLaggedOutput to AVIF_TRUE. If the encoder supports it, this enables
+    // avifEncoderDataShouldForceKeyframeForAlpha to force a keyframe in the alpha channel whenever a keyframe has been
+    // encoded in the color channel for animated images.
+    if (item->warmCodec) {
+        // The codec was kept by avifEncoderReset(). Do not let it reference the previously encoded image.
+        addImageFlags |= AVIF_ADD_IMAGE_FLAG_FORCE_KEYFRAME;
+    }
+    item->codec->diag = diag;
+    item->codec->maxThreads = codecMaxThreads;
+    avifResult encodeResult = item->codec->encodeImage(item->codec,
+                                                       encoder,
+                                                       cellImage,
+                                                       isAlpha,
+                                                       encoder->data->tileRowsLog2,
+                                                       encoder->data->tileColsLog2,
+                                                       quantizer,
+                                                       *encoderChanges,
+                                                       /*disableLaggedOutput=*/encoder->data->alphaPresent,
+                                                       addImageFlags,
+                                                       item->encodeOutput);
+#if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
+    // Revert quality settings if they changed.
+    if (*encoderMinQuantizer != originalMinQuantizer || *encoderMaxQuantizer != originalMaxQuantizer) {
+        avifEncoderBackupSettings(encoder); // Remember last encoding settings for next avifEncoderDetectChanges().
+        *encoderMinQuantizer = originalMinQuantizer;
+        *encoderMaxQuantizer = originalMaxQuantizer;
+    }
+#endif // AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM
+    if (cellImagePlaceholder) {
+        avifImageDestroy(cellImagePlaceholder);
+    }
+    if (encodeResult == AVIF_RESULT_UNKNOWN_ERROR) {
+        encodeResult = avifGetErrorForItemCategory(item->itemCategory);
+    }
+    return encodeResult;
+}
+
+typedef struct avifItemEncodeJob
+{
+    avifEncoder * encoder;
+    const avifImage * const * cellImages;
+    const avifImage * firstCell;
+    avifEncoderChanges encoderChanges;
+    avifAddImageFlags addImageFlags;
+    const uint32_t * itemIndices; // Indices in encoder->data->items of the items to encode, shared by all jobs.
+    uint32_t firstIndex;          // In itemIndices.
+    uint32_t endIndex;            // Exclusive.
+    uint32_t indexStep;
+    int codecMaxThreads;
+    avifDiagnostics diag;
+    avifResult result;
+} avifItemEncodeJob;
+
+static void avifEncoderEncodeItemsWorker(void * arg)
+{
+    avifItemEncodeJob * job = (avifItemEncodeJob *)arg;
+    for (uint32_t i = job->firstIndex; i < job->endIndex; i += job->indexStep) {
+        avifEncoderItem * item = &job->encoder->data->items.item[job->itemIndices[i]];
+        job->result = avifEncoderEncodeItem(job->encoder,
+                                            item,
+                                            job->cellImages,
+                                            job->firstCell,
+                                            &job->encoderChanges,
+                                            job->addImageFlags,
+                                            job->codecMaxThreads,
+                                            &job->diag);
+        if (job->result != AVIF_RESULT_OK) {
+            return;
+        }
+    }
+}
+
+// Encodes the current frame of all items that have a codec (grid cells, alpha, gain map etc.). Each of these items has its
+// own codec instance and encodeOutput, so they are encoded concurrently by min(itemCount, maxThreads) jobs, each codec
+// being given an equal share of encoder->maxThreads. The outputs do not depend on the order of execution.
+static avifResult avifEncoderEncodeItems(avifEncoder * encoder,
+                                         const avifImage * const * cellImages,
+                                         const avifImage * firstCell,
+                                         avifEncoderChanges * encoderChanges,
+                                         avifAddImageFlags addImageFlags)
+{
+    avifEncoderItemArray * items = &encoder->data->items;
+    uint32_t firstItemIndex = 0;
+    if (items->count > 0 && items->item[0].codec != NULL && encoder->data->alphaPresent &&
+        !(addImageFlags & AVIF_ADD_IMAGE_FLAG_SINGLE)) {
+        // Whether a keyframe must be forced in the alpha channel depends on the output of the first color item.
+        avifEncoderItem * item = &items->item[0];
+        AVIF_CHECKRES(avifEncoderEncodeItem(encoder,
+                                            item,
+                                            cellImages,
+                                            firstCell,
+                                            encoderChanges,
+                                            addImageFlags,
+                                            encoder->maxThreads,
+                                            &encoder->diag));
+        if (avifEncoderDataShouldForceKeyframeForAlpha(encoder->data, item, addImageFlags)) {
+            addImageFlags |= AVIF_ADD_IMAGE_FLAG_FORCE_KEYFRAME;
+        }
+        firstItemIndex = 1;
+    }
+
+    uint32_t itemCount = 0;
+    for (uint32_t itemIndex = firstItemIndex; itemIndex < items->count; ++itemIndex) {
+        if (items->item[itemIndex].codec) {
+            ++itemCount;
+        }
+    }
+    avifBool parallel = (encoder->maxThreads > 1) && (itemCount > 1);
+#if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
+    // The sample transform recipes temporarily modify the encoder settings while encoding some items.
+    parallel = parallel && (encoder->sampleTransformRecipe == AVIF_SAMPLE_TRANSFORM_NONE);
+#endif
+    if (!parallel) {
+        for (uint32_t itemIndex = firstItemIndex; itemIndex < items->count; ++itemIndex) {
+            avifEncoderItem * item = &items->item[itemIndex];
+            if (item->codec) {
+                AVIF_CHECKRES(avifEncoderEncodeItem(encoder,
+                                                    item,
+                                                    cellImages,
+                                                    firstCell,
+                                                    encoderChanges,
+                                                    addImageFlags,
+                                                    encoder->maxThreads,
+                                                    &encoder->diag));
+            }
+        }
+        return AVIF_RESULT_OK;
+    }
+
+    const uint32_t jobCount = AVIF_MIN(itemCount, (uint32_t)encoder->maxThreads);
+    uint32_t * itemIndices = (uint32_t *)avifAlloc(sizeof(uint32_t) * itemCount);
+    avifItemEncodeJob * jobs = (avifItemEncodeJob *)avifAlloc(sizeof(avifItemEncodeJob) * jobCount);
+    if (itemIndices == NULL || jobs == NULL) {
+        avifFree(itemIndices);
+        avifFree(jobs);
+        return AVIF_RESULT_OUT_OF_MEMORY;
+    }
+    itemCount = 0;
+    for (uint32_t itemIndex = firstItemIndex; itemIndex < items->count; ++itemIndex) {
+        if (items->item[itemIndex].codec) {
+            itemIndices[itemCount++] = itemIndex;
+        }
+    }
+    memset(jobs, 0, sizeof(avifItemEncodeJob) * jobCount);
+    for (uint32_t i = 0; i < jobCount; ++i) {
+        avifItemEncodeJob * job = &jobs[i];
+        job->encoder = encoder;
+        job->cellImages = cellImages;
+        job->firstCell = firstCell;
+        job->encoderChanges = *encoderChanges;
+        job->addImageFlags = addImageFlags;
+        job->itemIndices = itemIndices;
+        job->firstIndex = i;
+        job->endIndex = itemCount;
+        job->indexStep = jobCount;
+        job->codecMaxThreads = AVIF_MAX(encoder->maxThreads / (int)jobCount, 1);
+        job->result = AVIF_RESULT_OK;
+    }
+
+    avifResult result = AVIF_RESULT_OK;
+    if (!avifRunInParallel(encoder->threadPool, avifEncoderEncodeItemsWorker, jobs, sizeof(avifItemEncodeJob), jobCount)) {
+        result = AVIF_RESULT_UNKNOWN_ERROR;
+    }
+    for (uint32_t i = 0; i < jobCount; ++i) {
+        const avifItemEncodeJob * job = &jobs[i];
+        if (result == AVIF_RESULT_OK && job->result != AVIF_RESULT_OK) {
+            result = job->result;
+            if (*job->diag.error) {
+                avifDiagnosticsPrintf(&encoder->diag, "%s", job->diag.error);
+            }
+        }
+    }
+    // The job diagnostics are about to be freed.
+    for (uint32_t i = 0; i < itemCount; ++i) {
+        items->item[itemIndices[i]].codec->diag = &encoder->diag;
+    }
+    avifFree(jobs);
+    avifFree(itemIndices);
+    return result;
+}
+
+// Copies the cells to image, which must have the dimensions of the whole grid and allocated planes.
+static void avifImageCopyGridCells(avifImage * image,
+                                   uint32_t gridCols,
+                                   uint32_t gridRows,
+                                   const avifImage * const * cellImages,
+                                   avifPlanesFlags planes)
+{
+    const avifImage * firstCell = cellImages[0];
+    for (uint32_t cellIndex = 0; cellIndex < gridCols * gridRows; ++cellIndex) {
+        const avifImage * cellImage = cellImages[cellIndex];
+        const avifCropRect cellRect = { (cellIndex % gridCols) * firstCell->width,
+                                        (cellIndex / gridCols) * firstCell->height,
+                                        cellImage->width,
+                                        cellImage->height };
+        avifImage cellView;
+        avifImageSetDefaults(&cellView);
+        // Cannot fail because avifValidateGrid() checked the cell dimensions and their chroma subsampling alignment.
+        const avifResult result = avifImageSetViewRect(&cellView, image, &cellRect);
+        assert(result == AVIF_RESULT_OK);
+        (void)result;
+        avifImageCopySamples(&cellView, cellImage, planes);
+    }
+}
+
+// Creates and encodes the thumbnail item of the primary item, and its alpha auxiliary item if any.
+// See avifEncoder::thumbnailSize.
+static avifResult avifEncoderAddThumbnailItems(avifEncoder * encoder,
+                                               uint32_t gridCols,
+                                               uint32_t gridRows,
+                                               const avifImage * const * cellImages)
+{
+    const avifImage * firstCell = cellImages[0];
+    const avifImage * bottomRightCell = cellImages[gridCols * gridRows - 1];
+    const uint32_t width = avifGridWidth(gridCols, firstCell, bottomRightCell);
+    const uint32_t height = avifGridHeight(gridRows, firstCell, bottomRightCell);
+    const uint32_t thumbnailSize = encoder->thumbnailSize;
+    if ((width <= thumbnailSize) && (height <= thumbnailSize)) {
+        // The image is small enough to be its own preview.
+        return AVIF_RESULT_OK;
+    }
+    const avifBool alphaPresent = encoder->data->alphaPresent;
+    if (alphaPresent && encoder->data->imageMetadata->alphaPremultiplied) {
+        // The thumbnail item would need both a 'thmb' and a 'prem' item reference.
+        avifDiagnosticsPrintf(&encoder->diag, "thumbnailSize is not supported for images with premultiplied alpha");
+        return AVIF_RESULT_NOT_IMPLEMENTED;
+    }
+
+    // Keep the aspect ratio.
+    uint32_t thumbnailWidth = thumbnailSize;
+    uint32_t thumbnailHeight = thumbnailSize;
+    if (width >= height) {
+        thumbnailHeight = (uint32_t)AVIF_MAX(((uint64_t)height * thumbnailSize + width / 2) / width, 1);
+    } else {
+        thumbnailWidth = (uint32_t)AVIF_MAX(((uint64_t)width * thumbnailSize + height / 2) / height, 1);
+    }
+
+    // The properties of the thumbnail items are those of the primary item, except for the dimensions. The clean aperture
+    // is dropped because it is expressed in pixels of the primary item.
+    avifImage * thumbnailMetadata = encoder->data->thumbnailMetadata;
+    AVIF_CHECKRES(avifImageCopy(thumbnailMetadata, encoder->data->imageMetadata, 0));
+    thumbnailMetadata->width = thumbnailWidth;
+    thumbnailMetadata->height = thumbnailHeight;
+    thumbnailMetadata->transformFlags &= ~(avifTransformFlags)AVIF_TRANSFORM_CLAP;
+
+    uint16_t colorItemID = 0;
+    for (int c = AVIF_ITEM_COLOR; c <= (alphaPresent ? AVIF_ITEM_ALPHA : AVIF_ITEM_COLOR); ++c) {
+        const avifItemCategory itemCategory = (avifItemCategory)c;
+        const char * infeName = getInfeName(itemCategory);
+        const size_t infeNameSize = strlen(infeName) + 1;
+        avifEncoderItem * item =
+            avifEncoderDataCreateItem(encoder->data, encoder->data->imageItemType, infeName, infeNameSize, /*cellIndex=*/0);
+        AVIF_CHECKERR(item, AVIF_RESULT_OUT_OF_MEMORY);
+        item->itemCategory = itemCategory;
+        item->thumbnail = AVIF_TRUE;
+        if (itemCategory == AVIF_ITEM_COLOR) {
+            colorItemID = item->id;
+            item->irefType = "thmb";
+            item->irefToID = encoder->data->primaryItemID;
+        } else {
+            item->irefType = "auxl";
+            item->irefToID = colorItemID;
+        }
+        AVIF_CHECKRES(avifCodecCreate(encoder->codecChoice, AVIF_CODEC_FLAG_CAN_ENCODE, &item->codec));
+        item->codec->csOptions = encoder->csOptions;
+        item->codec->diag = &encoder->diag;
+        item->codec->maxThreads = encoder->maxThreads;
+    }
+
+    // Assemble the whole image from its cells and downscale it.
+    avifImage * thumbnail = avifImageCreateEmpty();
+    AVIF_CHECKERR(thumbnail, AVIF_RESULT_OUT_OF_MEMORY);
+    avifImageCopyNoAlloc(thumbnail, firstCell);
+    thumbnail->width = width;
+    thumbnail->height = height;
+    const avifPlanesFlags planes = alphaPresent ? AVIF_PLANES_ALL : AVIF_PLANES_YUV;
+    avifResult result = avifImageAllocatePlanes(thumbnail, planes);
+    if (result == AVIF_RESULT_OK) {
+        avifImageCopyGridCells(thumbnail, gridCols, gridRows, cellImages, planes);
+        result = avifImageScale(thumbnail, thumbnailWidth, thumbnailHeight, &encoder->diag);
+    }
+
+    // Encode once with fast settings. The thumbnail is not affected by later avifEncoderAddImage() calls.
+    avifEncoder thumbnailEncoder = *encoder;
+    thumbnailEncoder.speed = AVIF_SPEED_FASTEST;
+    thumbnailEncoder.scalingMode = noScaling;
+    for (uint32_t itemIndex = 0; (itemIndex < encoder->data->items.count) && (result == AVIF_RESULT_OK); ++itemIndex) {
+        avifEncoderItem * item = &encoder->data->items.item[itemIndex];
+        if (!item->thumbnail) {
+            continue;
+        }
+        const avifBool isAlpha = avifIsAlpha(item->itemCategory);
+        result = item->codec->encodeImage(item->codec,
+                                          &thumbnailEncoder,
+                                          thumbnail,
+                                          isAlpha,
+                                          /*tileRowsLog2=*/0,
+                                          /*tileColsLog2=*/0,
+                                          isAlpha ? encoder->data->quantizerAlpha : encoder->data->quantizer,
+                                          /*encoderChanges=*/0,
+                                          /*disableLaggedOutput=*/alphaPresent,
+                                          AVIF_ADD_IMAGE_FLAG_SINGLE,
+                                          item->encodeOutput);
+        if (result == AVIF_RESULT_UNKNOWN_ERROR) {
+            result = avifGetErrorForItemCategory(item->itemCategory);
+        }
+    }
+    avifImageDestroy(thumbnail);
+    return result;
+}
+
 static avifResult avifEncoderAddImageInternal(avifEncoder * encoder,
                                               uint32_t gridCols,
                                               uint32_t gridRows,
@@ -1608,6 +2093,11 @@ static avifResult avifEncoderAddImageInternal(avifEncoder * encoder,
     // -----------------------------------------------------------------------
     // Verify encoding is possible
 
+    if ((encoder->thumbnailSize != 0) && !(addImageFlags & AVIF_ADD_IMAGE_FLAG_SINGLE)) {
+        avifDiagnosticsPrintf(&encoder->diag, "thumbnailSize is only supported for a single still image or grid");
+        return AVIF_RESULT_NOT_IMPLEMENTED;
+    }
+
     if (!avifCodecName(encoder->codecChoice, AVIF_CODEC_FLAG_CAN_ENCODE)) {
         return AVIF_RESULT_NO_CODEC_AVAILABLE;
     }
@@ -1779,7 +2269,12 @@ static avifResult avifEncoderAddImageInternal(avifEncoder * encoder,
 
     avifEncoderChanges encoderChanges;
     if (!avifEncoderDetectChanges(encoder, &encoderChanges)) {
-        return AVIF_RESULT_CANNOT_CHANGE_SETTING;
+        if (encoder->data->items.count > 0) {
+            return AVIF_RESULT_CANNOT_CHANGE_SETTING;
+        }
+        // A setting that cannot change was modified since avifEncoderReset(). The codecs it kept cannot be reused.
+        avifEncoderDataDestroyWarmCodecs(encoder->data);
+        encoderChanges = 0;
     }
     avifEncoderBackupSettings(encoder);
 
@@ -1905,6 +2400,9 @@ static avifResult avifEncoderAddImageInternal(avifEncoder * encoder,
         }
 #endif // AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM
 
+        // The codecs kept by avifEncoderReset() that were not taken by any item above do not match this image.
+        avifEncoderDataDestroyWarmCodecs(encoder->data);
+
         // -----------------------------------------------------------------------
         // Create metadata items (Exif, XMP)
 
@@ -1967,122 +2465,216 @@ static avifResult avifEncoderAddImageInternal(avifEncoder * encoder,
     // -----------------------------------------------------------------------
     // Encode AV1 OBUs
 
-    for (uint32_t itemIndex = 0; itemIndex < encoder->data->items.count; ++itemIndex) {
-        avifEncoderItem * item = &encoder->data->items.item[itemIndex];
-        if (item->codec) {
-            const avifImage * cellImage = cellImages[item->cellIndex];
-            avifImage * cellImagePlaceholder = NULL; // May be used as a temporary, modified cellImage. Left as NULL otherwise.
-            const avifImage * firstCellImage = firstCell;
+    AVIF_CHECKRES(avifEncoderEncodeItems(encoder, cellImages, firstCell, &encoderChanges, addImageFlags));
+    if (encoder->thumbnailSize != 0) {
+        AVIF_CHECKRES(avifEncoderAddThumbnailItems(encoder, gridCols, gridRows, cellImages));
+    }
 
-#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
-            if (item->itemCategory == AVIF_ITEM_GAIN_MAP) {
-                AVIF_ASSERT_OR_RETURN(cellImage->gainMap && cellImage->gainMap->image);
-                cellImage = cellImage->gainMap->image;
-                AVIF_ASSERT_OR_RETURN(firstCell->gainMap && firstCell->gainMap->image);
-                firstCellImage = firstCell->gainMap->image;
-            }
-#endif
+    avifCodecSpecificOptionsClear(encoder->csOptions);
+    avifEncoderFrame * frame = (avifEncoderFrame *)avifArrayPush(&encoder->data->frames);
+    AVIF_CHECKERR(frame != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+    frame->durationInTimescales = durationInTimescales;
+    return AVIF_RESULT_OK;
+}
 
-            if ((cellImage->width != firstCellImage->width) || (cellImage->height != firstCellImage->height)) {
-                // Pad the right-most and/or bottom-most tiles so that all tiles share the same dimensions.
-                cellImagePlaceholder = avifImageCreateEmpty();
-                AVIF_CHECKERR(cellImagePlaceholder, AVIF_RESULT_OUT_OF_MEMORY);
-                const avifResult result =
-                    avifImageCopyAndPad(cellImagePlaceholder, cellImage, firstCellImage->width, firstCellImage->height);
-                if (result != AVIF_RESULT_OK) {
-                    avifImageDestroy(cellImagePlaceholder);
-                    return result;
-                }
-                cellImage = cellImagePlaceholder;
-            }
+// ---------------------------------------------------------------------------
+// Target file size
 
-            const avifBool isAlpha = avifIsAlpha(item->itemCategory);
-            int quantizer = isAlpha ? encoder->data->quantizerAlpha
+// Maximum number of trial encodes running concurrently when searching for the quality matching avifEncoder::targetSizeBytes.
+// Each trial holds its own codec instances and encoded samples in memory.
+#define AVIF_TARGET_SIZE_MAX_PARALLEL_TRIALS 8
+
+typedef struct avifTargetSizeTrial
+{
+    avifEncoder * encoder; // Owned. Encodes the input at the given quality.
+    uint32_t gridCols;
+    uint32_t gridRows;
+    const avifImage * const * cellImages;
+    uint64_t durationInTimescales;
+    avifAddImageFlags addImageFlags;
+    int quality;
+    size_t size; // Size of the whole encoded file.
+    avifResult result;
+} avifTargetSizeTrial;
+
+// Returns an encoder with the same settings as encoder except for the quality and the number of threads.
+static avifEncoder * avifEncoderCreateTrial(const avifEncoder * encoder, int quality, int maxThreads)
+{
+    avifEncoder * trial = avifEncoderCreate();
+    if (!trial) {
+        return NULL;
+    }
+    avifEncoderData * data = trial->data;
+    avifCodecSpecificOptions * csOptions = trial->csOptions;
+    *trial = *encoder;
+    trial->data = data;
+    trial->csOptions = csOptions;
+    avifDiagnosticsClearError(&trial->diag);
+    memset(&trial->ioStats, 0, sizeof(trial->ioStats));
+    for (uint32_t i = 0; i < encoder->csOptions->count; ++i) {
+        const avifCodecSpecificOption * entry = &encoder->csOptions->entries[i];
+        if (avifCodecSpecificOptionsSet(trial->csOptions, entry->key, entry->value) != AVIF_RESULT_OK) {
+            avifEncoderDestroy(trial);
+            return NULL;
+        }
+    }
+    trial->maxThreads = maxThreads;
+    trial->targetSizeBytes = 0;
+    trial->quality = quality;
+    trial->qualityAlpha = quality;
 #if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
-                            : (item->itemCategory == AVIF_ITEM_GAIN_MAP) ? encoder->data->quantizerGainMap
+    trial->qualityGainMap = quality;
 #endif
-                                                                         : encoder->data->quantizer;
+    return trial;
+}
 
-#if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
-            // Remember original quantizer values in case they change, to reset them afterwards.
-            int * encoderMinQuantizer = isAlpha ? &encoder->minQuantizerAlpha : &encoder->minQuantizer;
-            int * encoderMaxQuantizer = isAlpha ? &encoder->maxQuantizerAlpha : &encoder->maxQuantizer;
-            const int originalMinQuantizer = *encoderMinQuantizer;
-            const int originalMaxQuantizer = *encoderMaxQuantizer;
-
-            if (encoder->sampleTransformRecipe != AVIF_SAMPLE_TRANSFORM_NONE) {
-                if ((encoder->sampleTransformRecipe == AVIF_SAMPLE_TRANSFORM_BIT_DEPTH_EXTENSION_8B_8B ||
-                     encoder->sampleTransformRecipe == AVIF_SAMPLE_TRANSFORM_BIT_DEPTH_EXTENSION_12B_4B) &&
-                    (item->itemCategory == AVIF_ITEM_COLOR || item->itemCategory == AVIF_ITEM_ALPHA)) {
-                    // Encoding the least significant bits of a sample does not make any sense if the
-                    // other bits are lossily compressed. Encode the most significant bits losslessly.
-                    quantizer = AVIF_QUANTIZER_LOSSLESS;
-                    *encoderMinQuantizer = AVIF_QUANTIZER_LOSSLESS;
-                    *encoderMaxQuantizer = AVIF_QUANTIZER_LOSSLESS;
-                    if (!avifEncoderDetectChanges(encoder, &encoderChanges)) {
-                        assert(AVIF_FALSE);
-                    }
-                }
+static void avifTargetSizeTrialWorker(void * arg)
+{
+    avifTargetSizeTrial * trial = (avifTargetSizeTrial *)arg;
+    trial->result = avifEncoderAddImageInternal(trial->encoder,
+                                                trial->gridCols,
+                                                trial->gridRows,
+                                                trial->cellImages,
+                                                trial->durationInTimescales,
+                                                trial->addImageFlags);
+    if (trial->result != AVIF_RESULT_OK) {
+        return;
+    }
+    // The file is assembled only to know its exact size. The encoded samples are kept in trial->encoder in case this
+    // trial is selected.
+    avifRWData output = AVIF_DATA_EMPTY;
+    trial->result = avifEncoderFinish(trial->encoder, &output);
+    trial->size = output.size;
+    avifRWDataFree(&output);
+}
 
-                // Replace cellImage by the first or second input to the AVIF_ITEM_SAMPLE_TRANSFORM derived image item.
-                const avifBool itemWillBeEncodedLosslessly = (quantizer == AVIF_QUANTIZER_LOSSLESS);
-                avifImage * sampleTransformedImage = NULL;
-                if (cellImagePlaceholder) {
-                    avifImageDestroy(cellImagePlaceholder); // Replaced by sampleTransformedImage.
-                    cellImagePlaceholder = NULL;
-                }
-                AVIF_CHECKRES(
-                    avifEncoderCreateBitDepthExtensionImage(encoder, item, itemWillBeEncodedLosslessly, cellImage, &sampleTransformedImage));
-                cellImagePlaceholder = sampleTransformedImage; // Transfer ownership.
-                cellImage = cellImagePlaceholder;
-            }
-#endif // AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM
+// Encodes the input at several qualities and keeps the encoded samples of the one whose file size is the closest to
+// encoder->targetSizeBytes. Each round runs up to AVIF_TARGET_SIZE_MAX_PARALLEL_TRIALS trials concurrently at qualities
+// evenly spread over the remaining search range, which is then narrowed down to the qualities between the trials that
+// were immediately below and above the target size. With a single trial per round, this is a binary search.
+static avifResult avifEncoderAddImageWithTargetSize(avifEncoder * encoder,
+                                                    uint32_t gridCols,
+                                                    uint32_t gridRows,
+                                                    const avifImage * const * cellImages,
+                                                    uint64_t durationInTimescales,
+                                                    avifAddImageFlags addImageFlags)
+{
+    if (!(addImageFlags & AVIF_ADD_IMAGE_FLAG_SINGLE) || (encoder->extraLayerCount != 0) || (encoder->data->items.count != 0)) {
+        avifDiagnosticsPrintf(&encoder->diag, "targetSizeBytes is only supported for a single still image or grid");
+        return AVIF_RESULT_NOT_IMPLEMENTED;
+    }
 
-            // If alpha channel is present, set disableLaggedOutput to AVIF_TRUE. If the encoder supports it, this enables
-            // avifEncoderDataShouldForceKeyframeForAlpha to force a keyframe in the alpha channel whenever a keyframe has been
-            // encoded in the color channel for animated images.
-            avifResult encodeResult = item->codec->encodeImage(item->codec,
-                                                               encoder,
-                                                               cellImage,
-                                                               isAlpha,
-                                                               encoder->data->tileRowsLog2,
-                                                               encoder->data->tileColsLog2,
-                                                               quantizer,
-                                                               encoderChanges,
-                                                               /*disableLaggedOutput=*/encoder->data->alphaPresent,
-                                                               addImageFlags,
-                                                               item->encodeOutput);
-#if defined(AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM)
-            // Revert quality settings if they changed.
-            if (*encoderMinQuantizer != originalMinQuantizer || *encoderMaxQuantizer != originalMaxQuantizer) {
-                avifEncoderBackupSettings(encoder); // Remember last encoding settings for next avifEncoderDetectChanges().
-                *encoderMinQuantizer = originalMinQuantizer;
-                *encoderMaxQuantizer = originalMaxQuantizer;
+    const int maxThreads = AVIF_MAX(encoder->maxThreads, 1);
+    const uint32_t trialCount = (uint32_t)AVIF_MIN(maxThreads, AVIF_TARGET_SIZE_MAX_PARALLEL_TRIALS);
+    avifTargetSizeTrial trials[AVIF_TARGET_SIZE_MAX_PARALLEL_TRIALS];
+    memset(trials, 0, sizeof(trials));
+    avifEncoder * closest = NULL; // Trial encoder whose file size is the closest to the target so far.
+    int closestQuality = AVIF_QUALITY_DEFAULT;
+    size_t closestSizeDiff = 0;
+    avifResult result = AVIF_RESULT_OK;
+
+    int minQuality = AVIF_QUALITY_WORST; // inclusive
+    int maxQuality = AVIF_QUALITY_BEST;  // inclusive
+    while (minQuality <= maxQuality && result == AVIF_RESULT_OK) {
+        const uint32_t qualityCount = (uint32_t)(maxQuality - minQuality + 1);
+        const uint32_t roundTrialCount = AVIF_MIN(trialCount, qualityCount);
+        for (uint32_t i = 0; i < roundTrialCount; ++i) {
+            avifTargetSizeTrial * trial = &trials[i];
+            // Distinct qualities at the centers of roundTrialCount equal parts of [minQuality:maxQuality].
+            trial->quality = minQuality + (int)(((2 * i + 1) * qualityCount) / (2 * roundTrialCount));
+            trial->encoder = avifEncoderCreateTrial(encoder, trial->quality, AVIF_MAX(maxThreads / (int)roundTrialCount, 1));
+            if (!trial->encoder) {
+                result = AVIF_RESULT_OUT_OF_MEMORY;
+                break;
             }
-#endif // AVIF_ENABLE_EXPERIMENTAL_SAMPLE_TRANSFORM
-            if (cellImagePlaceholder) {
-                avifImageDestroy(cellImagePlaceholder);
+            trial->gridCols = gridCols;
+            trial->gridRows = gridRows;
+            trial->cellImages = cellImages;
+            trial->durationInTimescales = durationInTimescales;
+            trial->addImageFlags = addImageFlags;
+            trial->size = 0;
+            trial->result = AVIF_RESULT_OK;
+        }
+        if (result == AVIF_RESULT_OK) {
+            if (!avifRunInParallel(encoder->threadPool, avifTargetSizeTrialWorker, trials, sizeof(trials[0]), roundTrialCount)) {
+                result = AVIF_RESULT_UNKNOWN_ERROR;
+            }
+        }
+
+        // The trials are sorted by increasing quality. Assume that the file size increases with the quality.
+        int qualityBelowTarget = minQuality - 1;
+        int qualityAboveTarget = maxQuality + 1;
+        for (uint32_t i = 0; i < roundTrialCount; ++i) {
+            avifTargetSizeTrial * trial = &trials[i];
+            if (result == AVIF_RESULT_OK && trial->result != AVIF_RESULT_OK) {
+                result = trial->result;
+                if (*trial->encoder->diag.error) {
+                    avifDiagnosticsPrintf(&encoder->diag, "%s", trial->encoder->diag.error);
+                }
             }
-            if (encodeResult == AVIF_RESULT_UNKNOWN_ERROR) {
-                encodeResult = avifGetErrorForItemCategory(item->itemCategory);
+            if (result == AVIF_RESULT_OK) {
+                const size_t sizeDiff = (trial->size > encoder->targetSizeBytes) ? trial->size - encoder->targetSizeBytes
+                                                                                 : encoder->targetSizeBytes - trial->size;
+                if (!closest || sizeDiff < closestSizeDiff) {
+                    // Keep the closest trial and its encoded samples.
+                    if (closest) {
+                        avifEncoderDestroy(closest);
+                    }
+                    closest = trial->encoder;
+                    trial->encoder = NULL;
+                    closestQuality = trial->quality;
+                    closestSizeDiff = sizeDiff;
+                }
+                if (trial->size <= encoder->targetSizeBytes) {
+                    qualityBelowTarget = AVIF_MAX(qualityBelowTarget, trial->quality);
+                } else {
+                    qualityAboveTarget = AVIF_MIN(qualityAboveTarget, trial->quality);
+                }
             }
-            AVIF_CHECKRES(encodeResult);
-            if (itemIndex == 0 && avifEncoderDataShouldForceKeyframeForAlpha(encoder->data, item, addImageFlags)) {
-                addImageFlags |= AVIF_ADD_IMAGE_FLAG_FORCE_KEYFRAME;
+            if (trial->encoder) {
+                avifEncoderDestroy(trial->encoder);
+                trial->encoder = NULL;
             }
         }
+        if (closestSizeDiff == 0) {
+            break;
+        }
+        minQuality = qualityBelowTarget + 1;
+        maxQuality = qualityAboveTarget - 1;
     }
 
-    avifCodecSpecificOptionsClear(encoder->csOptions);
-    avifEncoderFrame * frame = (avifEncoderFrame *)avifArrayPush(&encoder->data->frames);
-    AVIF_CHECKERR(frame != NULL, AVIF_RESULT_OUT_OF_MEMORY);
-    frame->durationInTimescales = durationInTimescales;
-    return AVIF_RESULT_OK;
+    if (result == AVIF_RESULT_OK) {
+        AVIF_ASSERT_OR_RETURN(closest != NULL);
+        // Take over the encoded samples of the selected trial. avifEncoderFinish() will only assemble the file.
+        avifEncoderData * data = encoder->data;
+        encoder->data = closest->data;
+        closest->data = data;
+        for (uint32_t itemIndex = 0; itemIndex < encoder->data->items.count; ++itemIndex) {
+            avifCodec * codec = encoder->data->items.item[itemIndex].codec;
+            if (codec) {
+                codec->csOptions = encoder->csOptions;
+                codec->diag = &encoder->diag;
+            }
+        }
+        encoder->quality = closestQuality;
+        encoder->qualityAlpha = closestQuality;
+#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
+        encoder->qualityGainMap = closestQuality;
+#endif
+        avifCodecSpecificOptionsClear(encoder->csOptions);
+    }
+    if (closest) {
+        avifEncoderDestroy(closest);
+    }
+    return result;
 }
 
 avifResult avifEncoderAddImage(avifEncoder * encoder, const avifImage * image, uint64_t durationInTimescales, avifAddImageFlags addImageFlags)
 {
     avifDiagnosticsClearError(&encoder->diag);
+    if (encoder->targetSizeBytes != 0) {
+        return avifEncoderAddImageWithTargetSize(encoder, 1, 1, &image, durationInTimescales, addImageFlags);
+    }
     return avifEncoderAddImageInternal(encoder, 1, 1, &image, durationInTimescales, addImageFlags);
 }
 
@@ -2099,40 +2691,160 @@ avifResult avifEncoderAddImageGrid(avifEncoder * encoder,
     if (encoder->extraLayerCount == 0) {
         addImageFlags |= AVIF_ADD_IMAGE_FLAG_SINGLE; // image grids cannot be image sequences
     }
+    if (encoder->targetSizeBytes != 0) {
+        return avifEncoderAddImageWithTargetSize(encoder, gridCols, gridRows, cellImages, 1, addImageFlags);
+    }
     return avifEncoderAddImageInternal(encoder, gridCols, gridRows, cellImages, 1, addImageFlags);
 }
 
-static size_t avifEncoderFindExistingChunk(avifRWStream * s, size_t mdatStartOffset, const uint8_t * data, size_t size)
+// Chunks already laid out in the mdat box, indexed by a hash of their contents, to deduplicate identical payloads (such as
+// identical grid cells) without searching the whole mdat box for each item.
+typedef struct avifEncoderChunk
 {
-    const size_t mdatCurrentOffset = avifRWStreamOffset(s);
-    const size_t mdatSearchSize = mdatCurrentOffset - mdatStartOffset;
-    if (mdatSearchSize < size) {
-        return 0;
-    }
-    const size_t mdatEndSearchOffset = mdatCurrentOffset - size;
-    for (size_t searchOffset = mdatStartOffset; searchOffset <= mdatEndSearchOffset; ++searchOffset) {
-        if (!memcmp(data, &s->raw->data[searchOffset], size)) {
-            return searchOffset;
+    uint64_t hash;
+    const uint8_t * data;
+    size_t offset; // 0 for empty slots. Chunks are never at offset 0 because they follow the mdat box header.
+    size_t size;
+} avifEncoderChunk;
+
+typedef struct avifEncoderChunkIndex
+{
+    avifEncoderChunk * chunks; // Open addressing hash table with linear probing.
+    size_t capacity;           // Power of two, larger than the number of chunks that can be added.
+} avifEncoderChunkIndex;
+
+// Payload of the mdat box. The payloads are not copied while the file is laid out. They are only referenced here, in file
+// order, and written once all offsets are known.
+typedef struct avifEncoderMdatChunk
+{
+    const uint8_t * data;
+    size_t size;
+} avifEncoderMdatChunk;
+AVIF_ARRAY_DECLARE(avifEncoderMdatChunkArray, avifEncoderMdatChunk, chunk);
+
+typedef struct avifEncoderMediaData
+{
+    avifEncoderChunkIndex index;
+    avifEncoderMdatChunkArray chunks;
+    size_t endOffset; // Offset in the file of the end of the last chunk.
+} avifEncoderMediaData;
+
+static avifResult avifEncoderMediaDataCreate(avifEncoderMediaData * mediaData, const avifEncoder * encoder)
+{
+    memset(mediaData, 0, sizeof(avifEncoderMediaData));
+    size_t maxChunkCount = 0;
+    for (uint32_t itemIndex = 0; itemIndex < encoder->data->items.count; ++itemIndex) {
+        const avifEncoderItem * item = &encoder->data->items.item[itemIndex];
+        maxChunkCount += (item->encodeOutput->samples.count > 0) ? item->encodeOutput->samples.count : 1;
+    }
+    // Keep the load factor at most 1/2.
+    avifEncoderChunkIndex * index = &mediaData->index;
+    index->capacity = 16;
+    while (index->capacity < maxChunkCount * 2) {
+        AVIF_CHECKERR(index->capacity <= SIZE_MAX / 2 / sizeof(avifEncoderChunk), AVIF_RESULT_OUT_OF_MEMORY);
+        index->capacity *= 2;
+    }
+    index->chunks = (avifEncoderChunk *)avifAlloc(index->capacity * sizeof(avifEncoderChunk));
+    AVIF_CHECKERR(index->chunks != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+    memset(index->chunks, 0, index->capacity * sizeof(avifEncoderChunk));
+    AVIF_CHECKERR(avifArrayCreate(&mediaData->chunks, sizeof(avifEncoderMdatChunk), 16), AVIF_RESULT_OUT_OF_MEMORY);
+    return AVIF_RESULT_OK;
+}
+
+static void avifEncoderMediaDataDestroy(avifEncoderMediaData * mediaData)
+{
+    avifFree(mediaData->index.chunks);
+    mediaData->index.chunks = NULL;
+    mediaData->index.capacity = 0;
+    avifArrayDestroy(&mediaData->chunks);
+}
+
+// FNV-1a applied to 64-bit words. Collisions are resolved by comparing the bytes.
+static uint64_t avifEncoderChunkHash(const uint8_t * data, size_t size)
+{
+    const uint64_t prime = 0x100000001b3ull;
+    uint64_t hash = 0xcbf29ce484222325ull ^ size;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, &data[i], sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return hash ^ (hash >> 32);
+}
+
+// Returns the offset of a chunk identical to data that was previously laid out, or 0 if there is none.
+static size_t avifEncoderFindExistingChunk(const avifEncoderMediaData * mediaData,
+                                           uint64_t hash,
+                                           const uint8_t * data,
+                                           size_t size)
+{
+    const avifEncoderChunkIndex * index = &mediaData->index;
+    size_t slot = (size_t)hash & (index->capacity - 1);
+    for (size_t probeCount = 0; probeCount < index->capacity; ++probeCount) {
+        const avifEncoderChunk * chunk = &index->chunks[slot];
+        if (chunk->offset == 0) {
+            break;
+        }
+        if ((chunk->hash == hash) && (chunk->size == size) && !memcmp(chunk->data, data, size)) {
+            return chunk->offset;
         }
+        slot = (slot + 1) & (index->capacity - 1);
     }
     return 0;
 }
 
+// Lays out the size bytes at data at the end of the mdat box, without copying them, and sets *offset to their offset in the
+// file. Identical chunks appended later are found after the first one, so avifEncoderFindExistingChunk() always returns the
+// earliest offset.
+static avifResult avifEncoderMediaDataAppend(avifEncoderMediaData * mediaData,
+                                             uint64_t hash,
+                                             const uint8_t * data,
+                                             size_t size,
+                                             size_t * offset)
+{
+    AVIF_ASSERT_OR_RETURN(mediaData->endOffset != 0);
+    AVIF_CHECKERR(size <= SIZE_MAX - mediaData->endOffset, AVIF_RESULT_OUT_OF_MEMORY);
+    avifEncoderChunkIndex * index = &mediaData->index;
+    size_t slot = (size_t)hash & (index->capacity - 1);
+    for (size_t probeCount = 0; index->chunks[slot].offset != 0; ++probeCount) {
+        AVIF_ASSERT_OR_RETURN(probeCount < index->capacity);
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    index->chunks[slot].hash = hash;
+    index->chunks[slot].data = data;
+    index->chunks[slot].offset = mediaData->endOffset;
+    index->chunks[slot].size = size;
+
+    avifEncoderMdatChunk * chunk = (avifEncoderMdatChunk *)avifArrayPush(&mediaData->chunks);
+    AVIF_CHECKERR(chunk != NULL, AVIF_RESULT_OUT_OF_MEMORY);
+    chunk->data = data;
+    chunk->size = size;
+    *offset = mediaData->endOffset;
+    mediaData->endOffset += size;
+    return AVIF_RESULT_OK;
+}
+
 static avifResult avifEncoderWriteMediaDataBox(avifEncoder * encoder,
                                                avifRWStream * s,
                                                avifEncoderItemReferenceArray * layeredColorItems,
-                                               avifEncoderItemReferenceArray * layeredAlphaItems)
+                                               avifEncoderItemReferenceArray * layeredAlphaItems,
+                                               avifEncoderMediaData * mediaData)
 {
     encoder->ioStats.colorOBUSize = 0;
     encoder->ioStats.alphaOBUSize = 0;
     encoder->data->gainMapSizeBytes = 0;
 
+    // Only the box header is written to s. The payloads are laid out in mediaData.
     avifBoxMarker mdat;
     AVIF_CHECKRES(avifRWStreamWriteBox(s, "mdat", AVIF_BOX_SIZE_TBD, &mdat));
-    const size_t mdatStartOffset = avifRWStreamOffset(s);
+    mediaData->endOffset = avifRWStreamOffset(s);
     for (uint32_t itemPasses = 0; itemPasses < 3; ++itemPasses) {
         // Use multiple passes to pack in the following order:
-        //   * Pass 0: metadata (Exif/XMP)
+        //   * Pass 0: metadata (Exif/XMP), thumbnails (AV1)
         //   * Pass 1: alpha, gain map (AV1)
         //   * Pass 2: all other item data (AV1 color)
         //
@@ -2141,7 +2853,8 @@ static avifResult avifEncoderWriteMediaDataBox(avifEncoder * encoder,
         //
         // Exif and XMP are packed first as they're required to be fully available
         // by avifDecoderParse() before it returns AVIF_RESULT_OK, unless ignoreXMP
-        // and ignoreExif are enabled.
+        // and ignoreExif are enabled. Thumbnails follow so that a preview can be
+        // decoded from the beginning of a partially downloaded file.
         //
         const avifBool metadataPass = (itemPasses == 0);
         const avifBool alphaAndGainMapPass = (itemPasses == 1);
@@ -2153,8 +2866,8 @@ static avifResult avifEncoderWriteMediaDataBox(avifEncoder * encoder,
                 continue;
             }
             const avifBool isMetadata = !memcmp(item->type, "mime", 4) || !memcmp(item->type, "Exif", 4);
-            if (metadataPass != isMetadata) {
-                // only process metadata (XMP/Exif) payloads when metadataPass is true
+            if (metadataPass != (isMetadata || item->thumbnail)) {
+                // only process metadata (XMP/Exif) and thumbnail payloads when metadataPass is true
                 continue;
             }
             const avifBool isAlpha = avifIsAlpha(item->itemCategory);
@@ -2163,7 +2876,7 @@ static avifResult avifEncoderWriteMediaDataBox(avifEncoder * encoder,
                                               || item->itemCategory == AVIF_ITEM_GAIN_MAP
 #endif
                 ;
-            if (alphaAndGainMapPass != isAlphaOrGainMap) {
+            if (!metadataPass && (alphaAndGainMapPass != isAlphaOrGainMap)) {
                 // only process alpha payloads when alphaPass is true
                 continue;
             }
@@ -2184,22 +2897,35 @@ static avifResult avifEncoderWriteMediaDataBox(avifEncoder * encoder,
 
             // Deduplication - See if an identical chunk to this has already been written.
             // Doing it when item->encodeOutput->samples.count > 1 would require contiguous memory.
+            uint64_t chunkHash = 0;
             if (item->encodeOutput->samples.count == 1) {
                 avifEncodeSample * sample = &item->encodeOutput->samples.sample[0];
-                chunkOffset = avifEncoderFindExistingChunk(s, mdatStartOffset, sample->data.data, sample->data.size);
+                chunkHash = avifEncoderChunkHash(sample->data.data, sample->data.size);
+                chunkOffset = avifEncoderFindExistingChunk(mediaData, chunkHash, sample->data.data, sample->data.size);
             } else if (item->encodeOutput->samples.count == 0) {
-                chunkOffset = avifEncoderFindExistingChunk(s, mdatStartOffset, item->metadataPayload.data, item->metadataPayload.size);
+                const avifRWData * payload = &item->metadataPayload;
+                chunkHash = avifEncoderChunkHash(payload->data, payload->size);
+                chunkOffset = avifEncoderFindExistingChunk(mediaData, chunkHash, payload->data, payload->size);
             }
 
             if (!chunkOffset) {
                 // We've never seen this chunk before; write it out
-                chunkOffset = avifRWStreamOffset(s);
+                chunkOffset = mediaData->endOffset;
                 if (item->encodeOutput->samples.count > 0) {
                     for (uint32_t sampleIndex = 0; sampleIndex < item->encodeOutput->samples.count; ++sampleIndex) {
                         avifEncodeSample * sample = &item->encodeOutput->samples.sample[sampleIndex];
-                        AVIF_CHECKRES(avifRWStreamWrite(s, sample->data.data, sample->data.size));
-
-                        if (isAlpha) {
+                        // Each sample can be reused by a later item, even if it belongs to a sequence.
+                        const uint64_t sampleHash = (item->encodeOutput->samples.count == 1)
+                                                        ? chunkHash
+                                                        : avifEncoderChunkHash(sample->data.data, sample->data.size);
+                        const avifRWData * sampleData = &sample->data;
+                        size_t sampleOffset;
+                        AVIF_CHECKRES(
+                            avifEncoderMediaDataAppend(mediaData, sampleHash, sampleData->data, sampleData->size, &sampleOffset));
+
+                        if (item->thumbnail) {
+                            // Not accounted for in ioStats, which describe the primary image.
+                        } else if (isAlpha) {
                             encoder->ioStats.alphaOBUSize += sample->data.size;
                         } else if (item->itemCategory == AVIF_ITEM_COLOR) {
                             encoder->ioStats.colorOBUSize += sample->data.size;
@@ -2210,7 +2936,8 @@ static avifResult avifEncoderWriteMediaDataBox(avifEncoder * encoder,
                         }
                     }
                 } else {
-                    AVIF_CHECKRES(avifRWStreamWrite(s, item->metadataPayload.data, item->metadataPayload.size));
+                    const avifRWData * payload = &item->metadataPayload;
+                    AVIF_CHECKRES(avifEncoderMediaDataAppend(mediaData, chunkHash, payload->data, payload->size, &chunkOffset));
                 }
             }
 
@@ -2251,11 +2978,11 @@ static avifResult avifEncoderWriteMediaDataBox(avifEncoder * encoder,
                         hasMoreSample = AVIF_TRUE;
                     }
                     avifRWData * data = &item->encodeOutput->samples.sample[layerIndex].data;
-                    size_t chunkOffset = avifEncoderFindExistingChunk(s, mdatStartOffset, data->data, data->size);
+                    const uint64_t chunkHash = avifEncoderChunkHash(data->data, data->size);
+                    size_t chunkOffset = avifEncoderFindExistingChunk(mediaData, chunkHash, data->data, data->size);
                     if (!chunkOffset) {
                         // We've never seen this chunk before; write it out
-                        chunkOffset = avifRWStreamOffset(s);
-                        AVIF_CHECKRES(avifRWStreamWrite(s, data->data, data->size));
+                        AVIF_CHECKRES(avifEncoderMediaDataAppend(mediaData, chunkHash, data->data, data->size, &chunkOffset));
                         if (samplePass == 0) {
                             encoder->ioStats.alphaOBUSize += data->size;
                         } else {
@@ -2274,7 +3001,12 @@ static avifResult avifEncoderWriteMediaDataBox(avifEncoder * encoder,
 
         AVIF_ASSERT_OR_RETURN(layerIndex <= AVIF_MAX_AV1_LAYER_COUNT);
     }
-    avifRWStreamFinishBox(s, mdat);
+
+    // Same as avifRWStreamFinishBox() but accounting for the payloads that are not in s.
+    const size_t prevOffset = avifRWStreamOffset(s);
+    avifRWStreamSetOffset(s, mdat);
+    AVIF_CHECKRES(avifRWStreamWriteU32(s, (uint32_t)(mediaData->endOffset - mdat)));
+    avifRWStreamSetOffset(s, prevOffset);
     return AVIF_RESULT_OK;
 }
 
@@ -2299,6 +3031,29 @@ static avifResult avifWriteAltrGroup(avifRWStream * s, uint32_t groupID, const a
     return AVIF_RESULT_OK;
 }
 
+// Returns an upper bound of the size of the file written by avifEncoderFinish(), in practice, so that it can be written without
+// reallocating the output buffer. Only the payloads are accounted for exactly. The boxes describing them are overestimated,
+// by less than the unused capacity that avifRWStreamFinishWrite() keeps for typical files, so that it does not shrink the
+// buffer either.
+static size_t avifEncoderEstimateOutputSize(const avifEncoder * encoder, avifBool includePayloads)
+{
+    // ftyp, meta and moov boxes and their fixed-size children.
+    size_t size = 2048 + encoder->data->imageMetadata->icc.size;
+#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
+    size += encoder->data->altImageMetadata->icc.size;
+#endif
+    for (uint32_t itemIndex = 0; itemIndex < encoder->data->items.count; ++itemIndex) {
+        const avifEncoderItem * item = &encoder->data->items.item[itemIndex];
+        // infe, iloc, ipma, iref entries and item properties.
+        size += 256 + (includePayloads ? item->metadataPayload.size : 0);
+        for (uint32_t sampleIndex = 0; sampleIndex < item->encodeOutput->samples.count; ++sampleIndex) {
+            // Sample table entries (stts, stsz, stco, stss) for sequences.
+            size += (includePayloads ? item->encodeOutput->samples.sample[sampleIndex].data.size : 0) + 32;
+        }
+    }
+    return size;
+}
+
 #if defined(AVIF_ENABLE_EXPERIMENTAL_MINI)
 // Returns true if the image can be encoded with a MinimizedImageBox instead of a full regular MetaBox.
 static avifBool avifEncoderIsMiniCompatible(const avifEncoder * encoder)
@@ -2390,6 +3145,7 @@ static avifResult avifEncoderWriteFileTypeBoxAndMetaBoxV1(avifEncoder * encoder,
 {
     avifRWStream s;
     avifRWStreamStart(&s, output);
+    AVIF_CHECKRES(avifRWStreamReserve(&s, avifEncoderEstimateOutputSize(encoder, /*includePayloads=*/AVIF_TRUE)));
 
     avifBoxMarker ftyp;
     AVIF_CHECKRES(avifRWStreamWriteBox(&s, "ftyp", AVIF_BOX_SIZE_TBD, &ftyp));
@@ -2759,6 +3515,9 @@ static avifResult avifRWStreamWriteProperties(avifItemPropertyDedup * const dedu
 #else
         (void)altImageMetadata;
 #endif
+        if (item->thumbnail) {
+            itemMetadata = encoder->data->thumbnailMetadata;
+        }
         uint32_t imageWidth = itemMetadata->width;
         uint32_t imageHeight = itemMetadata->height;
         if (isGrid) {
@@ -2929,7 +3688,19 @@ static avifResult avifRWStreamWriteProperties(avifItemPropertyDedup * const dedu
     return AVIF_RESULT_OK;
 }
 
-avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output)
+// Writes the given size bytes of data at offset to io.
+static avifResult avifEncoderWriteToIO(avifEncoder * encoder, avifIO * io, uint64_t offset, const uint8_t * data, size_t size)
+{
+    const avifResult result = io->write(io, /*writeFlags=*/0, offset, data, size);
+    if (result != AVIF_RESULT_OK) {
+        avifDiagnosticsPrintf(&encoder->diag, "Failed to write %zu bytes at offset %" PRIu64, size, offset);
+    }
+    return result;
+}
+
+// If io is NULL, the whole file is written to output. Otherwise the boxes preceding the payloads of the mdat box are assembled
+// in output, then written to io followed by the payloads.
+static avifResult avifEncoderFinishInternal(avifEncoder * encoder, avifRWData * output, avifIO * io)
 {
     avifDiagnosticsClearError(&encoder->diag);
     if (encoder->data->items.count == 0) {
@@ -2946,8 +3717,11 @@ avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output)
 
     for (uint32_t itemIndex = 0; itemIndex < encoder->data->items.count; ++itemIndex) {
         avifEncoderItem * item = &encoder->data->items.item[itemIndex];
+        // Offsets recorded by a previous call to this function point into its own output, such as those of a trial
+        // encode of avifEncoderAddImageWithTargetSize().
+        item->mdatFixups.count = 0;
         if (item->codec) {
-            if (!item->codec->encodeFinish(item->codec, item->encodeOutput)) {
+            if (!encoder->data->codecsFinished && !item->codec->encodeFinish(item->codec, item->encodeOutput)) {
                 return avifGetErrorForItemCategory(item->itemCategory);
             }
 
@@ -2966,6 +3740,9 @@ avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output)
         }
     }
 
+    // The encoded samples are kept so that this function can be called again, but the codecs cannot be flushed twice.
+    encoder->data->codecsFinished = AVIF_TRUE;
+
     // -----------------------------------------------------------------------
     // Harvest configuration properties from sequence headers
 
@@ -2987,6 +3764,9 @@ avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output)
     // Decide whether to go for a reduced MinimizedImageBox or a full regular MetaBox.
     if ((encoder->headerFormat == AVIF_HEADER_REDUCED) && avifEncoderIsMiniCompatible(encoder)) {
         AVIF_CHECKRES(avifEncoderWriteFileTypeBoxAndMetaBoxV1(encoder, output));
+        if (io != NULL) {
+            AVIF_CHECKRES(avifEncoderWriteToIO(encoder, io, 0, output->data, output->size));
+        }
         return AVIF_RESULT_OK;
     }
 #endif // AVIF_ENABLE_EXPERIMENTAL_MINI
@@ -2999,6 +3779,8 @@ avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output)
 
     avifRWStream s;
     avifRWStreamStart(&s, output);
+    // Write the whole file (or only its boxes if the payloads are streamed to io) with a single allocation, in most cases.
+    AVIF_CHECKRES(avifRWStreamReserve(&s, avifEncoderEstimateOutputSize(encoder, /*includePayloads=*/io == NULL)));
 
     // -----------------------------------------------------------------------
     // Write ftyp
@@ -3301,9 +4083,9 @@ avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output)
         //   group_id value of any other EntityToGroupBox, any item_ID value of the hierarchy level
         //   (file, movie. or track) that contains the GroupsListBox, or any track_ID value (when the
         //   GroupsListBox is contained in the file level).
+        // lastItemID is left untouched so that this function writes the same IDs if called again.
         AVIF_ASSERT_OR_RETURN(encoder->data->lastItemID < UINT16_MAX);
-        ++encoder->data->lastItemID;
-        const uint32_t groupID = encoder->data->lastItemID;
+        const uint32_t groupID = encoder->data->lastItemID + 1;
         AVIF_CHECKRES(avifWriteAltrGroup(&s, groupID, &encoder->data->alternativeItemIDs));
     }
 
@@ -3618,25 +4400,124 @@ avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output)
     if (!avifArrayCreate(&layeredAlphaItems, sizeof(avifEncoderItemReference), 1)) {
         result = AVIF_RESULT_OUT_OF_MEMORY;
     }
+    avifEncoderMediaData mediaData;
+    memset(&mediaData, 0, sizeof(mediaData));
     if (result == AVIF_RESULT_OK) {
-        result = avifEncoderWriteMediaDataBox(encoder, &s, &layeredColorItems, &layeredAlphaItems);
+        result = avifEncoderMediaDataCreate(&mediaData, encoder);
+    }
+    if (result == AVIF_RESULT_OK) {
+        result = avifEncoderWriteMediaDataBox(encoder, &s, &layeredColorItems, &layeredAlphaItems, &mediaData);
     }
     avifArrayDestroy(&layeredColorItems);
     avifArrayDestroy(&layeredAlphaItems);
-    AVIF_CHECKRES(result);
 
     // -----------------------------------------------------------------------
-    // Finish up stream
+    // Write the payloads of the mdat box and finish up stream
 
-    avifRWStreamFinishWrite(&s);
+    if (io == NULL) {
+        for (uint32_t chunkIndex = 0; (result == AVIF_RESULT_OK) && (chunkIndex < mediaData.chunks.count); ++chunkIndex) {
+            const avifEncoderMdatChunk * chunk = &mediaData.chunks.chunk[chunkIndex];
+            result = avifRWStreamWrite(&s, chunk->data, chunk->size);
+        }
+        avifRWStreamFinishWrite(&s);
+    } else {
+        avifRWStreamFinishWrite(&s);
+        if (result == AVIF_RESULT_OK) {
+            result = avifEncoderWriteToIO(encoder, io, 0, output->data, output->size);
+        }
+        uint64_t offset = output->size;
+        for (uint32_t chunkIndex = 0; (result == AVIF_RESULT_OK) && (chunkIndex < mediaData.chunks.count); ++chunkIndex) {
+            const avifEncoderMdatChunk * chunk = &mediaData.chunks.chunk[chunkIndex];
+            result = avifEncoderWriteToIO(encoder, io, offset, chunk->data, chunk->size);
+            offset += chunk->size;
+        }
+    }
+    avifEncoderMediaDataDestroy(&mediaData);
+    AVIF_CHECKRES(result);
 
 #if defined(AVIF_ENABLE_COMPLIANCE_WARDEN)
-    AVIF_CHECKRES(avifIsCompliant(output->data, output->size));
+    if (io == NULL) {
+        AVIF_CHECKRES(avifIsCompliant(output->data, output->size));
+    }
 #endif
 
     return AVIF_RESULT_OK;
 }
 
+avifResult avifEncoderFinish(avifEncoder * encoder, avifRWData * output)
+{
+    return avifEncoderFinishInternal(encoder, output, /*io=*/NULL);
+}
+
+avifResult avifEncoderFinishToIO(avifEncoder * encoder, avifIO * io)
+{
+    AVIF_CHECKERR(io != NULL && io->write != NULL, AVIF_RESULT_INVALID_ARGUMENT);
+    // Only the boxes are assembled in memory. The payloads are written to io from where they are stored in encoder.
+    avifRWData header = AVIF_DATA_EMPTY;
+    const avifResult result = avifEncoderFinishInternal(encoder, &header, io);
+    avifRWDataFree(&header);
+    return result;
+}
+
+avifResult avifEncoderReset(avifEncoder * encoder)
+{
+    avifEncoderData * data = encoder->data;
+
+    // Keep the codec instances that can encode another image of the same properties.
+    const avifImage * imageMetadata = data->imageMetadata;
+    for (uint32_t i = 0; i < data->items.count; ++i) {
+        avifEncoderItem * item = &data->items.item[i];
+        avifCodec * codec = item->codec;
+        if (!codec || !codec->keepEncoderAlive || !codec->encodeReset || !codec->encodeReset(codec)) {
+            continue;
+        }
+        avifEncoderWarmCodec * warmCodec = (avifEncoderWarmCodec *)avifArrayPush(&data->warmCodecs);
+        if (!warmCodec) {
+            continue; // The codec is destroyed with the item below.
+        }
+        warmCodec->codec = codec;
+        warmCodec->itemCategory = item->itemCategory;
+        warmCodec->width = imageMetadata->width;
+        warmCodec->height = imageMetadata->height;
+        warmCodec->depth = imageMetadata->depth;
+        warmCodec->yuvFormat = imageMetadata->yuvFormat;
+        warmCodec->yuvRange = imageMetadata->yuvRange;
+        warmCodec->yuvChromaSamplePosition = imageMetadata->yuvChromaSamplePosition;
+        warmCodec->colorPrimaries = imageMetadata->colorPrimaries;
+        warmCodec->transferCharacteristics = imageMetadata->transferCharacteristics;
+        warmCodec->matrixCoefficients = imageMetadata->matrixCoefficients;
+        item->codec = NULL;
+    }
+
+    // Reset the container state only.
+    avifEncoderDataDestroyItems(data);
+    data->frames.count = 0;
+    data->alternativeItemIDs.count = 0;
+    data->lastItemID = 0;
+    data->primaryItemID = 0;
+    data->singleImage = AVIF_FALSE;
+    data->alphaPresent = AVIF_FALSE;
+    data->codecsFinished = AVIF_FALSE;
+    data->gainMapSizeBytes = 0;
+    avifImage * emptyImageMetadata = avifImageCreateEmpty();
+    AVIF_CHECKERR(emptyImageMetadata, AVIF_RESULT_OUT_OF_MEMORY);
+    avifImageDestroy(data->imageMetadata);
+    data->imageMetadata = emptyImageMetadata;
+#if defined(AVIF_ENABLE_EXPERIMENTAL_GAIN_MAP)
+    avifImage * emptyAltImageMetadata = avifImageCreateEmpty();
+    AVIF_CHECKERR(emptyAltImageMetadata, AVIF_RESULT_OUT_OF_MEMORY);
+    avifImageDestroy(data->altImageMetadata);
+    data->altImageMetadata = emptyAltImageMetadata;
+#endif
+    if (data->warmCodecs.count == 0) {
+        // Without any codec to reuse, the next image is encoded as if the encoder was just created.
+        memset(&data->lastEncoder, 0, sizeof(data->lastEncoder));
+    }
+    memset(&encoder->ioStats, 0, sizeof(encoder->ioStats));
+    avifDiagnosticsClearError(&encoder->diag);
+    return AVIF_RESULT_OK;
+}
+
 avifResult avifEncoderWrite(avifEncoder * encoder, const avifImage * image, avifRWData * output)
 {
     avifResult addImageResult = avifEncoderAddImage(encoder, image, 1, AVIF_ADD_IMAGE_FLAG_SINGLE);
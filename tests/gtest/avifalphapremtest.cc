@@ -61,6 +61,60 @@ TEST(AlphaMultiplyTest, OpaqueIsNoOp) {
   }
 }
 
+// The alpha (un)multiplication done by avifImageYUVToRGB() during the
+// conversion must match the one of a separate call to
+// avifRGBImagePremultiplyAlpha() or avifRGBImageUnpremultiplyAlpha().
+TEST(AlphaMultiplyTest, SameAsSeparateStep) {
+  for (avifPixelFormat yuv_format :
+       {AVIF_PIXEL_FORMAT_YUV444, AVIF_PIXEL_FORMAT_YUV420}) {
+    for (int yuv_depth : {8, 10}) {
+      for (int rgb_depth : {8, 16}) {
+        for (avifRGBFormat rgb_format :
+             {AVIF_RGB_FORMAT_RGBA, AVIF_RGB_FORMAT_ARGB,
+              AVIF_RGB_FORMAT_BGRA}) {
+          for (bool premultiplied_input : {false, true}) {
+            SCOPED_TRACE(testing::Message()
+                         << "yuv_format " << yuv_format << " yuv_depth "
+                         << yuv_depth << " rgb_depth " << rgb_depth
+                         << " rgb_format " << rgb_format
+                         << " premultiplied_input " << premultiplied_input);
+            ImagePtr image = testutil::CreateImage(
+                /*width=*/37, /*height=*/13, yuv_depth, yuv_format,
+                AVIF_PLANES_ALL);
+            ASSERT_NE(image, nullptr);
+            testutil::FillImageGradient(image.get());
+            image->alphaPremultiplied = premultiplied_input;
+
+            // Conversion and (un)multiplication in one call.
+            testutil::AvifRgbImage fused(image.get(), rgb_depth, rgb_format);
+            fused.chromaUpsampling = AVIF_CHROMA_UPSAMPLING_NEAREST;
+            fused.alphaPremultiplied = !premultiplied_input;
+            ASSERT_EQ(avifImageYUVToRGB(image.get(), &fused), AVIF_RESULT_OK);
+
+            // Conversion, then (un)multiplication.
+            testutil::AvifRgbImage separate(image.get(), rgb_depth,
+                                            rgb_format);
+            separate.chromaUpsampling = AVIF_CHROMA_UPSAMPLING_NEAREST;
+            separate.alphaPremultiplied = premultiplied_input;
+            ASSERT_EQ(avifImageYUVToRGB(image.get(), &separate),
+                      AVIF_RESULT_OK);
+            if (premultiplied_input) {
+              ASSERT_EQ(avifRGBImageUnpremultiplyAlpha(&separate),
+                        AVIF_RESULT_OK);
+            } else {
+              ASSERT_EQ(avifRGBImagePremultiplyAlpha(&separate),
+                        AVIF_RESULT_OK);
+            }
+            separate.alphaPremultiplied = !premultiplied_input;
+
+            EXPECT_TRUE(testutil::AreImagesEqual(fused, separate));
+          }
+        }
+      }
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 
 }  // namespace
@@ -1,8 +1,11 @@
 // Copyright 2023 Google LLC
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "avif/avif.h"
 #include "aviftest_helpers.h"
@@ -33,6 +36,524 @@ TEST(AvifDecodeTest, ColorGridAlphaNoGrid) {
   EXPECT_GT(decoder->image->alphaRowBytes, 0u);
 }
 
+TEST(AvifDecodeTest, MultithreadedDecodingMatchesSingleThreaded) {
+  if (!testutil::Av1DecoderAvailable()) {
+    GTEST_SKIP() << "AV1 Codec unavailable, skip test.";
+  }
+  for (const std::string file_name :
+       {"sofa_grid1x5_420.avif", "color_grid_alpha_nogrid.avif",
+        "color_grid_alpha_grid_tile_shared_in_dimg.avif",
+        "draw_points_idat.avif",
+        "colors-animated-8bpc-alpha-exif-xmp.avif"}) {
+    SCOPED_TRACE(file_name);
+    ImagePtr reference;
+    for (int max_threads : {1, 2, 3, 8}) {
+      SCOPED_TRACE(max_threads);
+      DecoderPtr decoder(avifDecoderCreate());
+      ASSERT_NE(decoder, nullptr);
+      decoder->maxThreads = max_threads;
+      ASSERT_EQ(avifDecoderSetIOFile(
+                    decoder.get(), (std::string(data_path) + file_name).c_str()),
+                AVIF_RESULT_OK);
+      ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+      ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+      if (!reference) {
+        reference.reset(avifImageCreateEmpty());
+        ASSERT_NE(reference, nullptr);
+        ASSERT_EQ(avifImageCopy(reference.get(), decoder->image,
+                                AVIF_PLANES_ALL),
+                  AVIF_RESULT_OK);
+      } else {
+        EXPECT_TRUE(testutil::AreImagesEqual(*reference, *decoder->image));
+      }
+    }
+  }
+}
+
+// Returns a copy of the first frame of file_name decoded with decoder.
+ImagePtr DecodeFirstFrame(avifDecoder* decoder, const std::string& file_name) {
+  const std::string path = std::string(data_path) + file_name;
+  if (avifDecoderSetIOFile(decoder, path.c_str()) != AVIF_RESULT_OK ||
+      avifDecoderParse(decoder) != AVIF_RESULT_OK ||
+      avifDecoderNextImage(decoder) != AVIF_RESULT_OK) {
+    return nullptr;
+  }
+  ImagePtr image(avifImageCreateEmpty());
+  if (image == nullptr ||
+      avifImageCopy(image.get(), decoder->image, AVIF_PLANES_ALL) !=
+          AVIF_RESULT_OK) {
+    return nullptr;
+  }
+  return image;
+}
+
+TEST(AvifDecodeTest, ReusedDecoderMatchesNewDecoder) {
+  if (!testutil::Av1DecoderAvailable()) {
+    GTEST_SKIP() << "AV1 Codec unavailable, skip test.";
+  }
+  // Each file is decoded twice, after files with different properties.
+  const std::string file_names[] = {"sofa_grid1x5_420.avif",
+                                    "color_grid_alpha_nogrid.avif",
+                                    "draw_points_idat.avif",
+                                    "colors-animated-8bpc-alpha-exif-xmp.avif",
+                                    "white_1x1.avif",
+                                    "sofa_grid1x5_420.avif",
+                                    "draw_points_idat.avif",
+                                    "colors-animated-8bpc-alpha-exif-xmp.avif",
+                                    "color_grid_alpha_nogrid.avif"};
+  for (int max_threads : {1, 3}) {
+    SCOPED_TRACE(max_threads);
+    DecoderPtr reused_decoder(avifDecoderCreate());
+    ASSERT_NE(reused_decoder, nullptr);
+    reused_decoder->maxThreads = max_threads;
+    for (const std::string& file_name : file_names) {
+      SCOPED_TRACE(file_name);
+      DecoderPtr new_decoder(avifDecoderCreate());
+      ASSERT_NE(new_decoder, nullptr);
+      new_decoder->maxThreads = max_threads;
+      const ImagePtr expected = DecodeFirstFrame(new_decoder.get(), file_name);
+      ASSERT_NE(expected, nullptr);
+      const ImagePtr image = DecodeFirstFrame(reused_decoder.get(), file_name);
+      ASSERT_NE(image, nullptr);
+      EXPECT_TRUE(testutil::AreImagesEqual(*expected, *image));
+
+      // Seeking back also reuses the flushed decoder instances.
+      if (reused_decoder->imageCount > 1) {
+        ASSERT_EQ(avifDecoderNthImage(reused_decoder.get(),
+                                      reused_decoder->imageCount - 1),
+                  AVIF_RESULT_OK);
+        ASSERT_EQ(avifDecoderNthImage(reused_decoder.get(), 0),
+                  AVIF_RESULT_OK);
+        EXPECT_TRUE(
+            testutil::AreImagesEqual(*expected, *reused_decoder->image));
+      }
+    }
+
+    // The idle decoder instances were opened with another thread count, so
+    // new ones are created.
+    reused_decoder->maxThreads = max_threads + 1;
+    for (const std::string& file_name : file_names) {
+      SCOPED_TRACE(file_name);
+      DecoderPtr new_decoder(avifDecoderCreate());
+      ASSERT_NE(new_decoder, nullptr);
+      new_decoder->maxThreads = max_threads + 1;
+      const ImagePtr expected = DecodeFirstFrame(new_decoder.get(), file_name);
+      ASSERT_NE(expected, nullptr);
+      const ImagePtr image = DecodeFirstFrame(reused_decoder.get(), file_name);
+      ASSERT_NE(image, nullptr);
+      EXPECT_TRUE(testutil::AreImagesEqual(*expected, *image));
+    }
+  }
+}
+
+// Returns copies of all the frames of file_name, decoded one after the other.
+std::vector<ImagePtr> DecodeAllFrames(const std::string& file_name) {
+  const std::string path = std::string(data_path) + file_name;
+  DecoderPtr decoder(avifDecoderCreate());
+  if (decoder == nullptr ||
+      avifDecoderSetIOFile(decoder.get(), path.c_str()) != AVIF_RESULT_OK ||
+      avifDecoderParse(decoder.get()) != AVIF_RESULT_OK) {
+    return {};
+  }
+  std::vector<ImagePtr> frames;
+  while (avifDecoderNextImage(decoder.get()) == AVIF_RESULT_OK) {
+    ImagePtr frame(avifImageCreateEmpty());
+    if (frame == nullptr || avifImageCopy(frame.get(), decoder->image,
+                                          AVIF_PLANES_ALL) != AVIF_RESULT_OK) {
+      return {};
+    }
+    frames.push_back(std::move(frame));
+  }
+  if (frames.size() != static_cast<size_t>(decoder->imageCount)) {
+    return {};
+  }
+  return frames;
+}
+
+TEST(AvifDecodeTest, FrameDelayMatchesSingleFrameDecoding) {
+  if (!testutil::Av1DecoderAvailable()) {
+    GTEST_SKIP() << "AV1 Codec unavailable, skip test.";
+  }
+  for (const char* file_name : {"colors-animated-8bpc-alpha-exif-xmp.avif",
+                                "colors-animated-12bpc-keyframes-0-2-3.avif"}) {
+    SCOPED_TRACE(file_name);
+    const std::string path = std::string(data_path) + file_name;
+    const std::vector<ImagePtr> expected_frames = DecodeAllFrames(file_name);
+    ASSERT_GT(expected_frames.size(), 1u);
+
+    for (uint32_t max_frame_delay : {2u, 8u}) {
+      SCOPED_TRACE(max_frame_delay);
+      DecoderPtr decoder(avifDecoderCreate());
+      ASSERT_NE(decoder, nullptr);
+      decoder->maxThreads = 4;
+      decoder->maxFrameDelay = max_frame_delay;
+      ASSERT_EQ(avifDecoderSetIOFile(decoder.get(), path.c_str()),
+                AVIF_RESULT_OK);
+      ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+      for (const ImagePtr& expected_frame : expected_frames) {
+        ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+        EXPECT_TRUE(testutil::AreImagesEqual(*expected_frame, *decoder->image));
+      }
+      EXPECT_EQ(avifDecoderNextImage(decoder.get()),
+                AVIF_RESULT_NO_IMAGES_REMAINING);
+
+      // Seeking flushes the frames in flight.
+      for (size_t index : {expected_frames.size() - 1, size_t{0}, size_t{1}}) {
+        ASSERT_EQ(avifDecoderNthImage(decoder.get(), static_cast<int>(index)),
+                  AVIF_RESULT_OK);
+        EXPECT_TRUE(
+            testutil::AreImagesEqual(*expected_frames[index], *decoder->image));
+      }
+    }
+  }
+}
+
+TEST(AvifDecodeTest, Dav1dFrameDelayOutputsFirstFrame) {
+  if (avifCodecName(AVIF_CODEC_CHOICE_DAV1D, AVIF_CODEC_FLAG_CAN_DECODE) ==
+      nullptr) {
+    GTEST_SKIP() << "dav1d unavailable, skip test.";
+  }
+  const char* file_name = "colors-animated-8bpc-alpha-exif-xmp.avif";
+  const std::string path = std::string(data_path) + file_name;
+  const std::vector<ImagePtr> expected_frames = DecodeAllFrames(file_name);
+  ASSERT_GT(expected_frames.size(), 1u);
+
+  // With as many dav1d frame threads as maxFrameDelay, the first frame is only
+  // output once the decoder is drained.
+  for (const std::pair<int, uint32_t>& threads_and_delay :
+       std::vector<std::pair<int, uint32_t>>{{2, 2}, {4, 2}, {4, 4}, {8, 8}}) {
+    const int max_threads = threads_and_delay.first;
+    const uint32_t max_frame_delay = threads_and_delay.second;
+    SCOPED_TRACE(max_threads);
+    SCOPED_TRACE(max_frame_delay);
+    DecoderPtr decoder(avifDecoderCreate());
+    ASSERT_NE(decoder, nullptr);
+    decoder->codecChoice = AVIF_CODEC_CHOICE_DAV1D;
+    decoder->maxThreads = max_threads;
+    decoder->maxFrameDelay = max_frame_delay;
+    ASSERT_EQ(avifDecoderSetIOFile(decoder.get(), path.c_str()),
+              AVIF_RESULT_OK);
+    ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+    ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+    EXPECT_TRUE(testutil::AreImagesEqual(*expected_frames[0], *decoder->image));
+    ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+    EXPECT_TRUE(testutil::AreImagesEqual(*expected_frames[1], *decoder->image));
+  }
+}
+
+TEST(AvifDecodeTest, FrameCacheMatchesDecoding) {
+  if (!testutil::Av1DecoderAvailable()) {
+    GTEST_SKIP() << "AV1 Codec unavailable, skip test.";
+  }
+  const char* file_name = "colors-animated-12bpc-keyframes-0-2-3.avif";
+  const std::string path = std::string(data_path) + file_name;
+  const std::vector<ImagePtr> expected_frames = DecodeAllFrames(file_name);
+  ASSERT_GT(expected_frames.size(), 3u);
+  const size_t frame_size = expected_frames[0]->yuvRowBytes[AVIF_CHAN_Y] *
+                            expected_frames[0]->height * 3;
+  const int last = static_cast<int>(expected_frames.size()) - 1;
+
+  // From no frame to all frames fitting in the cache.
+  for (size_t frame_cache_bytes :
+       {size_t{1}, frame_size, 2 * frame_size, 100 * frame_size}) {
+    SCOPED_TRACE(frame_cache_bytes);
+    DecoderPtr decoder(avifDecoderCreate());
+    ASSERT_NE(decoder, nullptr);
+    decoder->frameCacheBytes = frame_cache_bytes;
+    ASSERT_EQ(avifDecoderSetIOFile(decoder.get(), path.c_str()),
+              AVIF_RESULT_OK);
+    ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+    // Play twice, then scrub backward and forward.
+    for (int loop = 0; loop < 2; ++loop) {
+      ASSERT_EQ(avifDecoderNthImage(decoder.get(), 0), AVIF_RESULT_OK);
+      EXPECT_TRUE(testutil::AreImagesEqual(*expected_frames[0],
+                                           *decoder->image));
+      for (int index = 1; index <= last; ++index) {
+        ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+        EXPECT_EQ(decoder->imageIndex, index);
+        EXPECT_TRUE(testutil::AreImagesEqual(*expected_frames[index],
+                                             *decoder->image));
+      }
+    }
+    for (int index : {last, 1, 0, last - 1, 2, 1, last, 0}) {
+      SCOPED_TRACE(index);
+      ASSERT_EQ(avifDecoderNthImage(decoder.get(), index), AVIF_RESULT_OK);
+      EXPECT_EQ(decoder->imageIndex, index);
+      EXPECT_TRUE(testutil::AreImagesEqual(*expected_frames[index],
+                                           *decoder->image));
+      avifImageTiming timing;
+      ASSERT_EQ(avifDecoderNthImageTiming(decoder.get(), index, &timing),
+                AVIF_RESULT_OK);
+      EXPECT_EQ(decoder->imageTiming.ptsInTimescales, timing.ptsInTimescales);
+      if (index < last) {
+        ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+        EXPECT_TRUE(testutil::AreImagesEqual(*expected_frames[index + 1],
+                                             *decoder->image));
+      }
+    }
+  }
+}
+
+// avifIO reading from memory but only up to available bytes.
+struct PartialIO {
+  avifIO io;
+  avifROData data;
+  size_t available;
+};
+
+avifResult PartialRead(avifIO* io, uint32_t read_flags, uint64_t offset,
+                       size_t size, avifROData* out) {
+  const PartialIO* partial = reinterpret_cast<const PartialIO*>(io);
+  if (read_flags != 0 || offset > partial->data.size) {
+    return AVIF_RESULT_IO_ERROR;
+  }
+  size = std::min(size, static_cast<size_t>(partial->data.size - offset));
+  if (offset + size > partial->available) {
+    return AVIF_RESULT_WAITING_ON_IO;
+  }
+  out->data = partial->data.data + offset;
+  out->size = size;
+  return AVIF_RESULT_OK;
+}
+
+TEST(AvifDecodeTest, FrameCacheRetryAfterWaitingOnIO) {
+  if (!testutil::Av1DecoderAvailable()) {
+    GTEST_SKIP() << "AV1 Codec unavailable, skip test.";
+  }
+  const char* file_name = "colors-animated-12bpc-keyframes-0-2-3.avif";
+  const std::vector<ImagePtr> expected_frames = DecodeAllFrames(file_name);
+  ASSERT_GT(expected_frames.size(), 3u);
+  const int last = static_cast<int>(expected_frames.size()) - 1;
+  const testutil::AvifRwData file =
+      testutil::ReadFile(std::string(data_path) + file_name);
+  ASSERT_NE(file.size, 0u);
+
+  PartialIO partial = {};
+  partial.io.read = PartialRead;
+  partial.io.sizeHint = file.size;
+  partial.data = {file.data, file.size};
+  partial.available = file.size;
+  DecoderPtr decoder(avifDecoderCreate());
+  ASSERT_NE(decoder, nullptr);
+  decoder->frameCacheBytes = 3 * expected_frames[0]->yuvRowBytes[AVIF_CHAN_Y] *
+                             expected_frames[0]->height * 3;
+  avifDecoderSetIO(decoder.get(), &partial.io);
+  ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+  for (int index = 0; index <= last; ++index) {
+    ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+  }
+  // Restored from the cache, the codec instances stay after the last frame.
+  ASSERT_EQ(avifDecoderNthImage(decoder.get(), last - 1), AVIF_RESULT_OK);
+
+  // Frame 1 is not cached. Only let the codec instances decode frame 0, which
+  // also gets cached without evicting the last two frames.
+  avifExtent extent;
+  ASSERT_EQ(avifDecoderNthImageMaxExtent(decoder.get(), 0, &extent),
+            AVIF_RESULT_OK);
+  partial.available = static_cast<size_t>(extent.offset + extent.size);
+  ASSERT_EQ(avifDecoderNthImageMaxExtent(decoder.get(), 1, &extent),
+            AVIF_RESULT_OK);
+  ASSERT_GT(extent.offset + extent.size, partial.available);
+  ASSERT_EQ(avifDecoderNthImage(decoder.get(), 1), AVIF_RESULT_WAITING_ON_IO);
+  // The failed seek does not move the current frame.
+  EXPECT_EQ(decoder->imageIndex, last - 1);
+  ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+  EXPECT_EQ(decoder->imageIndex, last);
+  EXPECT_TRUE(
+      testutil::AreImagesEqual(*expected_frames[last], *decoder->image));
+
+  partial.available = file.size;
+  ASSERT_EQ(avifDecoderNthImage(decoder.get(), 1), AVIF_RESULT_OK);
+  EXPECT_EQ(decoder->imageIndex, 1);
+  EXPECT_TRUE(testutil::AreImagesEqual(*expected_frames[1], *decoder->image));
+  ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+  EXPECT_TRUE(testutil::AreImagesEqual(*expected_frames[2], *decoder->image));
+}
+
+// Parses file_name with the given avifDecoder::regionOfInterest.
+avifResult ParseRegionOfInterest(avifDecoder* decoder,
+                                 const std::string& file_name,
+                                 const avifCropRect& roi) {
+  decoder->regionOfInterest = roi;
+  const std::string path = std::string(data_path) + file_name;
+  const avifResult result = avifDecoderSetIOFile(decoder, path.c_str());
+  return (result == AVIF_RESULT_OK) ? avifDecoderParse(decoder) : result;
+}
+
+TEST(AvifDecodeTest, RegionOfInterest) {
+  struct {
+    const char* file_name;
+    bool is_grid;
+  } const kFiles[] = {{"sofa_grid1x5_420.avif", true},
+                      {"sofa_grid1x5_420_reversed_dimg_order.avif", true},
+                      {"color_grid_alpha_nogrid.avif", true},
+                      {"paris_icc_exif_xmp.avif", false}};
+  for (const auto& file : kFiles) {
+    SCOPED_TRACE(file.file_name);
+    DecoderPtr decoder(avifDecoderCreate());
+    ASSERT_NE(decoder, nullptr);
+    ASSERT_EQ(ParseRegionOfInterest(decoder.get(), file.file_name, {}),
+              AVIF_RESULT_OK);
+    const uint32_t width = decoder->image->width;
+    const uint32_t height = decoder->image->height;
+    const avifPixelFormat yuv_format = decoder->image->yuvFormat;
+    const size_t color_obu_size = decoder->ioStats.colorOBUSize;
+    ImagePtr image;
+    if (testutil::Av1DecoderAvailable()) {
+      ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+      image.reset(avifImageCreateEmpty());
+      ASSERT_NE(image, nullptr);
+      ASSERT_EQ(avifImageCopy(image.get(), decoder->image, AVIF_PLANES_ALL),
+                AVIF_RESULT_OK);
+    }
+
+    // Top left quarter of the image, which overlaps only some grid cells.
+    const avifCropRect roi = {2, 2, width / 4, height / 4};
+    ASSERT_EQ(ParseRegionOfInterest(decoder.get(), file.file_name, roi),
+              AVIF_RESULT_OK);
+    EXPECT_EQ(decoder->image->width, roi.width);
+    EXPECT_EQ(decoder->image->height, roi.height);
+    if (file.is_grid) {
+      EXPECT_LT(decoder->ioStats.colorOBUSize, color_obu_size);
+    } else {
+      EXPECT_EQ(decoder->ioStats.colorOBUSize, color_obu_size);
+    }
+    if (image != nullptr) {
+      ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+      ImagePtr expected(avifImageCreateEmpty());
+      ASSERT_NE(expected, nullptr);
+      ASSERT_EQ(avifImageSetViewRect(expected.get(), image.get(), &roi),
+                AVIF_RESULT_OK);
+      EXPECT_TRUE(testutil::AreImagesEqual(*expected, *decoder->image));
+    }
+
+    // Out of the image or not aligned with the chroma subsampling.
+    EXPECT_EQ(ParseRegionOfInterest(decoder.get(), file.file_name,
+                                    {width / 2, 0, width / 2 + 2, 1}),
+              AVIF_RESULT_INVALID_ARGUMENT);
+    if (yuv_format == AVIF_PIXEL_FORMAT_YUV420) {
+      EXPECT_EQ(
+          ParseRegionOfInterest(decoder.get(), file.file_name, {1, 0, 2, 2}),
+          AVIF_RESULT_INVALID_ARGUMENT);
+    }
+  }
+}
+
+TEST(AvifDecodeTest, DecodeGridCell) {
+  for (const char* file_name :
+       {"sofa_grid1x5_420.avif", "color_grid_alpha_nogrid.avif",
+        "color_grid_gainmap_different_grid.avif"}) {
+    SCOPED_TRACE(file_name);
+    DecoderPtr decoder(avifDecoderCreate());
+    ASSERT_NE(decoder, nullptr);
+    ImagePtr cell(avifImageCreateEmpty());
+    ASSERT_NE(cell, nullptr);
+    EXPECT_EQ(avifDecoderDecodeGridCell(decoder.get(), 0, 0, cell.get()),
+              AVIF_RESULT_NO_CONTENT);
+    const std::string path = std::string(data_path) + file_name;
+    ASSERT_EQ(avifDecoderSetIOFile(decoder.get(), path.c_str()),
+              AVIF_RESULT_OK);
+    ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+    EXPECT_EQ(avifDecoderDecodeGridCell(decoder.get(), 0, 1000, cell.get()),
+              AVIF_RESULT_INVALID_ARGUMENT);
+    EXPECT_EQ(avifDecoderDecodeGridCell(decoder.get(), 1000, 0, cell.get()),
+              AVIF_RESULT_INVALID_ARGUMENT);
+    if (!testutil::Av1DecoderAvailable()) continue;
+
+    // Decoding a cell does not depend on decoder->image.
+    ASSERT_EQ(avifDecoderDecodeGridCell(decoder.get(), 0, 0, cell.get()),
+              AVIF_RESULT_OK);
+    const uint32_t cell_width = cell->width;
+    const uint32_t cell_height = cell->height;
+    ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+    const avifImage& image = *decoder->image;
+
+    // Compare each cell with the matching area of the whole image, until the
+    // first out-of-bounds row and column.
+    uint64_t covered_area = 0;
+    for (uint32_t row = 0; row * cell_height < image.height; ++row) {
+      for (uint32_t column = 0; column * cell_width < image.width; ++column) {
+        SCOPED_TRACE("cell " + std::to_string(row) + "," +
+                     std::to_string(column));
+        ASSERT_EQ(
+            avifDecoderDecodeGridCell(decoder.get(), row, column, cell.get()),
+            AVIF_RESULT_OK);
+        const avifCropRect rect = {column * cell_width, row * cell_height,
+                                   cell->width, cell->height};
+        ImagePtr expected(avifImageCreateEmpty());
+        ASSERT_NE(expected, nullptr);
+        ASSERT_EQ(avifImageSetViewRect(expected.get(), &image, &rect),
+                  AVIF_RESULT_OK);
+        EXPECT_TRUE(testutil::AreImagesEqual(*expected, *cell));
+        covered_area += uint64_t{cell->width} * cell->height;
+      }
+    }
+    EXPECT_EQ(covered_area, uint64_t{image.width} * image.height);
+  }
+
+  DecoderPtr decoder(avifDecoderCreate());
+  ASSERT_NE(decoder, nullptr);
+  const std::string path = std::string(data_path) + "paris_icc_exif_xmp.avif";
+  ASSERT_EQ(avifDecoderSetIOFile(decoder.get(), path.c_str()), AVIF_RESULT_OK);
+  ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+  ImagePtr cell(avifImageCreateEmpty());
+  ASSERT_NE(cell, nullptr);
+  EXPECT_EQ(avifDecoderDecodeGridCell(decoder.get(), 0, 0, cell.get()),
+            AVIF_RESULT_INVALID_ARGUMENT);
+}
+
+TEST(AvifDecodeTest, NoThumbnail) {
+  DecoderPtr decoder(avifDecoderCreate());
+  ASSERT_NE(decoder, nullptr);
+  const std::string path = std::string(data_path) + "paris_icc_exif_xmp.avif";
+  ASSERT_EQ(avifDecoderSetIOFile(decoder.get(), path.c_str()), AVIF_RESULT_OK);
+  ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+  EXPECT_FALSE(decoder->thumbnailPresent);
+  const uint32_t width = decoder->image->width;
+  EXPECT_EQ(
+      avifDecoderSetSource(decoder.get(), AVIF_DECODER_SOURCE_THUMBNAIL_ITEM),
+      AVIF_RESULT_MISSING_IMAGE_ITEM);
+  ASSERT_EQ(
+      avifDecoderSetSource(decoder.get(), AVIF_DECODER_SOURCE_PRIMARY_ITEM),
+      AVIF_RESULT_OK);
+  EXPECT_EQ(decoder->image->width, width);
+}
+
+TEST(AvifDecodeTest, Thumbnail) {
+  DecoderPtr decoder(avifDecoderCreate());
+  ASSERT_NE(decoder, nullptr);
+  const std::string path =
+      std::string(data_path) + "color_grid_alpha_nogrid_thumbnail.avif";
+  ASSERT_EQ(avifDecoderSetIOFile(decoder.get(), path.c_str()), AVIF_RESULT_OK);
+  ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+  EXPECT_TRUE(decoder->thumbnailPresent);
+  EXPECT_TRUE(decoder->alphaPresent);
+  EXPECT_EQ(decoder->image->width, 80u);
+  EXPECT_EQ(decoder->image->height, 80u);
+
+  // The thumbnail item is a single tile with its own alpha auxiliary item.
+  ASSERT_EQ(
+      avifDecoderSetSource(decoder.get(), AVIF_DECODER_SOURCE_THUMBNAIL_ITEM),
+      AVIF_RESULT_OK);
+  EXPECT_TRUE(decoder->alphaPresent);
+  EXPECT_EQ(decoder->imageCount, 1);
+  EXPECT_EQ(decoder->image->width, 80u);
+  EXPECT_EQ(decoder->image->height, 64u);
+  if (testutil::Av1DecoderAvailable()) {
+    ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+    EXPECT_EQ(decoder->image->width, 80u);
+    EXPECT_EQ(decoder->image->height, 64u);
+    EXPECT_NE(decoder->image->alphaPlane, nullptr);
+  }
+
+  ASSERT_EQ(
+      avifDecoderSetSource(decoder.get(), AVIF_DECODER_SOURCE_PRIMARY_ITEM),
+      AVIF_RESULT_OK);
+  EXPECT_TRUE(decoder->alphaPresent);
+  EXPECT_EQ(decoder->image->width, 80u);
+  EXPECT_EQ(decoder->image->height, 80u);
+}
+
 TEST(AvifDecodeTest, ParseEmptyData) {
   DecoderPtr decoder(avifDecoderCreate());
   ASSERT_NE(decoder, nullptr);
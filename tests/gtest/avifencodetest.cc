@@ -31,6 +31,219 @@ TEST(BasicTest, Encode) {
 
 //------------------------------------------------------------------------------
 
+// Returns the size of the image encoded with the given settings, or 0 on error.
+size_t EncodedSize(const avifImage* image, int quality, size_t target_size,
+                   int max_threads, int* selected_quality = nullptr) {
+  EncoderPtr encoder(avifEncoderCreate());
+  if (encoder == nullptr) return 0;
+  encoder->speed = AVIF_SPEED_FASTEST;
+  encoder->quality = quality;
+  encoder->qualityAlpha = quality;
+  encoder->targetSizeBytes = target_size;
+  encoder->maxThreads = max_threads;
+  testutil::AvifRwData encoded;
+  if (avifEncoderWrite(encoder.get(), image, &encoded) != AVIF_RESULT_OK) {
+    return 0;
+  }
+  if (testutil::Decode(encoded.data, encoded.size) == nullptr) return 0;
+  if (selected_quality != nullptr) *selected_quality = encoder->quality;
+  return encoded.size;
+}
+
+TEST(TargetSizeTest, ClosestToTarget) {
+  ImagePtr image = testutil::ReadImage(data_path, "paris_exif_xmp_icc.jpg");
+  ASSERT_NE(image, nullptr);
+  const size_t low = EncodedSize(image.get(), /*quality=*/30, 0, 1);
+  const size_t high = EncodedSize(image.get(), /*quality=*/70, 0, 1);
+  ASSERT_GT(low, 0u);
+  ASSERT_GT(high, low);
+  const size_t target = (low + high) / 2;
+
+  // A single trial at a time (binary search) or several trials in parallel.
+  for (int max_threads : {1, 3, 16}) {
+    SCOPED_TRACE(max_threads);
+    int quality = -1;
+    const size_t size = EncodedSize(image.get(), AVIF_QUALITY_DEFAULT, target,
+                                    max_threads, &quality);
+    ASSERT_GT(size, 0u);
+    EXPECT_GE(quality, 30);
+    EXPECT_LE(quality, 70);
+    // The kept trial cannot be further from the target than the bounds above.
+    EXPECT_LE(size > target ? size - target : target - size, (high - low) / 2);
+  }
+}
+
+TEST(TargetSizeTest, OnlyForStillImages) {
+  ImagePtr image = testutil::CreateImage(16, 16, /*depth=*/8,
+                                         AVIF_PIXEL_FORMAT_YUV420,
+                                         AVIF_PLANES_YUV);
+  ASSERT_NE(image, nullptr);
+  testutil::FillImageGradient(image.get());
+  EncoderPtr encoder(avifEncoderCreate());
+  ASSERT_NE(encoder, nullptr);
+  encoder->targetSizeBytes = 1000;
+  EXPECT_EQ(avifEncoderAddImage(encoder.get(), image.get(),
+                                /*durationInTimescales=*/1,
+                                AVIF_ADD_IMAGE_FLAG_NONE),
+            AVIF_RESULT_NOT_IMPLEMENTED);
+}
+
+//------------------------------------------------------------------------------
+
+// Encodes image losslessly with encoder and checks that it decodes to image.
+void EncodeLosslesslyAndCheck(avifEncoder* encoder, const avifImage& image) {
+  ASSERT_EQ(avifEncoderAddImage(encoder, &image, /*durationInTimescales=*/1,
+                                AVIF_ADD_IMAGE_FLAG_SINGLE),
+            AVIF_RESULT_OK);
+  testutil::AvifRwData encoded;
+  ASSERT_EQ(avifEncoderFinish(encoder, &encoded), AVIF_RESULT_OK);
+  ImagePtr decoded = testutil::Decode(encoded.data, encoded.size);
+  ASSERT_NE(decoded, nullptr);
+  EXPECT_TRUE(testutil::AreImagesEqual(image, *decoded));
+}
+
+TEST(EncoderResetTest, EncodeSeveralFiles) {
+  ImagePtr gradient = testutil::CreateImage(
+      /*width=*/64, /*height=*/48, /*depth=*/8, AVIF_PIXEL_FORMAT_YUV444,
+      AVIF_PLANES_ALL, AVIF_RANGE_FULL);
+  ASSERT_NE(gradient, nullptr);
+  testutil::FillImageGradient(gradient.get());
+  // Same properties as gradient, so the codec instances are reused.
+  ImagePtr plain = testutil::CreateImage(
+      /*width=*/64, /*height=*/48, /*depth=*/8, AVIF_PIXEL_FORMAT_YUV444,
+      AVIF_PLANES_ALL, AVIF_RANGE_FULL);
+  ASSERT_NE(plain, nullptr);
+  const uint32_t yuva[] = {10, 200, 30, 128};
+  testutil::FillImagePlain(plain.get(), yuva);
+  // Different dimensions, so new codec instances are created.
+  ImagePtr smaller = testutil::CreateImage(
+      /*width=*/32, /*height=*/16, /*depth=*/8, AVIF_PIXEL_FORMAT_YUV444,
+      AVIF_PLANES_ALL, AVIF_RANGE_FULL);
+  ASSERT_NE(smaller, nullptr);
+  testutil::FillImageGradient(smaller.get());
+
+  EncoderPtr encoder(avifEncoderCreate());
+  ASSERT_NE(encoder, nullptr);
+  encoder->speed = AVIF_SPEED_FASTEST;
+  encoder->quality = AVIF_QUALITY_LOSSLESS;
+  encoder->qualityAlpha = AVIF_QUALITY_LOSSLESS;
+  for (const avifImage* image :
+       {gradient.get(), plain.get(), gradient.get(), smaller.get()}) {
+    EncodeLosslesslyAndCheck(encoder.get(), *image);
+    ASSERT_EQ(avifEncoderReset(encoder.get()), AVIF_RESULT_OK);
+  }
+
+  // Settings that cannot change within an encode can change after a reset.
+  encoder->speed = AVIF_SPEED_SLOWEST;
+  EncodeLosslesslyAndCheck(encoder.get(), *smaller);
+}
+
+TEST(EncoderResetTest, AbandonedEncode) {
+  ImagePtr image = testutil::CreateImage(
+      /*width=*/16, /*height=*/16, /*depth=*/8, AVIF_PIXEL_FORMAT_YUV444,
+      AVIF_PLANES_YUV, AVIF_RANGE_FULL);
+  ASSERT_NE(image, nullptr);
+  testutil::FillImageGradient(image.get());
+
+  EncoderPtr encoder(avifEncoderCreate());
+  ASSERT_NE(encoder, nullptr);
+  encoder->speed = AVIF_SPEED_FASTEST;
+  encoder->quality = AVIF_QUALITY_LOSSLESS;
+  ASSERT_EQ(avifEncoderAddImage(encoder.get(), image.get(),
+                                /*durationInTimescales=*/1,
+                                AVIF_ADD_IMAGE_FLAG_NONE),
+            AVIF_RESULT_OK);
+  ASSERT_EQ(avifEncoderReset(encoder.get()), AVIF_RESULT_OK);
+  EncodeLosslesslyAndCheck(encoder.get(), *image);
+}
+
+//------------------------------------------------------------------------------
+
+// Parses encoded and checks the dimensions of its thumbnail item, if any.
+void CheckThumbnail(const testutil::AvifRwData& encoded, uint32_t width,
+                    uint32_t height, bool alpha) {
+  DecoderPtr decoder(avifDecoderCreate());
+  ASSERT_NE(decoder, nullptr);
+  ASSERT_EQ(avifDecoderSetIOMemory(decoder.get(), encoded.data, encoded.size),
+            AVIF_RESULT_OK);
+  ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+  ASSERT_EQ(decoder->thumbnailPresent, width != 0);
+  if (width == 0) return;
+  ASSERT_EQ(
+      avifDecoderSetSource(decoder.get(), AVIF_DECODER_SOURCE_THUMBNAIL_ITEM),
+      AVIF_RESULT_OK);
+  EXPECT_EQ(decoder->alphaPresent, alpha);
+  ASSERT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+  EXPECT_EQ(decoder->image->width, width);
+  EXPECT_EQ(decoder->image->height, height);
+  EXPECT_EQ(decoder->image->alphaPlane != nullptr, alpha);
+}
+
+TEST(ThumbnailTest, SingleImageAndGrid) {
+  if (avifLibYUVVersion() == 0) {
+    GTEST_SKIP() << "libyuv not available, skip test.";
+  }
+  ImagePtr image = testutil::CreateImage(
+      /*width=*/256, /*height=*/128, /*depth=*/8, AVIF_PIXEL_FORMAT_YUV420,
+      AVIF_PLANES_ALL, AVIF_RANGE_FULL);
+  ASSERT_NE(image, nullptr);
+  testutil::FillImageGradient(image.get());
+
+  EncoderPtr encoder(avifEncoderCreate());
+  ASSERT_NE(encoder, nullptr);
+  encoder->speed = AVIF_SPEED_FASTEST;
+  encoder->thumbnailSize = 64;
+  testutil::AvifRwData encoded;
+  ASSERT_EQ(avifEncoderWrite(encoder.get(), image.get(), &encoded),
+            AVIF_RESULT_OK);
+  CheckThumbnail(encoded, 64, 32, /*alpha=*/true);
+
+  // The thumbnail of a grid is made of all its cells.
+  ImagePtr cells[2] = {
+      testutil::CreateImage(/*width=*/128, /*height=*/128, /*depth=*/8,
+                            AVIF_PIXEL_FORMAT_YUV420, AVIF_PLANES_YUV),
+      testutil::CreateImage(/*width=*/100, /*height=*/128, /*depth=*/8,
+                            AVIF_PIXEL_FORMAT_YUV420, AVIF_PLANES_YUV)};
+  ASSERT_NE(cells[0], nullptr);
+  ASSERT_NE(cells[1], nullptr);
+  testutil::FillImageGradient(cells[0].get());
+  testutil::FillImageGradient(cells[1].get());
+  const avifImage* cell_images[] = {cells[0].get(), cells[1].get()};
+  ASSERT_EQ(avifEncoderReset(encoder.get()), AVIF_RESULT_OK);
+  ASSERT_EQ(avifEncoderAddImageGrid(encoder.get(), /*gridCols=*/2,
+                                    /*gridRows=*/1, cell_images,
+                                    AVIF_ADD_IMAGE_FLAG_SINGLE),
+            AVIF_RESULT_OK);
+  testutil::AvifRwData encoded_grid;
+  ASSERT_EQ(avifEncoderFinish(encoder.get(), &encoded_grid), AVIF_RESULT_OK);
+  CheckThumbnail(encoded_grid, 64, 36, /*alpha=*/false);
+
+  // No thumbnail for an image that is not larger than thumbnailSize.
+  encoder->thumbnailSize = 256;
+  testutil::AvifRwData encoded_small;
+  ASSERT_EQ(avifEncoderReset(encoder.get()), AVIF_RESULT_OK);
+  ASSERT_EQ(avifEncoderWrite(encoder.get(), image.get(), &encoded_small),
+            AVIF_RESULT_OK);
+  CheckThumbnail(encoded_small, 0, 0, /*alpha=*/false);
+}
+
+TEST(ThumbnailTest, OnlyForStillImages) {
+  ImagePtr image = testutil::CreateImage(16, 16, /*depth=*/8,
+                                         AVIF_PIXEL_FORMAT_YUV420,
+                                         AVIF_PLANES_YUV);
+  ASSERT_NE(image, nullptr);
+  testutil::FillImageGradient(image.get());
+  EncoderPtr encoder(avifEncoderCreate());
+  ASSERT_NE(encoder, nullptr);
+  encoder->thumbnailSize = 8;
+  EXPECT_EQ(avifEncoderAddImage(encoder.get(), image.get(),
+                                /*durationInTimescales=*/1,
+                                AVIF_ADD_IMAGE_FLAG_NONE),
+            AVIF_RESULT_NOT_IMPLEMENTED);
+}
+
+//------------------------------------------------------------------------------
+
 }  // namespace
 }  // namespace avif
 
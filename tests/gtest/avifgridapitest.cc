@@ -1,6 +1,7 @@
 // Copyright 2022 Google LLC
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <utility>
 #include <vector>
 
 #include "avif/avif.h"
@@ -219,6 +220,91 @@ TEST(GridApiTest, CellsOfDifferentDimensions) {
             AVIF_RESULT_INVALID_IMAGE_GRID);
 }
 
+// Identical cells are encoded to identical payloads, which must only be stored
+// once in the file.
+TEST(GridApiTest, IdenticalCellsAreDeduplicated) {
+  ImagePtr cell = testutil::CreateImage(64, 64, /*depth=*/8,
+                                        AVIF_PIXEL_FORMAT_YUV420,
+                                        AVIF_PLANES_ALL);
+  ASSERT_NE(cell, nullptr);
+  testutil::FillImageGradient(cell.get());
+
+  avifIOStats io_stats[2];
+  for (uint32_t grid_size : {1, 8}) {
+    EncoderPtr encoder(avifEncoderCreate());
+    ASSERT_NE(encoder, nullptr);
+    encoder->speed = AVIF_SPEED_FASTEST;
+    const std::vector<const avifImage*> cell_image_ptrs(grid_size * grid_size,
+                                                        cell.get());
+    ASSERT_EQ(avifEncoderAddImageGrid(encoder.get(), grid_size, grid_size,
+                                      cell_image_ptrs.data(),
+                                      AVIF_ADD_IMAGE_FLAG_SINGLE),
+              AVIF_RESULT_OK);
+    testutil::AvifRwData encoded_avif;
+    ASSERT_EQ(avifEncoderFinish(encoder.get(), &encoded_avif), AVIF_RESULT_OK);
+    io_stats[grid_size == 1 ? 0 : 1] = encoder->ioStats;
+
+    ImagePtr decoded = testutil::Decode(encoded_avif.data, encoded_avif.size);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(decoded->width, 64 * grid_size);
+    EXPECT_EQ(decoded->height, 64 * grid_size);
+  }
+  // The ioStats only account for the payloads written to the file.
+  EXPECT_EQ(io_stats[1].colorOBUSize, io_stats[0].colorOBUSize);
+  EXPECT_EQ(io_stats[1].alphaOBUSize, io_stats[0].alphaOBUSize);
+}
+
+// The cells and the alpha plane are encoded concurrently when maxThreads > 1.
+// Lossless encoding makes the decoded pixels independent of the threading.
+TEST(GridApiTest, CellsEncodedInParallel) {
+  std::vector<ImagePtr> cells;
+  std::vector<const avifImage*> cell_image_ptrs;
+  for (int i = 0; i < 6; ++i) {
+    // Only the bottom row of cells may be smaller.
+    const int height = i < 3 ? 32 : 24;
+    cells.push_back(testutil::CreateImage(/*width=*/64, height, /*depth=*/8,
+                                          AVIF_PIXEL_FORMAT_YUV444,
+                                          AVIF_PLANES_ALL));
+    ASSERT_NE(cells.back(), nullptr);
+    testutil::FillImageGradient(cells.back().get());
+    cell_image_ptrs.push_back(cells.back().get());
+  }
+
+  ThreadPoolPtr pool(avifThreadPoolCreate(2));
+  ASSERT_NE(pool, nullptr);
+  ImagePtr reference;
+  for (int max_threads : {1, 3, 16}) {
+    for (bool use_pool : {false, true}) {
+      SCOPED_TRACE(testing::Message() << "max_threads " << max_threads
+                                      << " use_pool " << use_pool);
+      EncoderPtr encoder(avifEncoderCreate());
+      ASSERT_NE(encoder, nullptr);
+      encoder->speed = AVIF_SPEED_FASTEST;
+      encoder->quality = AVIF_QUALITY_LOSSLESS;
+      encoder->qualityAlpha = AVIF_QUALITY_LOSSLESS;
+      encoder->maxThreads = max_threads;
+      encoder->threadPool = use_pool ? pool.get() : nullptr;
+      ASSERT_EQ(avifEncoderAddImageGrid(encoder.get(), /*gridCols=*/3,
+                                        /*gridRows=*/2, cell_image_ptrs.data(),
+                                        AVIF_ADD_IMAGE_FLAG_SINGLE),
+                AVIF_RESULT_OK);
+      testutil::AvifRwData encoded_avif;
+      ASSERT_EQ(avifEncoderFinish(encoder.get(), &encoded_avif),
+                AVIF_RESULT_OK);
+
+      ImagePtr decoded = testutil::Decode(encoded_avif.data, encoded_avif.size);
+      ASSERT_NE(decoded, nullptr);
+      EXPECT_EQ(decoded->width, 3 * 64u);
+      EXPECT_EQ(decoded->height, 32u + 24u);
+      if (!reference) {
+        reference = std::move(decoded);
+      } else {
+        EXPECT_TRUE(testutil::AreImagesEqual(*reference, *decoded));
+      }
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 
 TEST(GridApiTest, SameMatrixCoefficients) {
@@ -0,0 +1,292 @@
+// Copyright 2024 Google LLC
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "avif/avif.h"
+#include "aviftest_helpers.h"
+#include "gtest/gtest.h"
+
+#if defined(_WIN32)
+#define AVIF_TEST_FILENO _fileno
+#else
+#define AVIF_TEST_FILENO fileno
+#endif
+
+namespace avif {
+namespace {
+
+// Used to pass the data folder path to the GoogleTest suites.
+const char* data_path = nullptr;
+
+//------------------------------------------------------------------------------
+
+TEST(MappedFileReaderTest, SameAsFileReader) {
+  const std::string path = std::string(data_path) + "white_1x1.avif";
+  IOPtr file_reader(avifIOCreateFileReader(path.c_str()));
+  ASSERT_NE(file_reader, nullptr);
+  IOPtr mapped_reader(avifIOCreateMappedFileReader(path.c_str()));
+  ASSERT_NE(mapped_reader, nullptr);
+  EXPECT_TRUE(mapped_reader->persistent);
+  ASSERT_EQ(mapped_reader->sizeHint, file_reader->sizeHint);
+  const uint64_t file_size = file_reader->sizeHint;
+
+  // Includes a range truncated at EOF and an empty range at EOF.
+  const uint64_t kRanges[][2] = {{0, 8},
+                                 {3, 17},
+                                 {0, file_size},
+                                 {file_size - 5, 100},
+                                 {file_size, 10}};
+  std::vector<avifROData> persistent_reads;
+  for (const auto& range : kRanges) {
+    SCOPED_TRACE(range[0]);
+    avifROData expected, actual;
+    ASSERT_EQ(file_reader->read(file_reader.get(), 0, range[0],
+                                static_cast<size_t>(range[1]), &expected),
+              AVIF_RESULT_OK);
+    ASSERT_EQ(mapped_reader->read(mapped_reader.get(), 0, range[0],
+                                  static_cast<size_t>(range[1]), &actual),
+              AVIF_RESULT_OK);
+    EXPECT_TRUE(testutil::AreByteSequencesEqual(expected.data, expected.size,
+                                                actual.data, actual.size));
+    persistent_reads.push_back(actual);
+  }
+
+  // The regions returned by a persistent avifIO stay valid after other reads.
+  const testutil::AvifRwData file = testutil::ReadFile(path);
+  for (size_t i = 0; i < persistent_reads.size(); ++i) {
+    EXPECT_TRUE(testutil::AreByteSequencesEqual(
+        persistent_reads[i].data, persistent_reads[i].size,
+        file.data + kRanges[i][0], persistent_reads[i].size));
+  }
+
+  avifROData out;
+  EXPECT_EQ(mapped_reader->read(mapped_reader.get(), 0, file_size + 1, 1, &out),
+            AVIF_RESULT_IO_ERROR);
+}
+
+TEST(MappedFileReaderTest, Decode) {
+  DecoderPtr decoder(avifDecoderCreate());
+  ASSERT_NE(decoder, nullptr);
+  avifIO* io = avifIOCreateMappedFileReader(
+      (std::string(data_path) + "white_1x1.avif").c_str());
+  ASSERT_NE(io, nullptr);
+  avifDecoderSetIO(decoder.get(), io);
+  ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+  EXPECT_EQ(decoder->image->width, 1u);
+  EXPECT_EQ(decoder->image->height, 1u);
+  if (testutil::Av1DecoderAvailable()) {
+    EXPECT_EQ(avifDecoderNextImage(decoder.get()), AVIF_RESULT_OK);
+  }
+}
+
+TEST(MappedFileReaderTest, EmptyFile) {
+  const std::string path = testing::TempDir() + "avifiotest_empty.avif";
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(f, nullptr);
+  std::fclose(f);
+
+  // An empty file cannot be mapped but can still be read.
+  IOPtr reader(avifIOCreateMappedFileReader(path.c_str()));
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->sizeHint, 0u);
+  avifROData out;
+  ASSERT_EQ(reader->read(reader.get(), 0, 0, 10, &out), AVIF_RESULT_OK);
+  EXPECT_EQ(out.size, 0u);
+  reader.reset();
+  std::remove(path.c_str());
+}
+
+TEST(MappedFileReaderTest, MissingFile) {
+  EXPECT_EQ(avifIOCreateMappedFileReader(
+                (std::string(data_path) + "does_not_exist.avif").c_str()),
+            nullptr);
+}
+
+//------------------------------------------------------------------------------
+
+TEST(FileDescriptorReaderTest, ConcurrentReads) {
+  const std::string path = std::string(data_path) + "white_1x1.avif";
+  const testutil::AvifRwData file = testutil::ReadFile(path);
+  ASSERT_GT(file.size, 0u);
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  ASSERT_NE(f, nullptr);
+  const int fd = AVIF_TEST_FILENO(f);
+
+  // One reader per thread, all sharing the same file descriptor.
+  constexpr int kNumThreads = 4;
+  std::vector<IOPtr> readers;
+  for (int i = 0; i < kNumThreads; ++i) {
+    readers.emplace_back(avifIOCreateFileDescriptorReader(fd));
+    ASSERT_NE(readers.back(), nullptr);
+    EXPECT_FALSE(readers.back()->persistent);
+    EXPECT_EQ(readers.back()->sizeHint, file.size);
+  }
+
+  std::vector<int> num_mismatches(kNumThreads, 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      avifIO* io = readers[i].get();
+      for (int iteration = 0; iteration < 1000; ++iteration) {
+        const size_t offset = (iteration * 7 + i * 13) % file.size;
+        const size_t size = 1 + (iteration + i) % 64;
+        avifROData out;
+        if (io->read(io, 0, offset, size, &out) != AVIF_RESULT_OK ||
+            out.size != std::min(size, file.size - offset) ||
+            !testutil::AreByteSequencesEqual(out.data, out.size,
+                                             file.data + offset, out.size)) {
+          ++num_mismatches[i];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_EQ(num_mismatches[i], 0) << "thread " << i;
+  }
+
+  // The file descriptor is not owned by the readers.
+  readers.clear();
+  EXPECT_EQ(std::fclose(f), 0);
+}
+
+TEST(FileDescriptorReaderTest, Decode) {
+  const std::string path = std::string(data_path) + "white_1x1.avif";
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  ASSERT_NE(f, nullptr);
+  for (int i = 0; i < 2; ++i) {
+    DecoderPtr decoder(avifDecoderCreate());
+    ASSERT_NE(decoder, nullptr);
+    avifIO* io = avifIOCreateFileDescriptorReader(AVIF_TEST_FILENO(f));
+    ASSERT_NE(io, nullptr);
+    avifDecoderSetIO(decoder.get(), io);
+    ASSERT_EQ(avifDecoderParse(decoder.get()), AVIF_RESULT_OK);
+    EXPECT_EQ(decoder->image->width, 1u);
+  }
+  std::fclose(f);
+}
+
+TEST(FileDescriptorReaderTest, InvalidDescriptor) {
+  EXPECT_EQ(avifIOCreateFileDescriptorReader(-1), nullptr);
+}
+
+//------------------------------------------------------------------------------
+
+// Writes "abcdef" in pieces, including an overwrite of already written bytes.
+void WriteSequence(avifIO* io) {
+  const uint8_t abc[] = {'a', 'b', 'c'};
+  const uint8_t xyz[] = {'x', 'y', 'z'};
+  const uint8_t def[] = {'d', 'e', 'f'};
+  ASSERT_EQ(io->write(io, 0, 0, abc, sizeof(abc)), AVIF_RESULT_OK);
+  ASSERT_EQ(io->write(io, 0, 3, xyz, sizeof(xyz)), AVIF_RESULT_OK);
+  // Seek back and overwrite.
+  ASSERT_EQ(io->write(io, 0, 3, def, sizeof(def)), AVIF_RESULT_OK);
+  // Empty writes are allowed.
+  ASSERT_EQ(io->write(io, 0, 6, nullptr, 0), AVIF_RESULT_OK);
+  // Unsupported flags.
+  ASSERT_EQ(io->write(io, 1, 0, abc, sizeof(abc)), AVIF_RESULT_IO_ERROR);
+}
+
+TEST(MemoryWriterTest, Write) {
+  testutil::AvifRwData output;
+  IOPtr writer(avifIOCreateMemoryWriter(&output));
+  ASSERT_NE(writer, nullptr);
+  EXPECT_EQ(writer->read, nullptr);
+  ASSERT_NO_FATAL_FAILURE(WriteSequence(writer.get()));
+  ASSERT_EQ(output.size, 6u);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(output.data), 6),
+            "abcdef");
+
+  // Writing past the end zero-fills the gap.
+  const uint8_t g = 'g';
+  ASSERT_EQ(writer->write(writer.get(), 0, 4000, &g, 1), AVIF_RESULT_OK);
+  ASSERT_EQ(output.size, 4001u);
+  EXPECT_EQ(output.data[5], 'f');
+  EXPECT_EQ(output.data[6], 0);
+  EXPECT_EQ(output.data[3999], 0);
+  EXPECT_EQ(output.data[4000], 'g');
+}
+
+TEST(FileWriterTest, Write) {
+  const std::string path = testing::TempDir() + "avifiotest_writer.bin";
+  IOPtr writer(avifIOCreateFileWriter(path.c_str()));
+  ASSERT_NE(writer, nullptr);
+  EXPECT_EQ(writer->read, nullptr);
+  ASSERT_NO_FATAL_FAILURE(WriteSequence(writer.get()));
+  writer.reset();
+
+  const testutil::AvifRwData file = testutil::ReadFile(path);
+  ASSERT_EQ(file.size, 6u);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(file.data), 6),
+            "abcdef");
+  std::remove(path.c_str());
+}
+
+TEST(FileWriterTest, MissingDirectory) {
+  EXPECT_EQ(avifIOCreateFileWriter(
+                (testing::TempDir() + "does_not_exist/out.avif").c_str()),
+            nullptr);
+}
+
+TEST(EncoderFinishToIOTest, SameAsEncoderFinish) {
+  if (!testutil::Av1EncoderAvailable()) {
+    GTEST_SKIP() << "AV1 encoder unavailable, skip test.";
+  }
+  ImagePtr image = testutil::CreateImage(/*width=*/64, /*height=*/48,
+                                         /*depth=*/8, AVIF_PIXEL_FORMAT_YUV444,
+                                         AVIF_PLANES_ALL);
+  ASSERT_NE(image, nullptr);
+  testutil::FillImageGradient(image.get());
+
+  testutil::AvifRwData expected;
+  testutil::AvifRwData actual;
+  for (bool to_io : {false, true}) {
+    EncoderPtr encoder(avifEncoderCreate());
+    ASSERT_NE(encoder, nullptr);
+    encoder->speed = AVIF_SPEED_FASTEST;
+    ASSERT_EQ(avifEncoderAddImage(encoder.get(), image.get(),
+                                  /*durationInTimescales=*/1,
+                                  AVIF_ADD_IMAGE_FLAG_SINGLE),
+              AVIF_RESULT_OK);
+    if (to_io) {
+      IOPtr writer(avifIOCreateMemoryWriter(&actual));
+      ASSERT_NE(writer, nullptr);
+      ASSERT_EQ(avifEncoderFinishToIO(encoder.get(), writer.get()),
+                AVIF_RESULT_OK);
+    } else {
+      ASSERT_EQ(avifEncoderFinish(encoder.get(), &expected), AVIF_RESULT_OK);
+    }
+  }
+  EXPECT_TRUE(testutil::AreByteSequencesEqual(expected, actual));
+
+  EncoderPtr encoder(avifEncoderCreate());
+  ASSERT_NE(encoder, nullptr);
+  avifIO no_write = {};
+  EXPECT_EQ(avifEncoderFinishToIO(encoder.get(), &no_write),
+            AVIF_RESULT_INVALID_ARGUMENT);
+  EXPECT_EQ(avifEncoderFinishToIO(encoder.get(), nullptr),
+            AVIF_RESULT_INVALID_ARGUMENT);
+}
+
+//------------------------------------------------------------------------------
+
+}  // namespace
+}  // namespace avif
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  if (argc != 2) {
+    std::cerr << "There must be exactly one argument containing the path to "
+                 "the test data folder"
+              << std::endl;
+    return 1;
+  }
+  avif::data_path = argv[1];
+  return RUN_ALL_TESTS();
+}
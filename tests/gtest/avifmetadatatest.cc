@@ -6,6 +6,7 @@
 #include <iostream>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include "avif/avif.h"
 #include "avif/avif_cxx.h"
@@ -421,6 +422,54 @@ TEST(MetadataTest, XMPWithTrailingNullCharacter) {
 
 //------------------------------------------------------------------------------
 
+// Returns the size of the file encoded with testutil::kSampleExif and xmp.
+size_t EncodedSizeWithXmp(const std::vector<uint8_t>& xmp) {
+  ImagePtr image = testutil::CreateImage(/*width=*/12, /*height=*/34,
+                                         /*depth=*/8, AVIF_PIXEL_FORMAT_YUV444,
+                                         AVIF_PLANES_YUV);
+  if (image == nullptr) return 0;
+  testutil::FillImageGradient(image.get());
+  if (avifImageSetMetadataExif(image.get(), testutil::kSampleExif.data(),
+                               testutil::kSampleExif.size()) !=
+          AVIF_RESULT_OK ||
+      avifImageSetMetadataXMP(image.get(), xmp.data(), xmp.size()) !=
+          AVIF_RESULT_OK) {
+    return 0;
+  }
+  return testutil::Encode(image.get(), AVIF_SPEED_FASTEST).size;
+}
+
+// Only whole item payloads are deduplicated in the mdat box.
+TEST(MetadataTest, DeduplicatedPayloads) {
+  const std::vector<uint8_t> exif(testutil::kSampleExif.begin(),
+                                  testutil::kSampleExif.end());
+  size_t exif_tiff_header_offset;
+  ASSERT_EQ(avifGetExifTiffHeaderOffset(exif.data(), exif.size(),
+                                        &exif_tiff_header_offset),
+            AVIF_RESULT_OK);
+  // The Exif item payload is the offset to the TIFF header followed by exif.
+  std::vector<uint8_t> exif_payload = {
+      0, 0, static_cast<uint8_t>(exif_tiff_header_offset >> 8),
+      static_cast<uint8_t>(exif_tiff_header_offset)};
+  exif_payload.insert(exif_payload.end(), exif.begin(), exif.end());
+  ASSERT_LT(exif_tiff_header_offset, 256u * 256u);
+
+  // An XMP payload identical to the Exif payload is not written twice.
+  const size_t other_payload_size =
+      EncodedSizeWithXmp(std::vector<uint8_t>(exif_payload.size(), 'x'));
+  ASSERT_GT(other_payload_size, exif_payload.size());
+  EXPECT_EQ(EncodedSizeWithXmp(exif_payload),
+            other_payload_size - exif_payload.size());
+
+  // An XMP payload that is only a part of the Exif payload is written again.
+  const size_t other_part_size =
+      EncodedSizeWithXmp(std::vector<uint8_t>(exif.size(), 'x'));
+  ASSERT_GT(other_part_size, 0u);
+  EXPECT_EQ(EncodedSizeWithXmp(exif), other_part_size);
+}
+
+//------------------------------------------------------------------------------
+
 }  // namespace
 }  // namespace avif
 
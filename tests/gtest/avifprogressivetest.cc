@@ -1,6 +1,8 @@
 // Copyright 2022 Yuan Tong. All rights reserved.
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <algorithm>
+
 #include "avif/avif.h"
 #include "aviftest_helpers.h"
 #include "gtest/gtest.h"
@@ -89,6 +91,31 @@ TEST_F(ProgressiveTest, QualityChange) {
   TestDecode(kImageSize, kImageSize);
 }
 
+// avifEncoderFinish() can be called again and writes the same file.
+TEST_F(ProgressiveTest, FinishTwice) {
+  encoder_->extraLayerCount = 1;
+  encoder_->minQuantizer = 50;
+  encoder_->maxQuantizer = 50;
+  ASSERT_EQ(avifEncoderAddImage(encoder_.get(), image_.get(), 1,
+                                AVIF_ADD_IMAGE_FLAG_NONE),
+            AVIF_RESULT_OK);
+  encoder_->minQuantizer = 0;
+  encoder_->maxQuantizer = 0;
+  ASSERT_EQ(avifEncoderAddImage(encoder_.get(), image_.get(), 1,
+                                AVIF_ADD_IMAGE_FLAG_NONE),
+            AVIF_RESULT_OK);
+
+  ASSERT_EQ(avifEncoderFinish(encoder_.get(), &encoded_avif_), AVIF_RESULT_OK);
+  testutil::AvifRwData encoded_again;
+  ASSERT_EQ(avifEncoderFinish(encoder_.get(), &encoded_again), AVIF_RESULT_OK);
+  ASSERT_EQ(encoded_again.size, encoded_avif_.size);
+  EXPECT_TRUE(std::equal(encoded_avif_.data,
+                         encoded_avif_.data + encoded_avif_.size,
+                         encoded_again.data));
+
+  TestDecode(encoded_again.data, encoded_again.size, kImageSize, kImageSize);
+}
+
 // NOTE: This test requires libaom v3.6.0 or later, otherwise the following
 // assertion in libaom fails:
 //   av1/encoder/mcomp.c:1717: av1_full_pixel_search: Assertion
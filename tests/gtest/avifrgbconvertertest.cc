@@ -0,0 +1,124 @@
+// Copyright 2024 Google LLC
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <memory>
+#include <tuple>
+
+#include "avif/avif.h"
+#include "aviftest_helpers.h"
+#include "gtest/gtest.h"
+
+using ::testing::Bool;
+using ::testing::Combine;
+using ::testing::Values;
+
+namespace avif {
+namespace {
+
+struct RGBConverterDeleter {
+  void operator()(avifRGBConverter* converter) {
+    avifRGBConverterDestroy(converter);
+  }
+};
+using RGBConverterPtr =
+    std::unique_ptr<avifRGBConverter, RGBConverterDeleter>;
+
+// Converts several frames with a single avifRGBConverter and checks that the
+// results are identical to the ones of avifImageYUVToRGB().
+class RGBConverterTest
+    : public testing::TestWithParam<std::tuple<
+          /*yuv_depth=*/int, avifPixelFormat, avifRange,
+          /*rgb_depth=*/int, avifRGBFormat, avifChromaUpsampling,
+          /*avoid_libyuv=*/bool, /*max_threads=*/int>> {};
+
+TEST_P(RGBConverterTest, SameAsYUVToRGB) {
+  const int yuv_depth = std::get<0>(GetParam());
+  const avifPixelFormat yuv_format = std::get<1>(GetParam());
+  const avifRange yuv_range = std::get<2>(GetParam());
+  const int rgb_depth = std::get<3>(GetParam());
+  const avifRGBFormat rgb_format = std::get<4>(GetParam());
+  const avifChromaUpsampling upsampling = std::get<5>(GetParam());
+  const bool avoid_libyuv = std::get<6>(GetParam());
+  const int max_threads = std::get<7>(GetParam());
+
+  RGBConverterPtr converter;
+  // The dimensions may change from one frame to the next.
+  for (int frame = 0; frame < 3; ++frame) {
+    SCOPED_TRACE(frame);
+    ImagePtr image = testutil::CreateImage(
+        /*width=*/33 + frame, /*height=*/21 + 2 * frame, yuv_depth, yuv_format,
+        AVIF_PLANES_ALL, yuv_range);
+    ASSERT_NE(image, nullptr);
+    image->matrixCoefficients = AVIF_MATRIX_COEFFICIENTS_BT601;
+    testutil::FillImageGradient(image.get());
+
+    testutil::AvifRgbImage expected(image.get(), rgb_depth, rgb_format);
+    expected.chromaUpsampling = upsampling;
+    expected.avoidLibYUV = avoid_libyuv;
+    expected.maxThreads = max_threads;
+    testutil::AvifRgbImage rgb(image.get(), rgb_depth, rgb_format);
+    rgb.chromaUpsampling = upsampling;
+    rgb.avoidLibYUV = avoid_libyuv;
+    rgb.maxThreads = max_threads;
+
+    if (!converter) {
+      converter.reset(avifRGBConverterCreate(image.get(), &rgb));
+      ASSERT_NE(converter, nullptr);
+    }
+    ASSERT_EQ(avifImageYUVToRGB(image.get(), &expected), AVIF_RESULT_OK);
+    ASSERT_EQ(avifRGBConverterConvert(converter.get(), image.get(), &rgb),
+              AVIF_RESULT_OK);
+    EXPECT_TRUE(testutil::AreImagesEqual(expected, rgb));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    All, RGBConverterTest,
+    Combine(/*yuv_depth=*/Values(8, 10),
+            Values(AVIF_PIXEL_FORMAT_YUV444, AVIF_PIXEL_FORMAT_YUV420,
+                   AVIF_PIXEL_FORMAT_YUV400),
+            Values(AVIF_RANGE_FULL, AVIF_RANGE_LIMITED),
+            /*rgb_depth=*/Values(8, 16),
+            Values(AVIF_RGB_FORMAT_RGBA, AVIF_RGB_FORMAT_BGR),
+            Values(AVIF_CHROMA_UPSAMPLING_AUTOMATIC,
+                   AVIF_CHROMA_UPSAMPLING_NEAREST),
+            /*avoid_libyuv=*/Bool(), /*max_threads=*/Values(1, 4)));
+
+TEST(RGBConverterCreateTest, MismatchingImage) {
+  ImagePtr image = testutil::CreateImage(16, 16, 8, AVIF_PIXEL_FORMAT_YUV420,
+                                         AVIF_PLANES_YUV);
+  ASSERT_NE(image, nullptr);
+  image->matrixCoefficients = AVIF_MATRIX_COEFFICIENTS_BT601;
+  testutil::FillImageGradient(image.get());
+  testutil::AvifRgbImage rgb(image.get(), 8, AVIF_RGB_FORMAT_RGBA);
+  RGBConverterPtr converter(avifRGBConverterCreate(image.get(), &rgb));
+  ASSERT_NE(converter, nullptr);
+  ASSERT_EQ(avifRGBConverterConvert(converter.get(), image.get(), &rgb),
+            AVIF_RESULT_OK);
+
+  image->yuvRange = AVIF_RANGE_LIMITED;
+  EXPECT_EQ(avifRGBConverterConvert(converter.get(), image.get(), &rgb),
+            AVIF_RESULT_INVALID_ARGUMENT);
+  image->yuvRange = AVIF_RANGE_FULL;
+  image->matrixCoefficients = AVIF_MATRIX_COEFFICIENTS_BT2020_NCL;
+  EXPECT_EQ(avifRGBConverterConvert(converter.get(), image.get(), &rgb),
+            AVIF_RESULT_INVALID_ARGUMENT);
+  image->matrixCoefficients = AVIF_MATRIX_COEFFICIENTS_BT601;
+
+  rgb.format = AVIF_RGB_FORMAT_RGB;
+  EXPECT_EQ(avifRGBConverterConvert(converter.get(), image.get(), &rgb),
+            AVIF_RESULT_INVALID_ARGUMENT);
+}
+
+TEST(RGBConverterCreateTest, UnsupportedCombination) {
+  ImagePtr image = testutil::CreateImage(16, 16, 8, AVIF_PIXEL_FORMAT_YUV420,
+                                         AVIF_PLANES_YUV);
+  ASSERT_NE(image, nullptr);
+  avifRGBImage rgb;
+  avifRGBImageSetDefaults(&rgb, image.get());
+  rgb.depth = 7;
+  EXPECT_EQ(avifRGBConverterCreate(image.get(), &rgb), nullptr);
+}
+
+}  // namespace
+}  // namespace avif
@@ -1,7 +1,11 @@
 // Copyright 2023 Google LLC
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include <cstdint>
+#include <cstring>
+#include <random>
 #include <tuple>
+#include <vector>
 
 #include "avif/internal.h"
 #include "aviftest_helpers.h"
@@ -132,5 +136,95 @@ INSTANTIATE_TEST_SUITE_P(
                    AVIF_RGB_FORMAT_BGRA, AVIF_RGB_FORMAT_ABGR),
             /*is_float=*/Values(true)));
 
+// Checks that converting YUV to half float RGB gives the same result as
+// converting YUV to 16-bit RGB and then each value to a half float.
+TEST(YUVToRGBTest, FloatSameAsIntegerThenF16) {
+  // Large enough for avifImageYUVToRGB() to use a look-up table of half floats.
+  ImagePtr image = testutil::CreateImage(/*width=*/300, /*height=*/120,
+                                         /*depth=*/10, AVIF_PIXEL_FORMAT_YUV420,
+                                         AVIF_PLANES_ALL);
+  ASSERT_NE(image, nullptr);
+  testutil::FillImageGradient(image.get());
+
+  for (avifRGBFormat rgb_format : {AVIF_RGB_FORMAT_RGB, AVIF_RGB_FORMAT_ARGB,
+                                   AVIF_RGB_FORMAT_BGRA}) {
+    for (bool alpha_premultiplied : {false, true}) {
+      SCOPED_TRACE(testing::Message() << "rgb_format " << rgb_format
+                                      << " alpha_premultiplied "
+                                      << alpha_premultiplied);
+      // libyuv may convert to half floats differently.
+      testutil::AvifRgbImage integer(image.get(), 16, rgb_format);
+      integer.alphaPremultiplied = alpha_premultiplied;
+      integer.avoidLibYUV = AVIF_TRUE;
+      ASSERT_EQ(avifImageYUVToRGB(image.get(), &integer), AVIF_RESULT_OK);
+      testutil::AvifRgbImage half_float(image.get(), 16, rgb_format);
+      half_float.alphaPremultiplied = alpha_premultiplied;
+      half_float.avoidLibYUV = AVIF_TRUE;
+      half_float.isFloat = AVIF_TRUE;
+      ASSERT_EQ(avifImageYUVToRGB(image.get(), &half_float), AVIF_RESULT_OK);
+
+      const uint32_t count =
+          integer.width * avifRGBFormatChannelCount(rgb_format);
+      const float multiplier = 1.9259299444e-34f * (1.0f / 65535);
+      for (uint32_t y = 0; y < integer.height; ++y) {
+        const uint16_t* integer_row = reinterpret_cast<const uint16_t*>(
+            integer.pixels + y * integer.rowBytes);
+        const uint16_t* half_float_row = reinterpret_cast<const uint16_t*>(
+            half_float.pixels + y * half_float.rowBytes);
+        for (uint32_t x = 0; x < count; ++x) {
+          const float f = integer_row[x] * multiplier;
+          uint32_t bits;
+          std::memcpy(&bits, &f, sizeof(bits));
+          ASSERT_EQ(half_float_row[x], static_cast<uint16_t>(bits >> 13))
+              << x << "," << y;
+        }
+      }
+    }
+  }
+}
+
+// Checks that the SIMD implementation of the YUV to RGB row conversion, if any
+// is supported by the CPU, matches the portable C implementation.
+TEST(YUVToRGBRowTest, SimdMatchesC) {
+  const avifYUVToRGBRowFunc c_func = avifGetYUVToRGBRowFunc(AVIF_FALSE);
+  const avifYUVToRGBRowFunc simd_func = avifGetYUVToRGBRowFunc(AVIF_TRUE);
+  ASSERT_NE(c_func, nullptr);
+  ASSERT_NE(simd_func, nullptr);
+
+  // Odd count to exercise the scalar tail of the SIMD implementations.
+  constexpr uint32_t kCount = 1000 + 7;
+  std::mt19937 rng(0xAABBCCDD);
+  // Slightly outside of the valid ranges to exercise clamping.
+  std::uniform_real_distribution<float> y_dist(-0.1f, 1.1f);
+  std::uniform_real_distribution<float> c_dist(-0.6f, 0.6f);
+  std::vector<float> y(kCount), cb(kCount), cr(kCount);
+  for (uint32_t i = 0; i < kCount; ++i) {
+    y[i] = y_dist(rng);
+    cb[i] = c_dist(rng);
+    cr[i] = c_dist(rng);
+  }
+  // BT.601 and BT.2020 coefficients.
+  constexpr float kKrKb[][2] = {{0.299f, 0.114f}, {0.2627f, 0.0593f}};
+  for (const auto& coefficients : kKrKb) {
+    const float kr = coefficients[0];
+    const float kb = coefficients[1];
+    const float kg = 1.0f - kr - kb;
+    for (float rgb_max_channel : {255.0f, 1023.0f, 4095.0f, 65535.0f}) {
+      SCOPED_TRACE(rgb_max_channel);
+      const avifYUVToRGBRowParams params = {2 * (1 - kr),    2 * (1 - kb),
+                                            kr * (1 - kr),   kb * (1 - kb),
+                                            kg,              rgb_max_channel};
+      std::vector<uint16_t> c_rgb(kCount * 3), simd_rgb(kCount * 3);
+      c_func(y.data(), cb.data(), cr.data(), kCount, &params, &c_rgb[0],
+             &c_rgb[kCount], &c_rgb[kCount * 2]);
+      simd_func(y.data(), cb.data(), cr.data(), kCount, &params, &simd_rgb[0],
+                &simd_rgb[kCount], &simd_rgb[kCount * 2]);
+      for (uint32_t i = 0; i < kCount * 3; ++i) {
+        ASSERT_EQ(c_rgb[i], simd_rgb[i]) << i;
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace avif
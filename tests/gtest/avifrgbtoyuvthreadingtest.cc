@@ -17,6 +17,74 @@ using ::testing::Values;
 namespace avif {
 namespace {
 
+// Converts RGB pixels to YUV using one thread and multiple threads and checks
+// whether the results of both are identical.
+class RGBToYUVThreadingTest
+    : public testing::TestWithParam<std::tuple<
+          /*rgb_depth=*/int, /*yuv_depth=*/int,
+          /*width=*/int, /*height=*/int, avifRGBFormat, avifPixelFormat,
+          /*threads=*/int, /*avoidLibYUV=*/bool,
+          /*alpha_premultiplied=*/bool>> {};
+
+TEST_P(RGBToYUVThreadingTest, TestIdentical) {
+  const int rgb_depth = std::get<0>(GetParam());
+  const int yuv_depth = std::get<1>(GetParam());
+  const int width = std::get<2>(GetParam());
+  const int height = std::get<3>(GetParam());
+  const avifRGBFormat rgb_format = std::get<4>(GetParam());
+  const avifPixelFormat yuv_format = std::get<5>(GetParam());
+  const int maxThreads = std::get<6>(GetParam());
+  const bool avoidLibYUV = std::get<7>(GetParam());
+  const bool alpha_premultiplied = std::get<8>(GetParam());
+
+  // Fill RGB pixels with random values.
+  ImagePtr yuv(avifImageCreate(width, height, yuv_depth, yuv_format));
+  ASSERT_NE(yuv, nullptr);
+  yuv->matrixCoefficients = AVIF_MATRIX_COEFFICIENTS_BT601;
+  yuv->yuvRange = AVIF_RANGE_LIMITED;
+  testutil::AvifRgbImage rgb(yuv.get(), rgb_depth, rgb_format);
+  rgb.avoidLibYUV = avoidLibYUV;
+  rgb.alphaPremultiplied = alpha_premultiplied;
+  srand(0xAABBCCDD);
+  const int rgb_max = (1 << rgb_depth);
+  for (uint32_t y = 0; y < rgb.height; ++y) {
+    uint8_t* row = rgb.pixels + y * rgb.rowBytes;
+    const uint32_t channel_count = avifRGBFormatChannelCount(rgb.format);
+    for (uint32_t x = 0; x < rgb.width * channel_count; ++x) {
+      if (rgb_depth == 8) {
+        row[x] = (uint8_t)(rand() % rgb_max);
+      } else {
+        ((uint16_t*)row)[x] = (uint16_t)(rand() % rgb_max);
+      }
+    }
+  }
+
+  // Convert to YUV with 1 thread.
+  ASSERT_EQ(avifImageRGBToYUV(yuv.get(), &rgb), AVIF_RESULT_OK);
+
+  // Convert to YUV with multiple threads.
+  ImagePtr yuv_threaded(avifImageCreate(width, height, yuv_depth, yuv_format));
+  ASSERT_NE(yuv_threaded, nullptr);
+  yuv_threaded->matrixCoefficients = AVIF_MATRIX_COEFFICIENTS_BT601;
+  yuv_threaded->yuvRange = AVIF_RANGE_LIMITED;
+  rgb.maxThreads = maxThreads;
+  ASSERT_EQ(avifImageRGBToYUV(yuv_threaded.get(), &rgb), AVIF_RESULT_OK);
+
+  EXPECT_TRUE(testutil::AreImagesEqual(*yuv, *yuv_threaded));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    RGBToYUVThreadingTestInstance, RGBToYUVThreadingTest,
+    Combine(/*rgb_depth=*/Values(8, 16),
+            /*yuv_depth=*/Values(8, 10),
+            /*width=*/Values(1, 2, 127, 200),
+            /*height=*/Values(1, 2, 5, 127, 200),
+            Values(AVIF_RGB_FORMAT_RGB, AVIF_RGB_FORMAT_BGRA),
+            Range(AVIF_PIXEL_FORMAT_YUV444, AVIF_PIXEL_FORMAT_COUNT),
+            /*threads=*/Values(2, 7),
+            /*avoidLibYUV=*/Bool(),
+            /*alpha_premultiplied=*/Bool()));
+
 // Converts YUV pixels to RGB using one thread and multiple threads and checks
 // whether the results of both are identical.
 class YUVToRGBThreadingTest
@@ -102,6 +170,23 @@ INSTANTIATE_TEST_SUITE_P(
                    AVIF_CHROMA_UPSAMPLING_BILINEAR),
             /*has_alpha=*/Bool()));
 
+// Bilinear upsampling of 4:2:0 chroma reads across the borders between the
+// rows converted by each thread. Cover small heights so that these borders fall
+// on all kinds of rows.
+INSTANTIATE_TEST_SUITE_P(
+    YUV420BilinearThreadingTestInstance, YUVToRGBThreadingTest,
+    Combine(/*rgb_depth=*/Values(8, 16),
+            /*yuv_depth=*/Values(8, 10),
+            /*width=*/Values(3, 64),
+            /*height=*/Values(3, 4, 5, 6, 9, 30),
+            Values(AVIF_RGB_FORMAT_RGBA),
+            Values(AVIF_PIXEL_FORMAT_YUV420),
+            /*threads=*/Values(2, 3, 4, 8),
+            /*avoidLibYUV=*/Bool(),
+            Values(AVIF_CHROMA_UPSAMPLING_AUTOMATIC,
+                   AVIF_CHROMA_UPSAMPLING_BILINEAR),
+            /*has_alpha=*/Bool()));
+
 // This will generate a large number of test instances and hence it is disabled
 // by default. It can be run manually if necessary.
 INSTANTIATE_TEST_SUITE_P(
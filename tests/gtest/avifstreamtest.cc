@@ -177,6 +177,103 @@ TEST(StreamTest, WriteBitsLimit) {
             AVIF_RESULT_INVALID_ARGUMENT);
 }
 
+TEST(StreamTest, Reserve) {
+  testutil::AvifRwData rw_data;
+  avifRWStream rw_stream;
+  avifRWStreamStart(&rw_stream, &rw_data);
+  const uint8_t byte = 42;
+  ASSERT_EQ(avifRWStreamWrite(&rw_stream, &byte, 1), AVIF_RESULT_OK);
+
+  constexpr size_t kReservedSize = 100000;
+  ASSERT_EQ(avifRWStreamReserve(&rw_stream, kReservedSize), AVIF_RESULT_OK);
+  const uint8_t* const buffer = rw_data.data;
+  EXPECT_GE(rw_data.size, 1 + kReservedSize);
+  // No reallocation happens while writing the reserved bytes.
+  for (size_t i = 0; i < kReservedSize; ++i) {
+    ASSERT_EQ(avifRWStreamWrite(&rw_stream, &byte, 1), AVIF_RESULT_OK);
+  }
+  EXPECT_EQ(rw_data.data, buffer);
+  avifRWStreamFinishWrite(&rw_stream);
+  EXPECT_EQ(rw_data.size, 1 + kReservedSize);
+  EXPECT_TRUE(std::all_of(rw_data.data, rw_data.data + rw_data.size,
+                          [](uint8_t v) { return v == byte; }));
+}
+
+// avifRWDataRealloc() always allocates a new buffer, so each allocation changes
+// the data pointer.
+TEST(StreamTest, ReservedBufferIsTheOnlyAllocation) {
+  // Written sizes and reserved overestimates, as by avifEncoderFinish().
+  constexpr size_t kSizes[] = {1, 500, 5000, 1000000};
+  constexpr size_t kExtraReservedSizes[] = {0, 1, 2048, 60000};
+  for (size_t size : kSizes) {
+    for (size_t extra_reserved_size : kExtraReservedSizes) {
+      SCOPED_TRACE(size);
+      SCOPED_TRACE(extra_reserved_size);
+      testutil::AvifRwData rw_data;
+      avifRWStream rw_stream;
+      avifRWStreamStart(&rw_stream, &rw_data);
+      ASSERT_EQ(avifRWStreamReserve(&rw_stream, size + extra_reserved_size),
+                AVIF_RESULT_OK);
+      int num_allocations = 1;
+      const uint8_t* buffer = rw_data.data;
+      const uint8_t byte = 42;
+      for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(avifRWStreamWrite(&rw_stream, &byte, 1), AVIF_RESULT_OK);
+        if (rw_data.data != buffer) {
+          buffer = rw_data.data;
+          ++num_allocations;
+        }
+      }
+      avifRWStreamFinishWrite(&rw_stream);
+      if (rw_data.data != buffer) {
+        ++num_allocations;
+      }
+      EXPECT_EQ(num_allocations, 1);
+      EXPECT_EQ(rw_data.size, size);
+    }
+  }
+
+  // Large unused capacity is given back.
+  testutil::AvifRwData rw_data;
+  avifRWStream rw_stream;
+  avifRWStreamStart(&rw_stream, &rw_data);
+  ASSERT_EQ(avifRWStreamReserve(&rw_stream, 1 << 20), AVIF_RESULT_OK);
+  const uint8_t* const buffer = rw_data.data;
+  ASSERT_EQ(avifRWStreamWriteU32(&rw_stream, 42), AVIF_RESULT_OK);
+  avifRWStreamFinishWrite(&rw_stream);
+  EXPECT_NE(rw_data.data, buffer);
+  EXPECT_EQ(rw_data.size, sizeof(uint32_t));
+}
+
+TEST(StreamTest, GrowGeometrically) {
+  testutil::AvifRwData rw_data;
+  avifRWStream rw_stream;
+  avifRWStreamStart(&rw_stream, &rw_data);
+  int num_reallocations = 0;
+  const uint8_t* buffer = nullptr;
+  constexpr uint32_t kNumWrites = 1 << 20;
+  for (uint32_t i = 0; i < kNumWrites; ++i) {
+    ASSERT_EQ(avifRWStreamWriteU32(&rw_stream, i), AVIF_RESULT_OK);
+    if (rw_data.data != buffer) {
+      buffer = rw_data.data;
+      ++num_reallocations;
+    }
+  }
+  // 4 MB written in at most log2(4 MB / 1 kB) + 1 allocations.
+  EXPECT_LE(num_reallocations, 13);
+  avifRWStreamFinishWrite(&rw_stream);
+  ASSERT_EQ(rw_data.size, kNumWrites * sizeof(uint32_t));
+
+  avifROStream ro_stream;
+  avifROData ro_data = {rw_data.data, rw_data.size};
+  avifROStreamStart(&ro_stream, &ro_data, nullptr, nullptr);
+  for (uint32_t i = 0; i < kNumWrites; ++i) {
+    uint32_t v;
+    ASSERT_TRUE(avifROStreamReadU32(&ro_stream, &v));
+    ASSERT_EQ(v, i);
+  }
+}
+
 //------------------------------------------------------------------------------
 
 }  // namespace
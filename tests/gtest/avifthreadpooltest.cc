@@ -0,0 +1,96 @@
+// Copyright 2024 Google LLC
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <thread>
+#include <vector>
+
+#include "avif/avif.h"
+#include "aviftest_helpers.h"
+#include "gtest/gtest.h"
+
+namespace avif {
+namespace {
+
+TEST(ThreadPoolTest, InvalidThreadCount) {
+  EXPECT_EQ(avifThreadPoolCreate(0), nullptr);
+  EXPECT_EQ(avifThreadPoolCreate(-1), nullptr);
+}
+
+TEST(ThreadPoolTest, ThreadCount) {
+  for (int thread_count : {1, 2, 7}) {
+    ThreadPoolPtr pool(avifThreadPoolCreate(thread_count));
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(avifThreadPoolGetThreadCount(pool.get()), thread_count);
+  }
+}
+
+// Converts YUV pixels to RGB without and with a thread pool and checks that
+// the results are identical.
+TEST(ThreadPoolTest, YUVToRGBMatchesWithoutPool) {
+  ThreadPoolPtr pool(avifThreadPoolCreate(3));
+  ASSERT_NE(pool, nullptr);
+  for (avifPixelFormat yuv_format :
+       {AVIF_PIXEL_FORMAT_YUV444, AVIF_PIXEL_FORMAT_YUV422,
+        AVIF_PIXEL_FORMAT_YUV420}) {
+    for (int max_threads : {1, 2, 8, 64}) {
+      SCOPED_TRACE(max_threads);
+      ImagePtr yuv = testutil::CreateImage(/*width=*/123, /*height=*/77,
+                                           /*depth=*/8, yuv_format,
+                                           AVIF_PLANES_ALL);
+      ASSERT_NE(yuv, nullptr);
+      testutil::FillImageGradient(yuv.get());
+
+      testutil::AvifRgbImage rgb(yuv.get(), 8, AVIF_RGB_FORMAT_RGBA);
+      rgb.chromaUpsampling = AVIF_CHROMA_UPSAMPLING_FASTEST;
+      rgb.avoidLibYUV = AVIF_TRUE;
+      ASSERT_EQ(avifImageYUVToRGB(yuv.get(), &rgb), AVIF_RESULT_OK);
+
+      testutil::AvifRgbImage rgb_pooled(yuv.get(), 8, AVIF_RGB_FORMAT_RGBA);
+      rgb_pooled.chromaUpsampling = AVIF_CHROMA_UPSAMPLING_FASTEST;
+      rgb_pooled.avoidLibYUV = AVIF_TRUE;
+      rgb_pooled.maxThreads = max_threads;
+      rgb_pooled.threadPool = pool.get();
+      ASSERT_EQ(avifImageYUVToRGB(yuv.get(), &rgb_pooled), AVIF_RESULT_OK);
+
+      EXPECT_TRUE(testutil::AreImagesEqual(rgb, rgb_pooled));
+    }
+  }
+}
+
+// Shares one pool between several threads converting images concurrently.
+TEST(ThreadPoolTest, SharedBetweenThreads) {
+  ThreadPoolPtr pool(avifThreadPoolCreate(2));
+  ASSERT_NE(pool, nullptr);
+  ImagePtr yuv = testutil::CreateImage(/*width=*/64, /*height=*/200,
+                                       /*depth=*/10, AVIF_PIXEL_FORMAT_YUV444,
+                                       AVIF_PLANES_ALL);
+  ASSERT_NE(yuv, nullptr);
+  testutil::FillImageGradient(yuv.get());
+  testutil::AvifRgbImage reference(yuv.get(), 8, AVIF_RGB_FORMAT_BGRA);
+  ASSERT_EQ(avifImageYUVToRGB(yuv.get(), &reference), AVIF_RESULT_OK);
+
+  constexpr int kNumThreads = 4;
+  std::vector<int> equal(kNumThreads, 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int iteration = 0; iteration < 10; ++iteration) {
+        testutil::AvifRgbImage rgb(yuv.get(), 8, AVIF_RGB_FORMAT_BGRA);
+        rgb.maxThreads = 4;
+        rgb.threadPool = pool.get();
+        if (avifImageYUVToRGB(yuv.get(), &rgb) != AVIF_RESULT_OK ||
+            !testutil::AreImagesEqual(reference, rgb)) {
+          return;
+        }
+      }
+      equal[i] = 1;
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_TRUE(equal[i]) << i;
+  }
+}
+
+}  // namespace
+}  // namespace avif
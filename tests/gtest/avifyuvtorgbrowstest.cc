@@ -0,0 +1,133 @@
+// Copyright 2024 Google LLC
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+#include "avif/avif.h"
+#include "aviftest_helpers.h"
+#include "gtest/gtest.h"
+
+using ::testing::Bool;
+using ::testing::Combine;
+using ::testing::Values;
+
+namespace avif {
+namespace {
+
+// Converts an image stripe by stripe with avifImageYUVToRGBRows() and checks
+// that the result is identical to the one of avifImageYUVToRGB().
+class YUVToRGBRowsTest
+    : public testing::TestWithParam<std::tuple<
+          /*yuv_depth=*/int, avifPixelFormat, /*rgb_depth=*/int, avifRGBFormat,
+          avifChromaUpsampling, /*avoid_libyuv=*/bool,
+          /*premultiply=*/bool, /*stripe_height=*/int>> {};
+
+TEST_P(YUVToRGBRowsTest, SameAsYUVToRGB) {
+  const int yuv_depth = std::get<0>(GetParam());
+  const avifPixelFormat yuv_format = std::get<1>(GetParam());
+  const int rgb_depth = std::get<2>(GetParam());
+  const avifRGBFormat rgb_format = std::get<3>(GetParam());
+  const avifChromaUpsampling upsampling = std::get<4>(GetParam());
+  const bool avoid_libyuv = std::get<5>(GetParam());
+  const bool premultiply = std::get<6>(GetParam());
+  const uint32_t stripe_height = std::get<7>(GetParam());
+
+  // Odd dimensions to exercise the last subsampled chroma row and column.
+  ImagePtr image = testutil::CreateImage(/*width=*/35, /*height=*/23,
+                                         yuv_depth, yuv_format,
+                                         AVIF_PLANES_ALL, AVIF_RANGE_LIMITED);
+  ASSERT_NE(image, nullptr);
+  image->matrixCoefficients = AVIF_MATRIX_COEFFICIENTS_BT601;
+  testutil::FillImageGradient(image.get());
+
+  testutil::AvifRgbImage expected(image.get(), rgb_depth, rgb_format);
+  expected.chromaUpsampling = upsampling;
+  expected.avoidLibYUV = avoid_libyuv;
+  expected.alphaPremultiplied = premultiply;
+  ASSERT_EQ(avifImageYUVToRGB(image.get(), &expected), AVIF_RESULT_OK);
+
+  for (uint32_t start_row = 0; start_row < image->height;
+       start_row += stripe_height) {
+    SCOPED_TRACE(start_row);
+    const uint32_t row_count =
+        std::min(stripe_height, image->height - start_row);
+    testutil::AvifRgbImage stripe(image.get(), rgb_depth, rgb_format);
+    avifRGBImageFreePixels(&stripe);
+    stripe.height = row_count;
+    stripe.chromaUpsampling = upsampling;
+    stripe.avoidLibYUV = avoid_libyuv;
+    stripe.alphaPremultiplied = premultiply;
+    ASSERT_EQ(avifRGBImageAllocatePixels(&stripe), AVIF_RESULT_OK);
+    ASSERT_EQ(
+        avifImageYUVToRGBRows(image.get(), &stripe, start_row, row_count),
+        AVIF_RESULT_OK);
+
+    for (uint32_t y = 0; y < row_count; ++y) {
+      EXPECT_EQ(std::memcmp(
+                    stripe.pixels + y * stripe.rowBytes,
+                    expected.pixels + (start_row + y) * expected.rowBytes,
+                    expected.width * avifRGBImagePixelSize(&expected)),
+                0)
+          << "row " << (start_row + y);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    All, YUVToRGBRowsTest,
+    Combine(/*yuv_depth=*/Values(8, 10),
+            Values(AVIF_PIXEL_FORMAT_YUV444, AVIF_PIXEL_FORMAT_YUV422,
+                   AVIF_PIXEL_FORMAT_YUV420, AVIF_PIXEL_FORMAT_YUV400),
+            /*rgb_depth=*/Values(8, 16),
+            Values(AVIF_RGB_FORMAT_RGBA, AVIF_RGB_FORMAT_BGR),
+            Values(AVIF_CHROMA_UPSAMPLING_BILINEAR,
+                   AVIF_CHROMA_UPSAMPLING_NEAREST),
+            /*avoid_libyuv=*/Bool(), /*premultiply=*/Bool(),
+            /*stripe_height=*/Values(1, 2, 3, 7)));
+
+TEST(YUVToRGBRowsTest, Float) {
+  ImagePtr image = testutil::CreateImage(/*width=*/17, /*height=*/11,
+                                         /*depth=*/10, AVIF_PIXEL_FORMAT_YUV420,
+                                         AVIF_PLANES_ALL);
+  ASSERT_NE(image, nullptr);
+  testutil::FillImageGradient(image.get());
+  testutil::AvifRgbImage expected(image.get(), /*rgb_depth=*/16,
+                                  AVIF_RGB_FORMAT_RGBA);
+  expected.isFloat = AVIF_TRUE;
+  ASSERT_EQ(avifImageYUVToRGB(image.get(), &expected), AVIF_RESULT_OK);
+
+  for (uint32_t y = 0; y < image->height; ++y) {
+    testutil::AvifRgbImage row(image.get(), /*rgb_depth=*/16,
+                               AVIF_RGB_FORMAT_RGBA);
+    row.isFloat = AVIF_TRUE;
+    row.height = 1;
+    ASSERT_EQ(avifImageYUVToRGBRows(image.get(), &row, y, 1), AVIF_RESULT_OK);
+    EXPECT_EQ(std::memcmp(row.pixels, expected.pixels + y * expected.rowBytes,
+                          row.width * avifRGBImagePixelSize(&row)),
+              0)
+        << "row " << y;
+  }
+}
+
+TEST(YUVToRGBRowsTest, InvalidStripe) {
+  ImagePtr image = testutil::CreateImage(16, 16, 8, AVIF_PIXEL_FORMAT_YUV420,
+                                         AVIF_PLANES_YUV);
+  ASSERT_NE(image, nullptr);
+  testutil::FillImageGradient(image.get());
+  testutil::AvifRgbImage rgb(image.get(), 8, AVIF_RGB_FORMAT_RGBA);
+  rgb.height = 4;
+  EXPECT_EQ(avifImageYUVToRGBRows(image.get(), &rgb, 0, 4), AVIF_RESULT_OK);
+  EXPECT_EQ(avifImageYUVToRGBRows(image.get(), &rgb, 12, 4), AVIF_RESULT_OK);
+  EXPECT_EQ(avifImageYUVToRGBRows(image.get(), &rgb, 13, 4),
+            AVIF_RESULT_INVALID_ARGUMENT);
+  EXPECT_EQ(avifImageYUVToRGBRows(image.get(), &rgb, 0, 3),
+            AVIF_RESULT_INVALID_ARGUMENT);
+  rgb.height = 0;
+  EXPECT_EQ(avifImageYUVToRGBRows(image.get(), &rgb, 0, 0),
+            AVIF_RESULT_INVALID_ARGUMENT);
+}
+
+}  // namespace
+}  // namespace avif